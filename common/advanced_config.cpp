@@ -139,6 +139,16 @@ static const wxChar MinPlotPenWidth[] = wxT( "MinPlotPenWidth" );
 
 static const wxChar DebugZoneFiller[] = wxT( "DebugZoneFiller" );
 
+static const wxChar IncrementalZoneFill[] = wxT( "IncrementalZoneFill" );
+
+static const wxChar ZoneFillTileSize[] = wxT( "ZoneFillTileSize" );
+
+static const wxChar ZoneFillCacheFile[] = wxT( "ZoneFillCacheFile" );
+
+static const wxChar OnlineDRC[] = wxT( "OnlineDRC" );
+
+static const wxChar CompileRuleConditions[] = wxT( "CompileRuleConditions" );
+
 static const wxChar DebugPDFWriter[] = wxT( "DebugPDFWriter" );
 
 static const wxChar SkipBoundingBoxFpLoad[] = wxT( "SkipBoundingBoxFpLoad" );
@@ -239,6 +249,11 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_MinPlotPenWidth           = 0.0212;   // 1 pixel at 1200dpi.
 
     m_DebugZoneFiller           = false;
+    m_IncrementalZoneFill       = false;
+    m_ZoneFillTileSize          = 0.0;
+    m_ZoneFillCacheFile         = false;
+    m_OnlineDRC                 = false;
+    m_CompileRuleConditions     = false;
     m_DebugPDFWriter            = false;
 
     m_SkipBoundingBoxOnFpLoad   = false;
@@ -320,6 +335,21 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DebugZoneFiller,
                                                 &m_DebugZoneFiller, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalZoneFill,
+                                                &m_IncrementalZoneFill, false ) );
+
+    configParams.push_back( new PARAM_CFG_DOUBLE( true, AC_KEYS::ZoneFillTileSize,
+                                                  &m_ZoneFillTileSize, 0.0, 0.0, 10000.0 ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillCacheFile,
+                                                &m_ZoneFillCacheFile, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::OnlineDRC,
+                                                &m_OnlineDRC, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::CompileRuleConditions,
+                                                &m_CompileRuleConditions, false ) );
+
     configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::DebugPDFWriter,
                                                 &m_DebugPDFWriter, false ) );
 
@@ -712,11 +712,12 @@ void TREE_NODE::SetUop( int aOp, std::unique_ptr<VAR_REF> aRef )
 }
 
 
-void TREE_NODE::SetUop( int aOp, FUNC_CALL_REF aFunc, std::unique_ptr<VAR_REF> aRef )
+void TREE_NODE::SetUop( int aOp, FUNC_CALL_REF aFunc, std::unique_ptr<VAR_REF> aRef,
+                        int aArgCount )
 {
     delete uop;
 
-    uop = new UOP( aOp, std::move( aFunc ), std::move( aRef ) );
+    uop = new UOP( aOp, std::move( aFunc ), std::move( aRef ), aArgCount );
 }
 
 
@@ -931,7 +932,8 @@ bool COMPILER::generateUCode( UCODE* aCode, CONTEXT* aPreflightContext )
                     for( TREE_NODE* pnode : params )
                         stack.push_back( pnode );
 
-                    node->leaf[1]->SetUop( TR_OP_METHOD_CALL, func, std::move( vref ) );
+                    node->leaf[1]->SetUop( TR_OP_METHOD_CALL, func, std::move( vref ),
+                                           (int) params.size() );
                     node->isTerminal = false;
                     break;
                 }
@@ -1162,10 +1164,284 @@ void UOP::Exec( CONTEXT* ctx )
 }
 
 
+static double valueAsDouble( const VALUE* aValue )
+{
+    return aValue ? aValue->AsDouble() : 0.0;
+}
+
+
+template <typename FUNC>
+static CLOSURE lowerBinaryOp( const CLOSURE& aArg1, const CLOSURE& aArg2, FUNC aFunc )
+{
+    return [aArg1, aArg2, aFunc]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+           {
+               VALUE  scratch1;
+               VALUE  scratch2;
+               VALUE* arg1 = aArg1( aCtx, &scratch1 );
+               VALUE* arg2 = aArg2( aCtx, &scratch2 );
+
+               aScratch->Set( aFunc( arg1, arg2 ) );
+               return aScratch;
+           };
+}
+
+
+bool UOP::Lower( std::vector<CLOSURE>& aStack )
+{
+    switch( m_op )
+    {
+    case TR_UOP_PUSH_VAR:
+    {
+        VAR_REF* ref = m_ref.get();
+
+        aStack.push_back(
+                [ref]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                {
+                    aScratch->Set( ref->GetValue( aCtx ) );
+                    return aScratch;
+                } );
+        return true;
+    }
+
+    case TR_UOP_PUSH_VALUE:
+    {
+        VALUE* value = m_value.get();
+
+        aStack.push_back(
+                [value]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                {
+                    return value;
+                } );
+        return true;
+    }
+
+    case TR_OP_METHOD_CALL:
+    {
+        if( (int) aStack.size() < m_argCount )
+            return false;
+
+        std::vector<CLOSURE> args( aStack.end() - m_argCount, aStack.end() );
+        aStack.resize( aStack.size() - m_argCount );
+
+        // Functions take their parameters from, and leave their result on, the context stack
+        aStack.push_back(
+                [this, args]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                {
+                    for( const CLOSURE& arg : args )
+                    {
+                        VALUE  scratch;
+                        VALUE* value = arg( aCtx, &scratch );
+
+                        if( value == &scratch )
+                        {
+                            value = aCtx->AllocValue();
+                            value->Set( scratch );
+                        }
+
+                        aCtx->Push( value );
+                    }
+
+                    m_func( aCtx, m_ref.get() );
+                    return aCtx->Pop();
+                } );
+        return true;
+    }
+
+    default:
+        break;
+    }
+
+    if( m_op & TR_OP_BINARY_MASK )
+    {
+        if( aStack.size() < 2 )
+            return false;
+
+        CLOSURE arg2 = std::move( aStack.back() );
+        aStack.pop_back();
+        CLOSURE arg1 = std::move( aStack.back() );
+        aStack.pop_back();
+
+        switch( m_op )
+        {
+        case TR_OP_ADD:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) + valueAsDouble( b );
+                    } ) );
+            break;
+        case TR_OP_SUB:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) - valueAsDouble( b );
+                    } ) );
+            break;
+        case TR_OP_MUL:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) * valueAsDouble( b );
+                    } ) );
+            break;
+        case TR_OP_DIV:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) / valueAsDouble( b );
+                    } ) );
+            break;
+        case TR_OP_LESS_EQUAL:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) <= valueAsDouble( b ) ? 1.0 : 0.0;
+                    } ) );
+            break;
+        case TR_OP_GREATER_EQUAL:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) >= valueAsDouble( b ) ? 1.0 : 0.0;
+                    } ) );
+            break;
+        case TR_OP_LESS:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) < valueAsDouble( b ) ? 1.0 : 0.0;
+                    } ) );
+            break;
+        case TR_OP_GREATER:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return valueAsDouble( a ) > valueAsDouble( b ) ? 1.0 : 0.0;
+                    } ) );
+            break;
+        case TR_OP_EQUAL:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return a && b && a->EqualTo( b ) ? 1.0 : 0.0;
+                    } ) );
+            break;
+        case TR_OP_NOT_EQUAL:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return a && b && a->EqualTo( b ) ? 0.0 : 1.0;
+                    } ) );
+            break;
+        case TR_OP_BOOL_AND:
+            aStack.push_back(
+                    [arg1, arg2]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                    {
+                        VALUE scratch;
+                        bool  result = valueAsDouble( arg1( aCtx, &scratch ) ) != 0.0
+                                        && valueAsDouble( arg2( aCtx, &scratch ) ) != 0.0;
+
+                        aScratch->Set( result ? 1.0 : 0.0 );
+                        return aScratch;
+                    } );
+            break;
+        case TR_OP_BOOL_OR:
+            aStack.push_back(
+                    [arg1, arg2]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                    {
+                        VALUE scratch;
+                        bool  result = valueAsDouble( arg1( aCtx, &scratch ) ) != 0.0
+                                        || valueAsDouble( arg2( aCtx, &scratch ) ) != 0.0;
+
+                        aScratch->Set( result ? 1.0 : 0.0 );
+                        return aScratch;
+                    } );
+            break;
+        default:
+            aStack.push_back( lowerBinaryOp( arg1, arg2,
+                    []( const VALUE* a, const VALUE* b )
+                    {
+                        return 0.0;
+                    } ) );
+            break;
+        }
+
+        return true;
+    }
+    else if( m_op & TR_OP_UNARY_MASK )
+    {
+        if( aStack.empty() )
+            return false;
+
+        CLOSURE arg1 = std::move( aStack.back() );
+        aStack.pop_back();
+
+        bool isNot = m_op == TR_OP_BOOL_NOT;
+
+        aStack.push_back(
+                [arg1, isNot]( CONTEXT* aCtx, VALUE* aScratch ) -> VALUE*
+                {
+                    VALUE  scratch;
+                    double arg1Value = valueAsDouble( arg1( aCtx, &scratch ) );
+
+                    aScratch->Set( isNot && arg1Value == 0.0 ? 1.0 : 0.0 );
+                    return aScratch;
+                } );
+        return true;
+    }
+
+    // Anything else leaves the stack as it is, as in Exec()
+    return true;
+}
+
+
+bool UCODE::Lower()
+{
+    std::vector<CLOSURE> stack;
+
+    m_closure = nullptr;
+
+    for( UOP* op : m_ucode )
+    {
+        if( !op->Lower( stack ) )
+            return false;
+    }
+
+    if( stack.size() != 1 )
+        return false;
+
+    m_closure = std::move( stack.back() );
+    return true;
+}
+
+
 VALUE* UCODE::Run( CONTEXT* ctx )
 {
     static VALUE g_false( 0 );
 
+    if( m_closure )
+    {
+        try
+        {
+            VALUE  scratch;
+            VALUE* result = m_closure( ctx, &scratch );
+
+            // The result must outlive this call
+            if( result == &scratch )
+            {
+                result = ctx->AllocValue();
+                result->Set( scratch );
+            }
+
+            return result;
+        }
+        catch(...)
+        {
+            // rules which fail outright should not be fired
+            return &g_false;
+        }
+    }
+
     try
     {
         for( UOP* op : m_ucode )
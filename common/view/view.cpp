@@ -275,6 +275,7 @@ VIEW::VIEW( bool aIsDynamic ) :
     m_dynamic( aIsDynamic ),
     m_useDrawPriority( false ),
     m_nextDrawPriority( 0 ),
+    m_bulkAdding( false ),
     m_reverseDrawOrder( false )
 {
     // Set m_boundary to define the max area size. The default area size
@@ -345,7 +346,10 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
     for( int i = 0; i < layers_count; ++i )
     {
         VIEW_LAYER& l = m_layers[layers[i]];
-        l.items->Insert( aItem );
+
+        if( !m_bulkAdding )
+            l.items->Insert( aItem );
+
         MarkTargetDirty( l.target );
     }
 
@@ -354,6 +358,40 @@ void VIEW::Add( VIEW_ITEM* aItem, int aDrawPriority )
 }
 
 
+void VIEW::BeginBulkAdd()
+{
+    m_bulkAdding = true;
+}
+
+
+void VIEW::EndBulkAdd()
+{
+    if( !m_bulkAdding )
+        return;
+
+    m_bulkAdding = false;
+
+    // Rebuild every layer from the layers saved for each item, which also covers the items
+    // indexed normally (eg. by a layer change) while the bulk add was in progress
+    std::vector<std::vector<VIEW_ITEM*>> layerItems( m_layers.size() );
+    int layers[VIEW_MAX_LAYERS], layers_count;
+
+    for( VIEW_ITEM* item : *m_allItems )
+    {
+        item->viewPrivData()->getLayers( layers, layers_count );
+
+        for( int i = 0; i < layers_count; ++i )
+            layerItems[layers[i]].push_back( item );
+    }
+
+    for( VIEW_LAYER& l : m_layers )
+    {
+        l.items->BulkLoad( layerItems[l.id] );
+        MarkTargetDirty( l.target );
+    }
+}
+
+
 void VIEW::Remove( VIEW_ITEM* aItem )
 {
     if( !aItem )
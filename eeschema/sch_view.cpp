@@ -94,9 +94,13 @@ void SCH_VIEW::ResizeSheetWorkingArea( SCH_SCREEN* aScreen )
 
 void SCH_VIEW::DisplaySheet( SCH_SCREEN *aScreen )
 {
+    BeginBulkAdd();
+
     for( auto item : aScreen->Items() )
         Add( item );
 
+    EndBulkAdd();
+
     m_worksheet.reset( new KIGFX::WS_PROXY_VIEW_ITEM( static_cast< int >( IU_PER_MILS ),
                                                       &aScreen->GetPageSettings(),
                                                       &aScreen->Schematic()->Prj(),
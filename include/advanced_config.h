@@ -142,6 +142,36 @@ public:
      */
     bool m_DebugZoneFiller;
 
+    /**
+     * When true, refilling all zones only recomputes the zones and layers touched by copper
+     * changes made since the last fill.
+     */
+    bool m_IncrementalZoneFill;
+
+    /**
+     * When non-zero, copper zones larger than this are split into tiles of this size which
+     * are filled concurrently and then stitched together.  Units are mm.
+     */
+    double m_ZoneFillTileSize;
+
+    /**
+     * Save zone fills to a binary .kicad_fills file next to the board instead of writing
+     * them inline, and read them back from there when loading.
+     */
+    bool m_ZoneFillCacheFile;
+
+    /**
+     * Re-run the DRC tests which can be limited to the changed items after each edit of the
+     * board, and update their markers.
+     */
+    bool m_OnlineDRC;
+
+    /**
+     * Evaluate DRC rule conditions with native closures built from the compiled expressions
+     * rather than with the expression stack machine.
+     */
+    bool m_CompileRuleConditions;
+
     /**
      * A mode that writes PDF's without compression.
      */
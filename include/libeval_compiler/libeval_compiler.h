@@ -21,11 +21,12 @@
 #ifndef __LIBEVAL_COMPILER_H
 #define __LIBEVAL_COMPILER_H
 
+#include <array>
 #include <cstddef>
 #include <functional>
 #include <map>
 #include <string>
-#include <stack>
+#include <vector>
 
 #include <base_units.h>
 #include <wx/intl.h>
@@ -103,10 +104,17 @@ enum TOKEN_TYPE_T
 class UOP;
 class UCODE;
 class CONTEXT;
+class VALUE;
 class VAR_REF;
 
 typedef std::function<void( CONTEXT*, void* )> FUNC_CALL_REF;
 
+/**
+ * A compiled expression lowered to native code.  Returns a pointer to its result, which is
+ * either a constant owned by the UCODE, \a aScratch, or a value owned by the context.
+ */
+typedef std::function<VALUE*( CONTEXT* aCtx, VALUE* aScratch )> CLOSURE;
+
 struct T_TOKEN_VALUE
 {
     wxString* str;
@@ -144,7 +152,8 @@ public:
     void SetUop( int aOp, double aValue );
     void SetUop( int aOp, const wxString& aValue, bool aStringIsWildcard );
     void SetUop( int aOp, std::unique_ptr<VAR_REF> aRef = nullptr );
-    void SetUop( int aOp, FUNC_CALL_REF aFunc, std::unique_ptr<VAR_REF> aRef = nullptr );
+    void SetUop( int aOp, FUNC_CALL_REF aFunc, std::unique_ptr<VAR_REF> aRef = nullptr,
+                 int aArgCount = 0 );
 };
 
 
@@ -262,6 +271,12 @@ public:
 class CONTEXT
 {
 public:
+    CONTEXT() :
+        m_nextValue( 0 )
+    {
+        m_stack.reserve( 16 );
+    }
+
     virtual ~CONTEXT()
     {
         for( VALUE* value : m_ownedValues )
@@ -270,6 +285,14 @@ public:
 
     VALUE* AllocValue()
     {
+        // Values come from the arena until it runs out
+        if( m_nextValue < m_arena.size() )
+        {
+            VALUE* value = &m_arena[ m_nextValue++ ];
+            *value = VALUE();
+            return value;
+        }
+
         VALUE* value = new VALUE();
         m_ownedValues.push_back( value );
         return value;
@@ -277,7 +300,7 @@ public:
 
     void Push( VALUE* v )
     {
-        m_stack.push( v );
+        m_stack.push_back( v );
     }
 
     VALUE* Pop()
@@ -288,8 +311,8 @@ public:
             return AllocValue();
         }
 
-        VALUE* value = m_stack.top();
-        m_stack.pop();
+        VALUE* value = m_stack.back();
+        m_stack.pop_back();
         return value;
     }
 
@@ -298,6 +321,22 @@ public:
         return m_stack.size();
     };
 
+    /**
+     * Release all the values and clear the stack and any pending error, so that the context
+     * can be reused to run another expression.  Values returned by earlier runs are invalid
+     * afterwards.
+     */
+    void Reset()
+    {
+        for( VALUE* value : m_ownedValues )
+            delete value;
+
+        m_ownedValues.clear();
+        m_nextValue = 0;
+        m_stack.clear();
+        m_errorStatus = ERROR_STATUS();
+    }
+
     void SetErrorCallback( std::function<void( const wxString& aMessage, int aOffset )> aCallback )
     {
         m_errorCallback = std::move( aCallback );
@@ -308,9 +347,11 @@ public:
     const ERROR_STATUS& GetError() const { return m_errorStatus; }
 
 private:
-    std::vector<VALUE*> m_ownedValues;
-    std::stack<VALUE*>  m_stack;
-    ERROR_STATUS        m_errorStatus;
+    std::array<VALUE, 32> m_arena;
+    size_t                m_nextValue;
+    std::vector<VALUE*>   m_ownedValues;    // Values allocated once the arena ran out
+    std::vector<VALUE*>   m_stack;
+    ERROR_STATUS          m_errorStatus;
 
     std::function<void( const wxString& aMessage, int aOffset )> m_errorCallback;
 };
@@ -324,11 +365,23 @@ public:
     void AddOp( UOP* uop )
     {
         m_ucode.push_back(uop);
+        m_closure = nullptr;
     }
 
     VALUE* Run( CONTEXT* ctx );
     wxString Dump() const;
 
+    /**
+     * Lower the compiled micro-ops into a tree of closures which Run() evaluates instead of
+     * interpreting the ops.  Intermediate values are kept on the native stack, and boolean
+     * operators skip their right-hand operand when the left-hand one decides the result.
+     *
+     * @return false if the ops don't form a well-formed expression, in which case Run()
+     *         keeps interpreting them.
+     */
+    bool Lower();
+    bool IsLowered() const { return (bool) m_closure; }
+
     virtual std::unique_ptr<VAR_REF> CreateVarRef( const wxString& var, const wxString& field )
     {
         return nullptr;
@@ -342,6 +395,7 @@ public:
 protected:
 
     std::vector<UOP*> m_ucode;
+    CLOSURE           m_closure;
 };
 
 
@@ -360,11 +414,13 @@ public:
         m_value(nullptr)
     {};
 
-    UOP( int op, FUNC_CALL_REF func, std::unique_ptr<VAR_REF> vref = nullptr ) :
+    UOP( int op, FUNC_CALL_REF func, std::unique_ptr<VAR_REF> vref = nullptr,
+         int argCount = 0 ) :
         m_op( op ),
         m_func( std::move( func ) ),
         m_ref( std::move( vref ) ),
-        m_value(nullptr)
+        m_value(nullptr),
+        m_argCount( argCount )
     {};
 
     ~UOP()
@@ -373,6 +429,11 @@ public:
 
     void Exec( CONTEXT* ctx );
 
+    /**
+     * Replace the operands of this op on \a aStack with a closure computing its result.
+     */
+    bool Lower( std::vector<CLOSURE>& aStack );
+
     wxString Format() const;
 
 private:
@@ -381,6 +442,7 @@ private:
     FUNC_CALL_REF            m_func;
     std::unique_ptr<VAR_REF> m_ref;
     std::unique_ptr<VALUE>   m_value;
+    int                      m_argCount = 0;    // Parameters taken by a method call
 };
 
 class TOKENIZER
@@ -90,6 +90,20 @@ public:
      */
     virtual void Add( VIEW_ITEM* aItem, int aDrawPriority = -1 );
 
+    /**
+     * Function BeginBulkAdd()
+     * Defers the spatial indexing of the items added until EndBulkAdd(), which then packs
+     * the index of every layer in one pass.  Meant for loading a complete document: items
+     * added in between are not found by queries until EndBulkAdd() is called.
+     */
+    void BeginBulkAdd();
+
+    /**
+     * Function EndBulkAdd()
+     * Indexes the items added since BeginBulkAdd().
+     */
+    void EndBulkAdd();
+
     /**
      * Function Remove()
      * Removes a VIEW_ITEM from the view.
@@ -853,6 +867,9 @@ protected:
     /// The next sequential drawing priority
     int m_nextDrawPriority;
 
+    /// Flag to defer indexing added items until EndBulkAdd()
+    bool m_bulkAdding;
+
     /// Flag to reverse the draw order when using draw priority
     bool m_reverseDrawOrder;
 
@@ -0,0 +1,220 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file seg_distance_kernels.h
+ * @brief batch kernels measuring the distance from a point or segment to a run of segments.
+ *
+ * The kernels work in double precision, using AVX or SSE2 instructions when the build
+ * targets them, and are only accurate to within a couple of units.  They are used to skip
+ * segments which can't be nearer than the best found so far; the remaining candidates are
+ * then measured exactly with SEG, so results match a plain loop over SEG::SquaredDistance().
+ */
+
+#ifndef SEG_DISTANCE_KERNELS_H
+#define SEG_DISTANCE_KERNELS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <geometry/seg.h>
+#include <geometry/segment_bvh.h>
+#include <geometry/shape.h>
+
+/// Number of distances SegKernelForEachCandidate() keeps on the stack
+static constexpr int SEG_KERNEL_BLOCK = 64;
+
+/**
+ * Compute approximate squared distances between \a aP and the segments
+ * aPts[i] - aPts[i + 1] for 0 <= i < aCount (so aPts must hold aCount + 1 points).
+ */
+void SegKernelSquaredDistances( const VECTOR2I& aP, const VECTOR2I* aPts, int aCount,
+                                double* aDistSq );
+
+/**
+ * Compute approximate squared distances between \a aSeg and the segments
+ * aPts[i] - aPts[i + 1] for 0 <= i < aCount.  Segments which might intersect \a aSeg get
+ * a distance of 0.
+ */
+void SegKernelSquaredDistances( const SEG& aSeg, const VECTOR2I* aPts, int aCount,
+                                double* aDistSq );
+
+/**
+ * @return the approximate squared distance at or above which a segment can't have an exact
+ * squared distance below \a aBest.
+ */
+inline double SegKernelThreshold( double aBest )
+{
+    // SEG rounds nearest points to integer coordinates, so its distances can be about 1.5
+    // units off the true ones.
+    double dist = std::sqrt( aBest ) + 2.0;
+
+    return dist * dist * ( 1.0 + 1e-9 );
+}
+
+
+inline double SegKernelThreshold( SEG::ecoord aBest )
+{
+    if( aBest == VECTOR2I::ECOORD_MAX )
+        return std::numeric_limits<double>::infinity();
+
+    return SegKernelThreshold( (double) aBest );
+}
+
+/**
+ * Call aVisit( i ), in order, for each segment aPts[i] - aPts[i + 1] with 0 <= i < aCount
+ * whose distance to \a aQuery (a point or a SEG) could be below \a aBest and could be the
+ * smallest of all the segments.  aBest is re-read after each visit, so the visitor can
+ * tighten it.  The walk stops when aVisit returns false.
+ *
+ * Visitors which stop at the first segment nearer than some distance, rather than at the
+ * nearest one, must pass that distance as \a aAlwaysVisit.
+ * @return false if the visitor stopped the walk.
+ */
+template <typename QUERY, typename VISITOR>
+bool SegKernelForEachCandidate( const QUERY& aQuery, const VECTOR2I* aPts, int aCount,
+                                const SEG::ecoord& aBest, VISITOR aVisit,
+                                SEG::ecoord aAlwaysVisit = 0 )
+{
+    double              localDistSq[SEG_KERNEL_BLOCK];
+    std::vector<double> heapDistSq;
+    double*             distSq = localDistSq;
+
+    if( aCount > SEG_KERNEL_BLOCK )
+    {
+        heapDistSq.resize( aCount );
+        distSq = heapDistSq.data();
+    }
+
+    SegKernelSquaredDistances( aQuery, aPts, aCount, distSq );
+
+    // The nearest segment's exact distance is below SegKernelThreshold( nearest ), so a
+    // segment can only match it if it passes the threshold of that.
+    double nearest = *std::min_element( distSq, distSq + aCount );
+    double limit = std::max( SegKernelThreshold( SegKernelThreshold( nearest ) ),
+                             SegKernelThreshold( aAlwaysVisit ) );
+    double threshold = std::min( SegKernelThreshold( aBest ), limit );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        if( distSq[ii] >= threshold )
+            continue;
+
+        if( !aVisit( ii ) )
+            return false;
+
+        threshold = std::min( SegKernelThreshold( aBest ), limit );
+    }
+
+    return true;
+}
+
+/**
+ * @return the squared distance from \a aBox to \a aP, or to the bounding box of \a aSeg: no
+ *         more than the distance to any segment inside \a aBox.
+ */
+inline double SegKernelSquaredDistance( const BOX2I& aBox, const VECTOR2I& aP )
+{
+    double dx = std::max( { 0.0, (double) aBox.GetX() - aP.x, (double) aP.x - aBox.GetRight() } );
+    double dy = std::max( { 0.0, (double) aBox.GetY() - aP.y, (double) aP.y - aBox.GetBottom() } );
+
+    return dx * dx + dy * dy;
+}
+
+
+inline double SegKernelSquaredDistance( const BOX2I& aBox, const SEG& aSeg )
+{
+    double dx = std::max( { 0.0, (double) aBox.GetX() - std::max( aSeg.A.x, aSeg.B.x ),
+                            (double) std::min( aSeg.A.x, aSeg.B.x ) - aBox.GetRight() } );
+    double dy = std::max( { 0.0, (double) aBox.GetY() - std::max( aSeg.A.y, aSeg.B.y ),
+                            (double) std::min( aSeg.A.y, aSeg.B.y ) - aBox.GetBottom() } );
+
+    return dx * dx + dy * dy;
+}
+
+/**
+ * Visit the segments of \a aChain as above.  The batch kernels are used when the chain's
+ * vertices are contiguous; otherwise, and for the closing segment of a closed chain, every
+ * segment is visited.  When the chain has a SEGMENT_BVH, runs of segments whose box is too
+ * far away for any of them to pass the threshold are skipped altogether.
+ */
+template <typename QUERY, typename VISITOR>
+bool SegKernelForEachCandidate( const QUERY& aQuery, const SHAPE_LINE_CHAIN_BASE& aChain,
+                                const SEG::ecoord& aBest, VISITOR aVisit,
+                                SEG::ecoord aAlwaysVisit = 0 )
+{
+    int             segCount = aChain.GetSegmentCount();
+    int             first = 0;
+    const VECTOR2I* pts = aChain.GetContiguousPoints();
+
+    if( pts )
+        first = std::min( segCount, (int) aChain.GetPointCount() - 1 );
+
+    // Visits the segments aStart to aEnd - 1, as a plain loop over them would
+    auto visitRun =
+            [&]( int aStart, int aEnd ) -> bool
+            {
+                int contiguousEnd = std::min( aEnd, first );
+
+                if( aStart < contiguousEnd
+                        && !SegKernelForEachCandidate( aQuery, pts + aStart,
+                                                       contiguousEnd - aStart, aBest,
+                                                       [&]( int ii ) -> bool
+                                                       {
+                                                           return aVisit( aStart + ii );
+                                                       },
+                                                       aAlwaysVisit ) )
+                {
+                    return false;
+                }
+
+                for( int ii = std::max( aStart, contiguousEnd ); ii < aEnd; ++ii )
+                {
+                    if( !aVisit( ii ) )
+                        return false;
+                }
+
+                return true;
+            };
+
+    const SEGMENT_BVH* bvh = pts ? aChain.GetSegmentBVH() : nullptr;
+
+    if( !bvh )
+        return visitRun( 0, segCount );
+
+    // SEG distances are within a couple of units of the true ones, so a segment in a box
+    // past the threshold can't be nearer than aBest.  Nor than aAlwaysVisit: until the
+    // visitor finds a segment nearer than that and stops, aBest is at least aAlwaysVisit.
+    return bvh->ForEachRun(
+            [&]( const BOX2I& aBox ) -> bool
+            {
+                return SegKernelSquaredDistance( aBox, aQuery ) >= SegKernelThreshold( aBest );
+            },
+            [&]( int aStart, int aCount ) -> bool
+            {
+                return visitRun( aStart, aStart + aCount );
+            } );
+}
+
+#endif // SEG_DISTANCE_KERNELS_H
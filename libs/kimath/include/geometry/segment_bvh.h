@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef SEGMENT_BVH_H
+#define SEGMENT_BVH_H
+
+#include <algorithm>
+#include <vector>
+
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+/**
+ * A bounding volume hierarchy over the segments of a long line chain.  Each leaf box bounds
+ * a run of LEAF_SIZE consecutive segments, and each box above bounds BRANCHING consecutive
+ * boxes of the level below.  Consecutive segments of a chain are close together, so the
+ * boxes are small, and as ForEachRun() visits the runs in chain order, queries using it see
+ * the segments in the same order as a plain loop over them.
+ */
+class SEGMENT_BVH
+{
+public:
+    static const int LEAF_SIZE = 16;
+    static const int BRANCHING = 16;
+
+    /// Chains with fewer segments are quicker to test directly
+    static const int MIN_SEGMENTS = 256;
+
+    /**
+     * @param aPts the vertices of the chain.
+     * @param aPointCount number of vertices.
+     * @param aSegmentCount number of segments: aPointCount for a closed chain, whose last
+     *                      segment joins the last vertex to the first one.
+     */
+    SEGMENT_BVH( const VECTOR2I* aPts, int aPointCount, int aSegmentCount );
+
+    /**
+     * Call aVisitRun( first, count ), in order, for each run of segments first to
+     * first + count - 1 whose box aSkip( box ) doesn't reject.  aSkip may tighten as runs are
+     * visited.  The walk stops when aVisitRun returns false.
+     *
+     * @return false if the visitor stopped the walk.
+     */
+    template <typename SKIP, typename VISITOR>
+    bool ForEachRun( SKIP aSkip, VISITOR aVisitRun ) const
+    {
+        int top = m_levels.size() - 1;
+
+        return visit( top, 0, m_levels[top].size(), aSkip, aVisitRun );
+    }
+
+    /**
+     * Move the boxes along with the chain.
+     */
+    void Move( const VECTOR2I& aVector );
+
+private:
+    template <typename SKIP, typename VISITOR>
+    bool visit( int aLevel, int aFirst, int aLast, SKIP& aSkip, VISITOR& aVisitRun ) const
+    {
+        const std::vector<BOX2I>& boxes = m_levels[aLevel];
+
+        for( int ii = aFirst; ii < aLast; ++ii )
+        {
+            if( aSkip( boxes[ii] ) )
+                continue;
+
+            if( aLevel == 0 )
+            {
+                int first = ii * LEAF_SIZE;
+
+                if( !aVisitRun( first, std::min( LEAF_SIZE, m_segmentCount - first ) ) )
+                    return false;
+            }
+            else
+            {
+                int last = std::min<int>( ( ii + 1 ) * BRANCHING, m_levels[aLevel - 1].size() );
+
+                if( !visit( aLevel - 1, ii * BRANCHING, last, aSkip, aVisitRun ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    int                             m_segmentCount;
+    std::vector<std::vector<BOX2I>> m_levels;       ///< Leaf boxes first, the top level last
+};
+
+#endif // SEGMENT_BVH_H
@@ -32,6 +32,7 @@
 #include <math/box2.h>
 
 class SHAPE_LINE_CHAIN;
+class SEGMENT_BVH;
 
 /**
  * Enum SHAPE_TYPE
@@ -327,6 +328,18 @@ public:
     virtual size_t         GetPointCount() const          = 0;
     virtual size_t         GetSegmentCount() const        = 0;
     virtual bool IsClosed() const = 0;
+
+    /**
+     * @return the chain's vertices as a contiguous array, or nullptr if they aren't stored
+     *         that way.  Used to run the batch segment distance kernels over the chain.
+     */
+    virtual const VECTOR2I* GetContiguousPoints() const { return nullptr; }
+
+    /**
+     * @return a hierarchy of boxes over the chain's segments, or nullptr if the chain doesn't
+     *         keep one (or isn't worth one yet).  Used to skip runs of distant segments.
+     */
+    virtual const SEGMENT_BVH* GetSegmentBVH() const { return nullptr; }
 };
 
 #endif // __SHAPE_H
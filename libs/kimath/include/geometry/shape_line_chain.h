@@ -27,8 +27,11 @@
 #define __SHAPE_LINE_CHAIN
 
 
+#include <atomic>
+
 #include <clipper.hpp>
 #include <geometry/seg.h>
+#include <geometry/segment_bvh.h>
 #include <geometry/shape.h>
 #include <geometry/shape_arc.h>
 #include <math/vector2d.h>
@@ -159,9 +162,11 @@ public:
     }
 
     virtual ~SHAPE_LINE_CHAIN()
-    {}
+    {
+        delete m_bvh.load();
+    }
 
-    SHAPE_LINE_CHAIN& operator=(const SHAPE_LINE_CHAIN&) = default;
+    SHAPE_LINE_CHAIN& operator=( const SHAPE_LINE_CHAIN& aOther );
 
     SHAPE* Clone() const override;
 
@@ -171,6 +176,7 @@ public:
      */
     void Clear()
     {
+        invalidateBVH();
         m_points.clear();
         m_arcs.clear();
         m_shapes.clear();
@@ -186,6 +192,9 @@ public:
      */
     void SetClosed( bool aClosed )
     {
+        if( aClosed != m_closed )
+            invalidateBVH();
+
         m_closed = aClosed;
     }
 
@@ -295,6 +304,7 @@ public:
         else if( aIndex >= PointCount() )
             aIndex -= PointCount();
 
+        invalidateBVH();
         m_points[aIndex] = aPos;
 
         if( m_shapes[aIndex] != SHAPE_IS_PT )
@@ -429,6 +439,7 @@ public:
 
         if( m_points.size() == 0 || aAllowDuplication || CPoint( -1 ) != aP )
         {
+            invalidateBVH();
             m_points.push_back( aP );
             m_shapes.push_back( ssize_t( SHAPE_IS_PT ) );
             m_bbox.Merge( aP );
@@ -669,6 +680,9 @@ public:
 
         for( auto& arc : m_arcs )
             arc.Move( aVector );
+
+        if( SEGMENT_BVH* bvh = m_bvh.load() )
+            bvh->Move( aVector );
     }
 
     /**
@@ -724,7 +738,26 @@ public:
     virtual size_t GetPointCount() const override { return PointCount(); }
     virtual size_t GetSegmentCount() const override { return SegmentCount(); }
 
+    virtual const VECTOR2I* GetContiguousPoints() const override
+    {
+        return m_points.empty() ? nullptr : m_points.data();
+    }
+
+    virtual const SEGMENT_BVH* GetSegmentBVH() const override;
+
 private:
+    /**
+     * Drop the segment hierarchy after an edit.  Cheap unless the chain has been queried
+     * since it was last edited.
+     */
+    void invalidateBVH()
+    {
+        if( m_bvhQueries.load( std::memory_order_relaxed ) )
+        {
+            delete m_bvh.exchange( nullptr );
+            m_bvhQueries = 0;
+        }
+    }
 
     constexpr static ssize_t SHAPE_IS_PT = -1;
 
@@ -752,6 +785,10 @@ private:
 
     /// cached bounding box
     BOX2I m_bbox;
+
+    /// Boxes over the segments of a long chain, built by GetSegmentBVH() once it is queried
+    mutable std::atomic<SEGMENT_BVH*> m_bvh{ nullptr };
+    mutable std::atomic<int>          m_bvhQueries{ 0 };
 };
 
 
@@ -26,6 +26,7 @@
 #ifndef __SHAPE_POLY_SET_H
 #define __SHAPE_POLY_SET_H
 
+#include <atomic>
 #include <cstdio>
 #include <deque>                        // for deque
 #include <vector>                       // for vector
@@ -59,6 +60,11 @@
  *      outline or a hole.
  *      - Vertex (or corner): each one of the points that define a contour.
  *
+ * Thread safety: a set may be read from several threads at once through its const methods,
+ * but it has a single writer.  Nothing may read a set while its non-const methods, including
+ * the accessors handing out references, run on another thread.  Copies of a set share its
+ * polygons until one of them changes, and may be used from different threads as separate sets.
+ *
  * TODO: add convex partitioning & spatial index
  */
 class SHAPE_POLY_SET : public SHAPE
@@ -291,7 +297,7 @@ class SHAPE_POLY_SET : public SHAPE
 
             const T& Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].CPoint(
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CPoint(
                         m_currentVertex );
             }
 
@@ -414,7 +420,8 @@ class SHAPE_POLY_SET : public SHAPE
 
             T Get()
             {
-                return m_poly->Polygon( m_currentPolygon )[m_currentContour].Segment( m_currentSegment );
+                return m_poly->CPolygon( m_currentPolygon )[m_currentContour].CSegment(
+                        m_currentSegment );
             }
 
             T operator*()
@@ -637,7 +644,8 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aIndex-th outline in the set
         SHAPE_LINE_CHAIN& Outline( int aIndex )
         {
-            return m_polys[aIndex][0];
+            suspectContainsIndex();
+            return m_polys.Expose()[aIndex][0];
         }
 
         /**
@@ -659,13 +667,15 @@ class SHAPE_POLY_SET : public SHAPE
         ///> Returns the reference to aHole-th hole in the aIndex-th outline
         SHAPE_LINE_CHAIN& Hole( int aOutline, int aHole )
         {
-            return m_polys[aOutline][aHole + 1];
+            suspectContainsIndex();
+            return m_polys.Expose()[aOutline][aHole + 1];
         }
 
         ///> Returns the aIndex-th subpolygon in the set
         POLYGON& Polygon( int aIndex )
         {
-            return m_polys[aIndex];
+            suspectContainsIndex();
+            return m_polys.Expose()[aIndex];
         }
 
         const POLYGON& Polygon( int aIndex ) const
@@ -707,6 +717,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             ITERATOR iter;
 
+            suspectContainsIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -819,6 +831,8 @@ class SHAPE_POLY_SET : public SHAPE
         {
             SEGMENT_ITERATOR iter;
 
+            suspectContainsIndex();
+
             iter.m_poly = this;
             iter.m_currentPolygon = aFirst;
             iter.m_lastPolygon = aLast < 0 ? OutlineCount() - 1 : aLast;
@@ -988,6 +1002,18 @@ class SHAPE_POLY_SET : public SHAPE
         ///> For aFastMode meaning, see function booleanOp
         void Simplify( POLYGON_MODE aFastMode );
 
+        /**
+         * Merges overlapping polygons like Simplify(), but for large sets the polygons are
+         * grouped spatially and the groups merged on separate threads, the partial results
+         * being merged pairwise.  This avoids running a single Clipper sweep over thousands
+         * of small polygons (as accumulated with Append() for knockouts).
+         * For aFastMode meaning, see function booleanOp
+         * @param aMaxThreads is the most threads to merge on, including the calling one, or 0
+         *                    for as many as there are cores.  Callers already running on one
+         *                    of several worker threads should pass their share of the cores.
+         */
+        void BatchUnion( POLYGON_MODE aFastMode, size_t aMaxThreads = 0 );
+
         /**
          * Function NormalizeAreaOutlines
          * Convert a self-intersecting polygon to one (or more) non self-intersecting polygon(s)
@@ -1137,6 +1163,9 @@ class SHAPE_POLY_SET : public SHAPE
         /**
          * Returns true if a given subpolygon contains the point aP
          *
+         * Once a set has been queried a few times without being edited, large outlines are
+         * indexed so that further queries only test the edges near aP.
+         *
          * @param aP is the point to check
          * @param aSubpolyIndex is the subpolygon to check, or -1 to check all
          * @param aUseBBoxCaches gives faster performance when multiple calls are made with no
@@ -1347,6 +1376,29 @@ class SHAPE_POLY_SET : public SHAPE
         bool containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                              bool aUseBBoxCaches = false ) const;
 
+        /// Index over the edges of the outlines and holes, used by containsSingle()
+        class CONTAINS_INDEX;
+
+        /**
+         * @return the containment index, building it if the set has been queried often enough
+         *         since it was last edited, or nullptr if it isn't worth building yet.  The
+         *         caller shares ownership, so the index outlives a concurrent invalidation.
+         */
+        std::shared_ptr<const CONTAINS_INDEX> containsIndex() const;
+
+        /**
+         * Discards the containment index.  Must be called by anything which changes the
+         * polygons.
+         */
+        void invalidateContainsIndex();
+
+        /**
+         * Notes that the polygons may have been changed through a non-const reference handed
+         * out to them.  The index is kept, but checked against the polygons before it is next
+         * used.
+         */
+        void suspectContainsIndex();
+
         /**
          * Operations ChamferPolygon and FilletPolygon are computed under the private chamferFillet
          * method; this enum is defined to make the necessary distinction when calling this method
@@ -1380,17 +1432,124 @@ class SHAPE_POLY_SET : public SHAPE
 
         typedef std::vector<POLYGON> POLYSET;
 
-        POLYSET m_polys;
+        /**
+         * Polygon storage shared between copies of a set until one of them changes it.
+         *
+         * Reads go through the const accessors.  Anything changing the polygons must go through
+         * Edit(), which first takes a private copy if the storage is shared.  References handed
+         * out of the set must go through Expose() instead: the holder may still write through
+         * them, so copies of the set made after that take their own storage straight away.
+         *
+         * The shared_ptr itself is not accessed atomically; the set's single-writer rule covers
+         * it.  Edit() may find the storage shared with a copy owned by another thread: that
+         * thread only reads the storage or drops its reference, both of which are safe while
+         * the copy is taken, and a use_count() of 1 can't be raised again by anyone else.
+         */
+        class POLYSET_STORAGE
+        {
+        public:
+            POLYSET_STORAGE() :
+                    m_polys( std::make_shared<POLYSET>() ),
+                    m_exposed( false )
+            {
+            }
+
+            POLYSET_STORAGE( const POLYSET_STORAGE& aOther ) :
+                    m_polys( aOther.share() ),
+                    m_exposed( false )
+            {
+            }
+
+            POLYSET_STORAGE& operator=( const POLYSET_STORAGE& aOther )
+            {
+                if( &aOther != this )
+                {
+                    m_polys = aOther.share();
+                    m_exposed = false;
+                }
+
+                return *this;
+            }
+
+            POLYSET_STORAGE& operator=( POLYSET&& aPolys )
+            {
+                m_polys = std::make_shared<POLYSET>( std::move( aPolys ) );
+                m_exposed = false;
+                return *this;
+            }
+
+            POLYSET& Edit()
+            {
+                if( m_polys.use_count() > 1 )
+                {
+                    m_polys = std::make_shared<POLYSET>( *m_polys );
+                }
+                else
+                {
+                    // Pairs with the release by the last other owner, which may have been
+                    // reading the polygons from another thread
+                    std::atomic_thread_fence( std::memory_order_acquire );
+                }
+
+                return *m_polys;
+            }
+
+            POLYSET& Expose()
+            {
+                m_exposed = true;
+                return Edit();
+            }
+
+            size_t size() const { return m_polys->size(); }
+            bool empty() const { return m_polys->empty(); }
+            const POLYGON& operator[]( size_t aIndex ) const { return ( *m_polys )[aIndex]; }
+            const POLYGON& back() const { return m_polys->back(); }
+            POLYSET::const_iterator begin() const { return m_polys->cbegin(); }
+            POLYSET::const_iterator end() const { return m_polys->cend(); }
+
+        private:
+            std::shared_ptr<POLYSET> share() const
+            {
+                return m_exposed ? std::make_shared<POLYSET>( *m_polys ) : m_polys;
+            }
+
+            std::shared_ptr<POLYSET> m_polys;
+            bool                     m_exposed;
+        };
+
+        POLYSET_STORAGE m_polys;
 
     public:
 
         SHAPE_POLY_SET& operator=( const SHAPE_POLY_SET& );
 
+        /**
+         * Triangulates the polygons of the set, if they changed since the last call.
+         *
+         * Polygons whose shape is unchanged, even if moved, keep their triangulation; the others
+         * are triangulated in parallel.
+         * @param aPartition splits polygons into a regular grid of cells before triangulating
+         *                   them, which gives smaller triangles.
+         */
         void CacheTriangulation( bool aPartition = true );
+
+        /**
+         * Triangulates several sets at once, as CacheTriangulation() does for each of them, but
+         * spreading the work over all of their polygons.
+         */
+        static void CacheTriangulations( const std::vector<SHAPE_POLY_SET*>& aSets,
+                                         bool aPartition = true );
+
         bool IsTriangulationUpToDate() const;
 
         MD5_HASH GetHash() const;
 
+        /**
+         * @return a hash of the vertices of the set, computed afresh.  Unlike GetHash(), which
+         *         returns the hash of the last triangulation, it can't be out of date.
+         */
+        MD5_HASH Checksum() const;
+
         virtual bool HasIndexableSubshapes() const override;
 
         virtual size_t GetIndexableSubshapeCount() const override;
@@ -1399,12 +1558,33 @@ class SHAPE_POLY_SET : public SHAPE
 
     private:
 
-        MD5_HASH checksum() const;
+        ///> The polygon a part of the triangulation was made from
+        struct TRIANGULATION_SOURCE
+        {
+            MD5_HASH m_shapeHash;   ///< hash of the polygon, relative to its first vertex
+            VECTOR2I m_anchor;      ///< the first vertex of the polygon
+            unsigned m_partCount;   ///< number of entries of m_triangulatedPolys made from it
+        };
 
-        std::vector<std::unique_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
+        /// Shared between copies of the set, like the polygons
+        std::vector<std::shared_ptr<TRIANGULATED_POLYGON>> m_triangulatedPolys;
         bool m_triangulationValid = false;
         MD5_HASH m_hash;
 
+        /// One entry per polygon last triangulated, in the order of m_triangulatedPolys
+        std::vector<TRIANGULATION_SOURCE> m_triangulationSources;
+        bool m_triangulationPartitioned = false;
+
+        /// Built lazily by containsIndex(), so it may be set concurrently by const queries.
+        /// Only accessed with std::atomic_load() and std::atomic_store().
+        mutable std::shared_ptr<const CONTAINS_INDEX> m_containsIndex;
+
+        /// Whether m_containsIndex is known to match the polygons (see suspectContainsIndex())
+        mutable std::atomic<int> m_containsIndexState{ 0 };
+
+        /// Number of containment queries since the polygons were last edited
+        mutable std::atomic<int> m_containsQueries{ 0 };
+
 };
 
 #endif
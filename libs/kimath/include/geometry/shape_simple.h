@@ -186,6 +186,11 @@ public:
     virtual size_t GetPointCount() const override { return m_points.PointCount(); }
     virtual size_t GetSegmentCount() const override { return m_points.SegmentCount(); }
 
+    virtual const VECTOR2I* GetContiguousPoints() const override
+    {
+        return m_points.GetContiguousPoints();
+    }
+
     bool IsClosed() const override
     {
         return true;
@@ -26,7 +26,11 @@
  */
 
 #include <algorithm>                    // for max, min
+#include <array>
+#include <cstring>                      // for memcpy
+#include <map>
 #include <math.h>                       // for atan2
+#include <mutex>
 #include <type_traits>                  // for swap
 
 #include <convert_basic_shapes_to_polygon.h>
@@ -38,10 +42,106 @@
 #include <trigo.h>
 
 
+namespace
+{
+
+/**
+ * Rotates points by whole multiples of 0.1 degree using a table of sines and cosines built
+ * once, instead of evaluating them for every corner of every circle and arc.  The points
+ * land exactly where RotatePoint() puts them.
+ */
+class UNIT_CIRCLE
+{
+public:
+    static const UNIT_CIRCLE& Get()
+    {
+        static const UNIT_CIRCLE instance;
+        return instance;
+    }
+
+    /// Same as RotatePoint( &aPoint, aAngle ) for 0 <= aAngle < 3600
+    wxPoint Rotate( const wxPoint& aPoint, int aAngle ) const
+    {
+        const double sinus = m_sin[aAngle];
+        const double cosinus = m_cos[aAngle];
+
+        double fpx = ( aPoint.y * sinus ) + ( aPoint.x * cosinus );
+        double fpy = ( aPoint.y * cosinus ) - ( aPoint.x * sinus );
+
+        return wxPoint( KiROUND( fpx ), KiROUND( fpy ) );
+    }
+
+private:
+    UNIT_CIRCLE()
+    {
+        for( int angle = 0; angle < 3600; ++angle )
+        {
+            m_sin[angle] = sin( DECIDEG2RAD( angle ) );
+            m_cos[angle] = cos( DECIDEG2RAD( angle ) );
+        }
+
+        // RotatePoint() handles the right angles exactly
+        for( int quarter = 0; quarter < 4; ++quarter )
+        {
+            m_sin[quarter * 900] = quarter == 1 ? 1.0 : quarter == 3 ? -1.0 : 0.0;
+            m_cos[quarter * 900] = quarter == 0 ? 1.0 : quarter == 2 ? -1.0 : 0.0;
+        }
+    }
+
+    double m_sin[3600];
+    double m_cos[3600];
+};
+
+
+/**
+ * A small cache of polygonized shapes, keyed by everything that goes into building them
+ * (sizes, error and error location).  Pads and vias come in a handful of sizes, so most
+ * shapes are built once and copied afterwards.
+ */
+class POLYGON_CACHE
+{
+public:
+    typedef std::array<long long, 8> KEY;
+
+    bool Get( const KEY& aKey, SHAPE_POLY_SET& aShape )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        auto it = m_shapes.find( aKey );
+
+        if( it == m_shapes.end() )
+            return false;
+
+        aShape = it->second;
+        return true;
+    }
+
+    void Put( const KEY& aKey, const SHAPE_POLY_SET& aShape )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        // Shapes are cheap to rebuild, so simply start over rather than track their use
+        if( m_shapes.size() >= MAX_SHAPES )
+            m_shapes.clear();
+
+        m_shapes.emplace( aKey, aShape );
+    }
+
+private:
+    static const size_t MAX_SHAPES = 1024;
+
+    std::mutex                     m_mutex;
+    std::map<KEY, SHAPE_POLY_SET>  m_shapes;
+};
+
+} // anonymous namespace
+
+
 void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aCornerBuffer, wxPoint aCenter, int aRadius,
                                int aError, ERROR_LOC aErrorLoc )
 {
-    wxPoint corner_position;
+    const UNIT_CIRCLE& unitCircle = UNIT_CIRCLE::Get();
+
     int     numSegs = GetArcToSegmentCount( aRadius, aError, 360.0 );
     int     delta = 3600 / numSegs;           // rotate angle in 0.1 degree
     int     radius = aRadius;
@@ -51,10 +151,7 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aCornerBuffer, wxPoint aCenter,
 
     for( int angle = 0; angle < 3600; angle += delta )
     {
-        corner_position.x   = radius;
-        corner_position.y   = 0;
-        RotatePoint( &corner_position, angle );
-        corner_position += aCenter;
+        wxPoint corner_position = unitCircle.Rotate( wxPoint( radius, 0 ), angle ) + aCenter;
         aCornerBuffer.Append( corner_position.x, corner_position.y );
     }
 
@@ -65,6 +162,8 @@ void TransformCircleToPolygon( SHAPE_LINE_CHAIN& aCornerBuffer, wxPoint aCenter,
 void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, int aRadius,
                                int aError, ERROR_LOC aErrorLoc )
 {
+    const UNIT_CIRCLE& unitCircle = UNIT_CIRCLE::Get();
+
     wxPoint corner_position;
     int     numSegs = GetArcToSegmentCount( aRadius, aError, 360.0 );
     int     delta = 3600 / numSegs;           // rotate angle in 0.1 degree
@@ -77,10 +176,7 @@ void TransformCircleToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aCenter, i
 
     for( int angle = 0; angle < 3600; angle += delta )
     {
-        corner_position.x = radius;
-        corner_position.y = 0;
-        RotatePoint( &corner_position, angle );
-        corner_position += aCenter;
+        corner_position = unitCircle.Rotate( wxPoint( radius, 0 ), angle ) + aCenter;
         aCornerBuffer.Append( corner_position.x, corner_position.y );
     }
 
@@ -114,8 +210,6 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     wxPoint        corner;
     SHAPE_POLY_SET polyshape;
 
-    polyshape.NewOutline();
-
     // normalize the position in order to have endp.x >= 0
     // it makes calculations more easy to understand
     if( endp.x < 0 )
@@ -131,13 +225,17 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     // Compute the outlines of the segment, and creates a polygon
     // Note: the polygonal shape is built from the equivalent horizontal
     // segment starting at {0,0}, and ending at {seg_len,0}
+    // Tracks and text strokes nearly all differ in length, so unlike pad shapes these aren't
+    // cached: building them from the trig table costs about as much as copying them.
+    const UNIT_CIRCLE& unitCircle = UNIT_CIRCLE::Get();
+
+    polyshape.NewOutline();
 
     // add right rounded end:
 
     for( int angle = 0; angle < 1800; angle += delta )
     {
-        corner = wxPoint( 0, radius );
-        RotatePoint( &corner, angle );
+        corner = unitCircle.Rotate( wxPoint( 0, radius ), angle );
         corner.x += seg_len;
         polyshape.Append( corner.x, corner.y );
     }
@@ -149,8 +247,7 @@ void TransformOvalToPolygon( SHAPE_POLY_SET& aCornerBuffer, wxPoint aStart, wxPo
     // add left rounded end:
     for( int angle = 0; angle < 1800; angle += delta )
     {
-        corner = wxPoint( 0, -radius );
-        RotatePoint( &corner, angle );
+        corner = unitCircle.Rotate( wxPoint( 0, -radius ), angle );
         polyshape.Append( corner.x, corner.y );
     }
 
@@ -220,14 +317,14 @@ void TransformRoundRectToPolygon( SHAPE_POLY_SET& aCornerBuffer, const wxSize& a
     if( aErrorLoc == ERROR_OUTSIDE )
         radius += GetCircleToPolyCorrection( aError );
 
+    const UNIT_CIRCLE& unitCircle = UNIT_CIRCLE::Get();
+
     auto genArc =
             [&]( const wxPoint& aCenter, int aStart, int aEnd )
     {
         for( int angle = aStart + delta; angle < aEnd; angle += delta )
         {
-            wxPoint pt( -radius, 0 );
-            RotatePoint( &pt, angle );
-            pt += aCenter;
+            wxPoint pt = unitCircle.Rotate( wxPoint( -radius, 0 ), angle ) + aCenter;
             aCornerBuffer.Append( pt.x, pt.y );
         }
     };
@@ -257,6 +354,26 @@ void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer, const
                                            int aChamferCorners, int aError, ERROR_LOC aErrorLoc )
 {
     SHAPE_POLY_SET outline;
+
+    // The outline at position 0,0 and orientation 0.0 only depends on these
+    long long chamferRatioBits;
+    std::memcpy( &chamferRatioBits, &aChamferRatio, sizeof( chamferRatioBits ) );
+
+    static POLYGON_CACHE      cache;
+    const POLYGON_CACHE::KEY key = { aSize.x, aSize.y, aCornerRadius, chamferRatioBits,
+                                     aChamferCorners, aError, aErrorLoc,
+                                     GetCircleToPolyCorrection( aError ) };
+
+    if( cache.Get( key, outline ) )
+    {
+        if( aRotation != 0.0 )
+            outline.Rotate( DECIDEG2RAD( -aRotation ), VECTOR2I( 0, 0 ) );
+
+        outline.Move( VECTOR2I( aPosition ) );
+        aCornerBuffer.Append( outline );
+        return;
+    }
+
     TransformRoundRectToPolygon( outline, aSize, aCornerRadius, aError, aErrorLoc );
 
     if( aChamferCorners )
@@ -311,6 +428,8 @@ void TransformRoundChamferedRectToPolygon( SHAPE_POLY_SET& aCornerBuffer, const
         }
     }
 
+    cache.Put( key, outline );
+
     // Rotate and move the outline:
     if( aRotation != 0.0 )
         outline.Rotate( DECIDEG2RAD( -aRotation ), VECTOR2I( 0, 0 ) );
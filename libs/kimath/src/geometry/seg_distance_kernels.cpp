@@ -0,0 +1,303 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/seg_distance_kernels.h>
+
+#if defined( __AVX__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+
+/*
+ * The kernels are written once against a small set of lane operations, which are provided
+ * for AVX (4 doubles), SSE2 (2 doubles) and plain scalar code.  Masks are lanes with all
+ * bits set or cleared, as produced by the SIMD compare instructions.
+ */
+
+struct SCALAR_LANES
+{
+    typedef double V;
+    static const int N = 1;
+
+    static void LoadPoints( const VECTOR2I* p, V& x, V& y ) { x = p->x; y = p->y; }
+    static void Store( double* p, V a ) { *p = a; }
+    static V Set( double a ) { return a; }
+    static V Add( V a, V b ) { return a + b; }
+    static V Sub( V a, V b ) { return a - b; }
+    static V Mul( V a, V b ) { return a * b; }
+    static V Div( V a, V b ) { return a / b; }
+    static V Min( V a, V b ) { return a < b ? a : b; }
+    static V Max( V a, V b ) { return a > b ? a : b; }
+    static V Abs( V a ) { return std::fabs( a ); }
+
+    // Masks are kept as 0.0 / 1.0 in the scalar case.
+    static V Greater( V a, V b ) { return a > b ? 1.0 : 0.0; }
+    static V And( V a, V b ) { return a * b; }
+    static V Or( V a, V b ) { return a + b > 0.0 ? 1.0 : 0.0; }
+    static V ZeroIf( V aMask, V a ) { return aMask != 0.0 ? 0.0 : a; }
+};
+
+
+#if defined( __AVX__ )
+
+struct SIMD_LANES
+{
+    typedef __m256d V;
+    static const int N = 4;
+
+    static void LoadPoints( const VECTOR2I* p, V& x, V& y )
+    {
+        // Gather x0 x1 y0 y1 and x2 x3 y2 y3, then split into x and y
+        __m128i lo = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*) p ), 0xD8 );
+        __m128i hi = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*) ( p + 2 ) ), 0xD8 );
+
+        x = _mm256_cvtepi32_pd( _mm_unpacklo_epi64( lo, hi ) );
+        y = _mm256_cvtepi32_pd( _mm_unpackhi_epi64( lo, hi ) );
+    }
+
+    static void Store( double* p, V a ) { _mm256_storeu_pd( p, a ); }
+    static V Set( double a ) { return _mm256_set1_pd( a ); }
+    static V Add( V a, V b ) { return _mm256_add_pd( a, b ); }
+    static V Sub( V a, V b ) { return _mm256_sub_pd( a, b ); }
+    static V Mul( V a, V b ) { return _mm256_mul_pd( a, b ); }
+    static V Div( V a, V b ) { return _mm256_div_pd( a, b ); }
+    static V Min( V a, V b ) { return _mm256_min_pd( a, b ); }
+    static V Max( V a, V b ) { return _mm256_max_pd( a, b ); }
+    static V Abs( V a ) { return _mm256_andnot_pd( _mm256_set1_pd( -0.0 ), a ); }
+
+    static V Greater( V a, V b ) { return _mm256_cmp_pd( a, b, _CMP_GT_OQ ); }
+    static V And( V a, V b ) { return _mm256_and_pd( a, b ); }
+    static V Or( V a, V b ) { return _mm256_or_pd( a, b ); }
+    static V ZeroIf( V aMask, V a ) { return _mm256_andnot_pd( aMask, a ); }
+};
+
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+
+struct SIMD_LANES
+{
+    typedef __m128d V;
+    static const int N = 2;
+
+    static void LoadPoints( const VECTOR2I* p, V& x, V& y )
+    {
+        // Gather x0 x1 y0 y1, then split into x and y
+        __m128i xy = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i*) p ), 0xD8 );
+
+        x = _mm_cvtepi32_pd( xy );
+        y = _mm_cvtepi32_pd( _mm_unpackhi_epi64( xy, xy ) );
+    }
+
+    static void Store( double* p, V a ) { _mm_storeu_pd( p, a ); }
+    static V Set( double a ) { return _mm_set1_pd( a ); }
+    static V Add( V a, V b ) { return _mm_add_pd( a, b ); }
+    static V Sub( V a, V b ) { return _mm_sub_pd( a, b ); }
+    static V Mul( V a, V b ) { return _mm_mul_pd( a, b ); }
+    static V Div( V a, V b ) { return _mm_div_pd( a, b ); }
+    static V Min( V a, V b ) { return _mm_min_pd( a, b ); }
+    static V Max( V a, V b ) { return _mm_max_pd( a, b ); }
+    static V Abs( V a ) { return _mm_andnot_pd( _mm_set1_pd( -0.0 ), a ); }
+
+    static V Greater( V a, V b ) { return _mm_cmpgt_pd( a, b ); }
+    static V And( V a, V b ) { return _mm_and_pd( a, b ); }
+    static V Or( V a, V b ) { return _mm_or_pd( a, b ); }
+    static V ZeroIf( V aMask, V a ) { return _mm_andnot_pd( aMask, a ); }
+};
+
+#else
+
+typedef SCALAR_LANES SIMD_LANES;
+
+#endif
+
+
+// The SIMD loads read VECTOR2I arrays as pairs of ints
+static_assert( sizeof( VECTOR2I ) == 2 * sizeof( int ), "VECTOR2I must be two packed ints" );
+
+
+/**
+ * Squared distance from the point (px, py), given relative to the segment start, to the
+ * segment with direction (dx, dy).  invLen2 is the reciprocal of the squared segment length.
+ */
+template <typename L>
+typename L::V pointSegDistSq( typename L::V px, typename L::V py, typename L::V dx,
+                              typename L::V dy, typename L::V invLen2 )
+{
+    typename L::V t = L::Mul( L::Add( L::Mul( px, dx ), L::Mul( py, dy ) ), invLen2 );
+
+    t = L::Min( L::Max( t, L::Set( 0.0 ) ), L::Set( 1.0 ) );
+
+    typename L::V ex = L::Sub( px, L::Mul( t, dx ) );
+    typename L::V ey = L::Sub( py, L::Mul( t, dy ) );
+
+    return L::Add( L::Mul( ex, ex ), L::Mul( ey, ey ) );
+}
+
+
+/**
+ * @return the reciprocal of the squared length of the segment with direction (dx, dy).
+ */
+template <typename L>
+typename L::V invSquaredLength( typename L::V dx, typename L::V dy )
+{
+    // Coordinates are integers, so a non-degenerate segment has a squared length of at least
+    // 1, and a degenerate one has zero dot products with everything.
+    typename L::V len2 = L::Add( L::Mul( dx, dx ), L::Mul( dy, dy ) );
+
+    return L::Div( L::Set( 1.0 ), L::Max( len2, L::Set( 1.0 ) ) );
+}
+
+
+template <typename L>
+void pointDistances( const VECTOR2I& aP, const VECTOR2I* aPts, int aFirst, int aCount,
+                     double* aDistSq )
+{
+    typename L::V px = L::Set( aP.x );
+    typename L::V py = L::Set( aP.y );
+
+    for( int ii = aFirst; ii + L::N <= aCount; ii += L::N )
+    {
+        typename L::V ax, ay, bx, by;
+
+        L::LoadPoints( aPts + ii, ax, ay );
+        L::LoadPoints( aPts + ii + 1, bx, by );
+
+        typename L::V dx = L::Sub( bx, ax );
+        typename L::V dy = L::Sub( by, ay );
+
+        L::Store( aDistSq + ii, pointSegDistSq<L>( L::Sub( px, ax ), L::Sub( py, ay ), dx, dy,
+                                                   invSquaredLength<L>( dx, dy ) ) );
+    }
+}
+
+
+/**
+ * Mask of lanes where the points with cross products c1 and c2 don't lie strictly on the
+ * same side of a line.  Cross products within aTol of zero count as on the line.
+ */
+template <typename L>
+typename L::V mayStraddle( typename L::V c1, typename L::V c2, typename L::V aTol )
+{
+    typename L::V negTol = L::Sub( L::Set( 0.0 ), aTol );
+    typename L::V bothAbove = L::And( L::Greater( c1, aTol ), L::Greater( c2, aTol ) );
+    typename L::V bothBelow = L::And( L::Greater( negTol, c1 ), L::Greater( negTol, c2 ) );
+
+    // Return the complement of ( bothAbove | bothBelow ) as a mask
+    typename L::V sameSide = L::Or( bothAbove, bothBelow );
+    typename L::V allSet = L::Greater( L::Set( 1.0 ), L::Set( 0.0 ) );
+
+    return L::ZeroIf( sameSide, allSet );
+}
+
+
+template <typename L>
+void segDistances( const SEG& aSeg, const VECTOR2I* aPts, int aFirst, int aCount,
+                   double* aDistSq )
+{
+    typedef typename L::V V;
+
+    // Cross products of exact integer inputs are only a few ulps off, so a relative
+    // tolerance is enough to keep the intersection test conservative.
+    const V relTol = L::Set( 1e-9 );
+    const V cx = L::Set( aSeg.A.x );
+    const V cy = L::Set( aSeg.A.y );
+    const V ex = L::Set( aSeg.B.x - (double) aSeg.A.x );
+    const V ey = L::Set( aSeg.B.y - (double) aSeg.A.y );
+    const V einv = invSquaredLength<L>( ex, ey );
+    const V eL1 = L::Add( L::Abs( ex ), L::Abs( ey ) );
+
+    for( int ii = aFirst; ii + L::N <= aCount; ii += L::N )
+    {
+        V ax, ay, bx, by;
+
+        L::LoadPoints( aPts + ii, ax, ay );
+        L::LoadPoints( aPts + ii + 1, bx, by );
+
+        V dx = L::Sub( bx, ax );
+        V dy = L::Sub( by, ay );
+        V dinv = invSquaredLength<L>( dx, dy );
+        V dL1 = L::Add( L::Abs( dx ), L::Abs( dy ) );
+
+        // Query segment endpoints relative to the chain segment start, and chain segment
+        // endpoints relative to the query segment start
+        V acx = L::Sub( cx, ax );
+        V acy = L::Sub( cy, ay );
+        V adx = L::Add( acx, ex );
+        V ady = L::Add( acy, ey );
+        V cax = L::Sub( L::Set( 0.0 ), acx );
+        V cay = L::Sub( L::Set( 0.0 ), acy );
+        V cbx = L::Add( cax, dx );
+        V cby = L::Add( cay, dy );
+
+        V dist = pointSegDistSq<L>( acx, acy, dx, dy, dinv );
+        dist = L::Min( dist, pointSegDistSq<L>( adx, ady, dx, dy, dinv ) );
+        dist = L::Min( dist, pointSegDistSq<L>( cax, cay, ex, ey, einv ) );
+        dist = L::Min( dist, pointSegDistSq<L>( cbx, cby, ex, ey, einv ) );
+
+        // Which side of each segment the other's endpoints lie on
+        V c1 = L::Sub( L::Mul( dx, acy ), L::Mul( dy, acx ) );
+        V c2 = L::Sub( L::Mul( dx, ady ), L::Mul( dy, adx ) );
+        V c3 = L::Sub( L::Mul( ex, cay ), L::Mul( ey, cax ) );
+        V c4 = L::Sub( L::Mul( ex, cby ), L::Mul( ey, cbx ) );
+
+        V reach = L::Add( L::Add( L::Abs( acx ), L::Abs( acy ) ), L::Add( dL1, eL1 ) );
+        V tol1 = L::Mul( relTol, L::Mul( dL1, reach ) );
+        V tol2 = L::Mul( relTol, L::Mul( eL1, reach ) );
+
+        V crossing = L::And( mayStraddle<L>( c1, c2, tol1 ), mayStraddle<L>( c3, c4, tol2 ) );
+
+        L::Store( aDistSq + ii, L::ZeroIf( crossing, dist ) );
+    }
+}
+
+
+/// Number of leading entries of a block of aCount handled by whole SIMD vectors
+int simdCount( int aCount )
+{
+    return aCount - aCount % SIMD_LANES::N;
+}
+
+} // anonymous namespace
+
+
+void SegKernelSquaredDistances( const VECTOR2I& aP, const VECTOR2I* aPts, int aCount,
+                                double* aDistSq )
+{
+    int vectorized = simdCount( aCount );
+
+    pointDistances<SIMD_LANES>( aP, aPts, 0, vectorized, aDistSq );
+    pointDistances<SCALAR_LANES>( aP, aPts, vectorized, aCount, aDistSq );
+}
+
+
+void SegKernelSquaredDistances( const SEG& aSeg, const VECTOR2I* aPts, int aCount,
+                                double* aDistSq )
+{
+    int vectorized = simdCount( aCount );
+
+    segDistances<SIMD_LANES>( aSeg, aPts, 0, vectorized, aDistSq );
+    segDistances<SCALAR_LANES>( aSeg, aPts, vectorized, aCount, aDistSq );
+}
@@ -0,0 +1,70 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/segment_bvh.h>
+
+
+SEGMENT_BVH::SEGMENT_BVH( const VECTOR2I* aPts, int aPointCount, int aSegmentCount ) :
+        m_segmentCount( aSegmentCount )
+{
+    std::vector<BOX2I> leaves( ( aSegmentCount + LEAF_SIZE - 1 ) / LEAF_SIZE );
+
+    for( size_t ii = 0; ii < leaves.size(); ++ii )
+    {
+        int first = ii * LEAF_SIZE;
+        int last = std::min( first + LEAF_SIZE, aSegmentCount );   // the last segment's end
+        BOX2I& box = leaves[ii];
+
+        box = BOX2I( aPts[first], VECTOR2I( 0, 0 ) );
+
+        for( int jj = first + 1; jj <= last; ++jj )
+            box.Merge( aPts[jj == aPointCount ? 0 : jj] );
+    }
+
+    m_levels.push_back( std::move( leaves ) );
+
+    while( m_levels.back().size() > (size_t) BRANCHING )
+    {
+        const std::vector<BOX2I>& below = m_levels.back();
+        std::vector<BOX2I>        level( ( below.size() + BRANCHING - 1 ) / BRANCHING );
+
+        for( size_t ii = 0; ii < below.size(); ++ii )
+        {
+            if( ii % BRANCHING == 0 )
+                level[ii / BRANCHING] = below[ii];
+            else
+                level[ii / BRANCHING].Merge( below[ii] );
+        }
+
+        m_levels.push_back( std::move( level ) );
+    }
+}
+
+
+void SEGMENT_BVH::Move( const VECTOR2I& aVector )
+{
+    for( std::vector<BOX2I>& level : m_levels )
+    {
+        for( BOX2I& box : level )
+            box.Move( aVector );
+    }
+}
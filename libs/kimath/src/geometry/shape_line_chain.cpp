@@ -29,6 +29,7 @@
 
 #include <clipper.hpp>
 #include <geometry/seg.h>    // for SEG, OPT_VECTOR2I
+#include <geometry/seg_distance_kernels.h>
 #include <geometry/shape_line_chain.h>
 #include <math/box2.h>       // for BOX2I
 #include <math/util.h>  // for rescale
@@ -45,6 +46,47 @@ SHAPE_LINE_CHAIN::SHAPE_LINE_CHAIN( const std::vector<int>& aV)
     }
 }
 
+
+SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::operator=( const SHAPE_LINE_CHAIN& aOther )
+{
+    if( &aOther == this )
+        return *this;
+
+    invalidateBVH();
+
+    m_points = aOther.m_points;
+    m_shapes = aOther.m_shapes;
+    m_arcs = aOther.m_arcs;
+    m_closed = aOther.m_closed;
+    m_width = aOther.m_width;
+    m_bbox = aOther.m_bbox;
+
+    return *this;
+}
+
+
+const SEGMENT_BVH* SHAPE_LINE_CHAIN::GetSegmentBVH() const
+{
+    // Only build the boxes once the chain has been queried a few times without being edited,
+    // so that one-off queries and chains which are edited between queries don't pay for them.
+    const int minQueries = 4;
+
+    if( SegmentCount() < SEGMENT_BVH::MIN_SEGMENTS )
+        return nullptr;
+
+    SEGMENT_BVH* bvh = m_bvh.load( std::memory_order_acquire );
+
+    // Only the query which reaches the count builds the boxes; concurrent queries test every
+    // segment until they are published.
+    if( bvh || m_bvhQueries.fetch_add( 1, std::memory_order_relaxed ) != minQueries )
+        return bvh;
+
+    bvh = new SEGMENT_BVH( m_points.data(), PointCount(), SegmentCount() );
+    m_bvh.store( bvh, std::memory_order_release );
+
+    return bvh;
+}
+
 ClipperLib::Path SHAPE_LINE_CHAIN::convertToClipper( bool aRequiredOrientation ) const
 {
     ClipperLib::Path c_path;
@@ -103,25 +145,32 @@ bool SHAPE_LINE_CHAIN_BASE::Collide( const VECTOR2I& aP, int aClearance, int* aA
     SEG::ecoord clearance_sq = SEG::Square( aClearance );
     VECTOR2I nearest;
 
-    for( int i = 0; i < GetSegmentCount(); i++ )
-    {
-        const SEG& s = GetSegment( i );
-        VECTOR2I pn = s.NearestPoint( aP );
-        SEG::ecoord dist_sq = ( pn - aP ).SquaredEuclideanNorm();
+    // The kernels skip segments which can't be the nearest one.  Without aActual the walk
+    // stops at the first segment within the clearance, so those must all be visited.
+    SEG::ecoord always_visit_sq = aActual ? 0 : clearance_sq;
 
-        if( dist_sq < closest_dist_sq )
-        {
-            nearest = pn;
-            closest_dist_sq = dist_sq;
+    SegKernelForEachCandidate( aP, *this, closest_dist_sq,
+            [&]( int i ) -> bool
+            {
+                const SEG& s = GetSegment( i );
+                VECTOR2I pn = s.NearestPoint( aP );
+                SEG::ecoord dist_sq = ( pn - aP ).SquaredEuclideanNorm();
 
-            if( closest_dist_sq == 0 )
-                break;
+                if( dist_sq < closest_dist_sq )
+                {
+                    nearest = pn;
+                    closest_dist_sq = dist_sq;
 
-            // If we're not looking for aActual then any collision will do
-            if( closest_dist_sq < clearance_sq && !aActual )
-                break;
-        }
-    }
+                    if( closest_dist_sq == 0 )
+                        return false;
+
+                    // If we're not looking for aActual then any collision will do
+                    if( closest_dist_sq < clearance_sq && !aActual )
+                        return false;
+                }
+
+                return true;
+            }, always_visit_sq );
 
     if( closest_dist_sq == 0 || closest_dist_sq < clearance_sq )
     {
@@ -140,6 +189,8 @@ bool SHAPE_LINE_CHAIN_BASE::Collide( const VECTOR2I& aP, int aClearance, int* aA
 
 void SHAPE_LINE_CHAIN::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
+    invalidateBVH();
+
     for( auto& pt : m_points )
     {
         pt -= aCenter;
@@ -170,26 +221,31 @@ bool SHAPE_LINE_CHAIN_BASE::Collide( const SEG& aSeg, int aClearance, int* aActu
     SEG::ecoord clearance_sq = SEG::Square( aClearance );
     VECTOR2I nearest;
 
-    for( int i = 0; i < GetSegmentCount(); i++ )
-    {
-        const SEG& s = GetSegment( i );
-        SEG::ecoord dist_sq =s.SquaredDistance( aSeg );
+    SEG::ecoord always_visit_sq = aActual ? 0 : clearance_sq;
 
-        if( dist_sq < closest_dist_sq )
-        {
-            if( aLocation )
-                nearest = s.NearestPoint( aSeg );
+    SegKernelForEachCandidate( aSeg, *this, closest_dist_sq,
+            [&]( int i ) -> bool
+            {
+                const SEG& s = GetSegment( i );
+                SEG::ecoord dist_sq =s.SquaredDistance( aSeg );
 
-            closest_dist_sq = dist_sq;
+                if( dist_sq < closest_dist_sq )
+                {
+                    if( aLocation )
+                        nearest = s.NearestPoint( aSeg );
 
-            if( closest_dist_sq == 0)
-                break;
+                    closest_dist_sq = dist_sq;
 
-            // If we're not looking for aActual then any collision will do
-            if( closest_dist_sq < clearance_sq && !aActual )
-                break;
-        }
-    }
+                    if( closest_dist_sq == 0)
+                        return false;
+
+                    // If we're not looking for aActual then any collision will do
+                    if( closest_dist_sq < clearance_sq && !aActual )
+                        return false;
+                }
+
+                return true;
+            }, always_visit_sq );
 
     if( closest_dist_sq == 0 || closest_dist_sq < clearance_sq )
     {
@@ -240,6 +296,8 @@ long long int SHAPE_LINE_CHAIN::Length() const
 
 void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
+    invalidateBVH();
+
     for( auto& pt : m_points )
     {
         if( aX )
@@ -256,6 +314,8 @@ void SHAPE_LINE_CHAIN::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I& aP )
 {
+    invalidateBVH();
+
     if( aEndIndex < 0 )
         aEndIndex += PointCount();
 
@@ -287,6 +347,8 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const VECTOR2I&
 
 void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE_CHAIN& aLine )
 {
+    invalidateBVH();
+
     if( aEndIndex < 0 )
         aEndIndex += PointCount();
 
@@ -312,6 +374,8 @@ void SHAPE_LINE_CHAIN::Replace( int aStartIndex, int aEndIndex, const SHAPE_LINE
 
 void SHAPE_LINE_CHAIN::Remove( int aStartIndex, int aEndIndex )
 {
+    invalidateBVH();
+
     assert( m_shapes.size() == m_points.size() );
     if( aEndIndex < 0 )
         aEndIndex += PointCount();
@@ -354,8 +418,12 @@ SEG::ecoord SHAPE_LINE_CHAIN_BASE::SquaredDistance( const VECTOR2I& aP, bool aOu
     if( IsClosed() && PointInside( aP ) && !aOutlineOnly )
         return 0;
 
-    for( int s = 0; s < GetSegmentCount(); s++ )
-        d = std::min( d, GetSegment( s ).SquaredDistance( aP ) );
+    SegKernelForEachCandidate( aP, *this, d,
+            [&]( int s ) -> bool
+            {
+                d = std::min( d, GetSegment( s ).SquaredDistance( aP ) );
+                return true;
+            } );
 
     return d;
 }
@@ -390,6 +458,7 @@ int SHAPE_LINE_CHAIN::Split( const VECTOR2I& aP )
 
     if( ii >= 0 )
     {
+        invalidateBVH();
         m_points.insert( m_points.begin() + ii + 1, aP );
         m_shapes.insert( m_shapes.begin() + ii + 1, ssize_t( SHAPE_IS_PT ) );
 
@@ -439,6 +508,8 @@ const SHAPE_LINE_CHAIN SHAPE_LINE_CHAIN::Slice( int aStartIndex, int aEndIndex )
 
 void SHAPE_LINE_CHAIN::Append( const SHAPE_LINE_CHAIN& aOtherLine )
 {
+    invalidateBVH();
+
     assert( m_shapes.size() == m_points.size() );
 
     if( aOtherLine.PointCount() == 0 )
@@ -476,6 +547,8 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_LINE_CHAIN& aOtherLine )
 
 void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
 {
+    invalidateBVH();
+
     auto& chain = aArc.ConvertToPolyline();
 
     for( auto& pt : chain.CPoints() )
@@ -492,6 +565,8 @@ void SHAPE_LINE_CHAIN::Append( const SHAPE_ARC& aArc )
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 {
+    invalidateBVH();
+
     if( m_shapes[aVertex] != SHAPE_IS_PT )
         convertArc( aVertex );
 
@@ -504,6 +579,8 @@ void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const VECTOR2I& aP )
 
 void SHAPE_LINE_CHAIN::Insert( size_t aVertex, const SHAPE_ARC& aArc )
 {
+    invalidateBVH();
+
     if( m_shapes[aVertex] != SHAPE_IS_PT )
         convertArc( aVertex );
 
@@ -686,19 +763,45 @@ bool SHAPE_LINE_CHAIN_BASE::PointInside( const VECTOR2I& aPt, int aAccuracy,
      */
     int pointCount = GetPointCount();
 
-    for( int i = 0; i < pointCount; )
-    {
-        const auto p1 = GetPoint( i++ );
-        const auto p2 = GetPoint( i == pointCount ? 0 : i );
-        const auto diff = p2 - p1;
+    auto crossEdges =
+            [&]( int aFirst, int aLast ) -> bool
+            {
+                for( int i = aFirst; i < aLast; )
+                {
+                    const auto p1 = GetPoint( i++ );
+                    const auto p2 = GetPoint( i == pointCount ? 0 : i );
+                    const auto diff = p2 - p1;
 
-        if( diff.y != 0 )
-        {
-            const int d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
+                    if( diff.y != 0 )
+                    {
+                        const int d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
 
-            if( ( ( p1.y > aPt.y ) != ( p2.y > aPt.y ) ) && ( aPt.x - p1.x < d ) )
-                inside = !inside;
-        }
+                        if( ( ( p1.y > aPt.y ) != ( p2.y > aPt.y ) ) && ( aPt.x - p1.x < d ) )
+                            inside = !inside;
+                    }
+                }
+
+                return true;
+            };
+
+    if( const SEGMENT_BVH* bvh = GetSegmentBVH() )
+    {
+        // Only edges straddling the line, with an end right of the point, can cross the line
+        // right of the point.
+        bvh->ForEachRun(
+                [&]( const BOX2I& aBox ) -> bool
+                {
+                    return aBox.GetY() > aPt.y || aBox.GetBottom() <= aPt.y
+                           || aBox.GetRight() <= aPt.x;
+                },
+                [&]( int aFirst, int aCount ) -> bool
+                {
+                    return crossEdges( aFirst, aFirst + aCount );
+                } );
+    }
+    else
+    {
+        crossEdges( 0, pointCount );
     }
 
     // If accuracy is <= 1 (nm) then we skip the accuracy test for performance.  Otherwise
@@ -726,18 +829,46 @@ int SHAPE_LINE_CHAIN_BASE::EdgeContainingPoint( const VECTOR2I& aPt, int aAccura
 	    return ( hypot( dist.x, dist.y ) <= aAccuracy + 1 ) ? 0 : -1;
     }
 
-    for( int i = 0; i < GetSegmentCount(); i++ )
-    {
-        const SEG s = GetSegment( i );
+    int found = -1;
+
+    auto findEdge =
+            [&]( int aFirst, int aLast ) -> bool
+            {
+                for( int i = aFirst; i < aLast; i++ )
+                {
+                    const SEG s = GetSegment( i );
 
-        if( s.A == aPt || s.B == aPt )
-            return i;
+                    if( s.A == aPt || s.B == aPt || s.Distance( aPt ) <= aAccuracy + 1 )
+                    {
+                        found = i;
+                        return false;
+                    }
+                }
 
-        if( s.Distance( aPt ) <= aAccuracy + 1 )
-            return i;
+                return true;
+            };
+
+    if( const SEGMENT_BVH* bvh = GetSegmentBVH() )
+    {
+        // SEG::Distance() can be a couple of units short of the true distance
+        double reach = double( aAccuracy ) + 3;
+
+        bvh->ForEachRun(
+                [&]( const BOX2I& aBox ) -> bool
+                {
+                    return SegKernelSquaredDistance( aBox, aPt ) > reach * reach;
+                },
+                [&]( int aFirst, int aCount ) -> bool
+                {
+                    return findEdge( aFirst, aFirst + aCount );
+                } );
+    }
+    else
+    {
+        findEdge( 0, GetSegmentCount() );
     }
 
-    return -1;
+    return found;
 }
 
 
@@ -814,6 +945,8 @@ const OPT<SHAPE_LINE_CHAIN::INTERSECTION> SHAPE_LINE_CHAIN::SelfIntersecting() c
 
 SHAPE_LINE_CHAIN& SHAPE_LINE_CHAIN::Simplify()
 {
+    invalidateBVH();
+
     std::vector<VECTOR2I> pts_unique;
     std::vector<ssize_t> shapes_unique;
 
@@ -1016,6 +1149,8 @@ SHAPE* SHAPE_LINE_CHAIN::Clone() const
 
 bool SHAPE_LINE_CHAIN::Parse( std::stringstream& aStream )
 {
+    invalidateBVH();
+
     size_t n_pts;
     size_t n_arcs;
 
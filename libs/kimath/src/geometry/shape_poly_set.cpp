@@ -30,11 +30,16 @@
 #include <assert.h>                          // for assert
 #include <cmath>                             // for sqrt, cos, hypot, isinf
 #include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
 #include <istream>                           // for operator<<, operator>>
 #include <limits>                            // for numeric_limits
+#include <map>
 #include <memory>
 #include <set>
 #include <string>                            // for char_traits, operator!=
+#include <thread>
 #include <type_traits>                       // for swap, move
 #include <unordered_set>
 #include <vector>
@@ -43,6 +48,7 @@
 #include <geometry/geometry_utils.h>
 #include <geometry/polygon_triangulation.h>
 #include <geometry/seg.h>                    // for SEG, OPT_VECTOR2I
+#include <geometry/seg_distance_kernels.h>
 #include <geometry/shape.h>
 #include <geometry/shape_line_chain.h>
 #include <geometry/shape_poly_set.h>
@@ -57,6 +63,27 @@
 
 using namespace ClipperLib;
 
+/**
+ * Triangulations are shared between copies of a set, like the polygons: returns one of the
+ * caller's own to change, copying it if it is shared.
+ */
+static SHAPE_POLY_SET::TRIANGULATED_POLYGON& editTriangulation(
+        std::shared_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>& aTriangulation )
+{
+    if( aTriangulation.use_count() > 1 )
+    {
+        aTriangulation = std::make_shared<SHAPE_POLY_SET::TRIANGULATED_POLYGON>( *aTriangulation );
+    }
+    else
+    {
+        // As in POLYSET_STORAGE::Edit()
+        std::atomic_thread_fence( std::memory_order_acquire );
+    }
+
+    return *aTriangulation;
+}
+
+
 SHAPE_POLY_SET::SHAPE_POLY_SET() :
     SHAPE( SH_POLY_SET )
 {
@@ -75,12 +102,11 @@ SHAPE_POLY_SET::SHAPE_POLY_SET( const SHAPE_POLY_SET& aOther ) :
 {
     if( aOther.IsTriangulationUpToDate() )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
-
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
+        m_triangulationSources = aOther.m_triangulationSources;
+        m_triangulationPartitioned = aOther.m_triangulationPartitioned;
     }
     else
     {
@@ -159,7 +185,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
         for( unsigned int polygonIdx = 0; polygonIdx < selectedPolygon; polygonIdx++ )
         {
-            currentPolygon = Polygon( polygonIdx );
+            currentPolygon = CPolygon( polygonIdx );
 
             for( unsigned int contourIdx = 0; contourIdx < currentPolygon.size(); contourIdx++ )
             {
@@ -167,7 +193,7 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
             }
         }
 
-        currentPolygon = Polygon( selectedPolygon );
+        currentPolygon = CPolygon( selectedPolygon );
 
         for( unsigned int contourIdx = 0; contourIdx < selectedContour; contourIdx++ )
         {
@@ -187,18 +213,22 @@ bool SHAPE_POLY_SET::GetGlobalIndex( SHAPE_POLY_SET::VERTEX_INDEX aRelativeIndic
 
 int SHAPE_POLY_SET::NewOutline()
 {
+    invalidateContainsIndex();
+
     SHAPE_LINE_CHAIN empty_path;
     POLYGON poly;
 
     empty_path.SetClosed( true );
     poly.push_back( empty_path );
-    m_polys.push_back( poly );
+    m_polys.Edit().push_back( poly );
     return m_polys.size() - 1;
 }
 
 
 int SHAPE_POLY_SET::NewHole( int aOutline )
 {
+    invalidateContainsIndex();
+
     SHAPE_LINE_CHAIN empty_path;
 
     empty_path.SetClosed( true );
@@ -208,7 +238,7 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
         aOutline += m_polys.size();
 
     // Add hole to the selected outline
-    m_polys[aOutline].push_back( empty_path );
+    m_polys.Edit()[aOutline].push_back( empty_path );
 
     return m_polys.back().size() - 2;
 }
@@ -216,6 +246,8 @@ int SHAPE_POLY_SET::NewHole( int aOutline )
 
 int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDuplication )
 {
+    invalidateContainsIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -231,7 +263,7 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
     assert( aOutline < (int) m_polys.size() );
     assert( idx < (int) m_polys[aOutline].size() );
 
-    m_polys[aOutline][idx].Append( x, y, aAllowDuplication );
+    m_polys.Edit()[aOutline][idx].Append( x, y, aAllowDuplication );
 
     return m_polys[aOutline][idx].PointCount();
 }
@@ -239,6 +271,8 @@ int SHAPE_POLY_SET::Append( int x, int y, int aOutline, int aHole, bool aAllowDu
 
 void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
 {
+    invalidateContainsIndex();
+
     VERTEX_INDEX index;
 
     if( aGlobalIndex < 0 )
@@ -252,7 +286,7 @@ void SHAPE_POLY_SET::InsertVertex( int aGlobalIndex, VECTOR2I aNewVertex )
     {
         // Assure the position to be inserted exists; throw an exception otherwise
         if( GetRelativeIndices( aGlobalIndex, &index ) )
-            m_polys[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
+            m_polys.Edit()[index.m_polygon][index.m_contour].Insert( index.m_vertex, aNewVertex );
         else
             throw( std::out_of_range( "aGlobalIndex-th vertex does not exist" ) );
     }
@@ -292,7 +326,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Subset( int aFirstPolygon, int aLastPolygon )
 
     for( int index = aFirstPolygon; index < aLastPolygon; index++ )
     {
-        newPolySet.m_polys.push_back( Polygon( index ) );
+        newPolySet.m_polys.Edit().push_back( CPolygon( index ) );
     }
 
     return newPolySet;
@@ -424,13 +458,15 @@ bool SHAPE_POLY_SET::IsSelfIntersecting() const
 
 int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 {
+    invalidateContainsIndex();
+
     assert( aOutline.IsClosed() );
 
     POLYGON poly;
 
     poly.push_back( aOutline );
 
-    m_polys.push_back( poly );
+    m_polys.Edit().push_back( poly );
 
     return m_polys.size() - 1;
 }
@@ -438,6 +474,8 @@ int SHAPE_POLY_SET::AddOutline( const SHAPE_LINE_CHAIN& aOutline )
 
 int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 {
+    invalidateContainsIndex();
+
     assert( m_polys.size() );
 
     if( aOutline < 0 )
@@ -445,7 +483,7 @@ int SHAPE_POLY_SET::AddHole( const SHAPE_LINE_CHAIN& aHole, int aOutline )
 
     assert( aOutline < (int)m_polys.size() );
 
-    POLYGON& poly = m_polys[aOutline];
+    POLYGON& poly = m_polys.Edit()[aOutline];
 
     assert( poly.size() );
 
@@ -471,13 +509,13 @@ void SHAPE_POLY_SET::booleanOp( ClipperLib::ClipType aType,
 
     c.StrictlySimple( aFastMode == PM_STRICTLY_SIMPLE );
 
-    for( auto poly : aShape.m_polys )
+    for( const POLYGON& poly : aShape.m_polys )
     {
         for( size_t i = 0 ; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), ptSubject, true );
     }
 
-    for( auto poly : aOtherShape.m_polys )
+    for( const POLYGON& poly : aOtherShape.m_polys )
     {
         for( size_t i = 0; i < poly.size(); i++ )
             c.AddPath( poly[i].convertToClipper( i == 0 ), ptClip, true );
@@ -627,7 +665,9 @@ void SHAPE_POLY_SET::Inflate( int aAmount, int aCircleSegmentsCount,
 
 void SHAPE_POLY_SET::importTree( PolyTree* tree )
 {
-    m_polys.clear();
+    invalidateContainsIndex();
+
+    m_polys = POLYSET();
 
     for( PolyNode* n = tree->GetFirst(); n; n = n->GetNext() )
     {
@@ -640,7 +680,7 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
             for( unsigned int i = 0; i < n->Childs.size(); i++ )
                 paths.push_back( n->Childs[i]->Contour );
 
-            m_polys.push_back( paths );
+            m_polys.Edit().push_back( paths );
         }
     }
 }
@@ -648,18 +688,12 @@ void SHAPE_POLY_SET::importTree( PolyTree* tree )
 
 struct FractureEdge
 {
-    FractureEdge( int y = 0 ) :
-        m_connected( false ),
-        m_next( NULL )
-    {
-        m_p1.x = m_p2.y = y;
-    }
-
-    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2 ) :
+    FractureEdge( bool connected, const VECTOR2I& p1, const VECTOR2I& p2, int index ) :
         m_connected( connected ),
         m_p1( p1 ),
         m_p2( p2 ),
-        m_next( NULL )
+        m_next( NULL ),
+        m_index( index )
     {
     }
 
@@ -668,62 +702,204 @@ struct FractureEdge
         return ( y >= m_p1.y || y >= m_p2.y ) && ( y <= m_p1.y || y <= m_p2.y );
     }
 
+    /**
+     * @return the x coordinate at which the horizontal line at y crosses the edge, or the
+     * right-hand end of a horizontal edge.
+     */
+    int intersectX( int y ) const
+    {
+        if( m_p1.y == m_p2.y ) // horizontal edge
+            return std::max( m_p1.x, m_p2.x );
+
+        return m_p1.x + rescale( m_p2.x - m_p1.x, y - m_p1.y, m_p2.y - m_p1.y );
+    }
+
     bool m_connected;
     VECTOR2I m_p1, m_p2;
     FractureEdge* m_next;
+    int m_index;            ///< Creation order, which breaks ties between equally near edges
 };
 
 
-typedef std::vector<FractureEdge*> FractureEdgeSet;
+/// Edges never move once created, as they are linked to each other
+typedef std::deque<FractureEdge> FractureEdgeSet;
 
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+/**
+ * Finds the nearest connected edge to the left of a point.  The edges are listed in the
+ * horizontal bands they overlap, sorted by their left-most x, so a query only looks at the
+ * edges of one band that start left of the point, and stops once no edge further left can
+ * reach as far as the nearest one found.
+ *
+ * Edges are only ever shortened by processEdge(), so the bands and bounds recorded when the
+ * index is built still hold them; the edges processEdge() adds are listed unsorted.
+ */
+class FRACTURE_INDEX
 {
-    int x   = edge->m_p1.x;
-    int y   = edge->m_p1.y;
-    int min_dist    = std::numeric_limits<int>::max();
-    int x_nearest   = 0;
+public:
+    FRACTURE_INDEX( FractureEdgeSet& aEdges )
+    {
+        const int edgesPerBand = 4;
 
-    FractureEdge* e_nearest = NULL;
+        int64_t heights = 0;
 
-    for( FractureEdge* e : edges )
-    {
-        if( !e->matches( y ) )
-            continue;
+        m_minY = std::numeric_limits<int>::max();
+        m_maxY = std::numeric_limits<int>::min();
+
+        for( const FractureEdge& e : aEdges )
+        {
+            m_minY = std::min<int64_t>( { m_minY, e.m_p1.y, e.m_p2.y } );
+            m_maxY = std::max<int64_t>( { m_maxY, e.m_p1.y, e.m_p2.y } );
+            heights += std::abs( int64_t( e.m_p2.y ) - e.m_p1.y );
+        }
 
-        int x_intersect;
+        // Bands about as high as an edge, so that most edges are listed in one or two
+        int64_t range = m_maxY - m_minY + 1;
+        int64_t height = std::max<int64_t>( 1, heights / std::max<size_t>( 1, aEdges.size() ) );
 
-        if( e->m_p1.y == e->m_p2.y ) // horizontal edge
+        m_count = std::max<int64_t>( 1, std::min<int64_t>( range / height,
+                                                           aEdges.size() / edgesPerBand ) );
+        m_bands.resize( m_count );
+
+        for( FractureEdge& e : aEdges )
         {
-            x_intersect = std::max( e->m_p1.x, e->m_p2.x );
+            int first = bandOf( std::min( e.m_p1.y, e.m_p2.y ) );
+            int last = bandOf( std::max( e.m_p1.y, e.m_p2.y ) );
+
+            for( int band = first; band <= last; ++band )
+            {
+                m_bands[band].m_sorted.push_back( { std::min( e.m_p1.x, e.m_p2.x ),
+                                                    std::max( e.m_p1.x, e.m_p2.x ),
+                                                    &e } );
+            }
         }
-        else
+
+        for( BAND& band : m_bands )
         {
-            x_intersect = e->m_p1.x + rescale( e->m_p2.x - e->m_p1.x, y - e->m_p1.y,
-                                               e->m_p2.y - e->m_p1.y );
+            std::sort( band.m_sorted.begin(), band.m_sorted.end(),
+                       []( const ENTRY& aA, const ENTRY& aB )
+                       {
+                           return aA.m_minX < aB.m_minX;
+                       } );
+
+            // Turn the right-most x of each entry into that of all the entries up to it
+            for( size_t ii = 1; ii < band.m_sorted.size(); ++ii )
+            {
+                band.m_sorted[ii].m_maxX = std::max( band.m_sorted[ii].m_maxX,
+                                                     band.m_sorted[ii - 1].m_maxX );
+            }
         }
+    }
+
+    void Add( FractureEdge* aEdge )
+    {
+        int first = bandOf( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) );
+        int last = bandOf( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( int band = first; band <= last; ++band )
+            m_bands[band].m_added.push_back( aEdge );
+    }
+
+    /**
+     * Same as testing every connected edge crossing the horizontal line at aPt.y, and keeping
+     * the first one found at the smallest distance to the left of aPt.
+     *
+     * @param aXIntersect is set to the x coordinate at which the line meets the edge.
+     * @return the edge, or NULL if there is none.
+     */
+    FractureEdge* FindNearest( const VECTOR2I& aPt, int& aXIntersect ) const
+    {
+        const BAND&   band = m_bands[bandOf( aPt.y )];
+        FractureEdge* nearest = NULL;
 
-        int dist = ( x - x_intersect );
+        auto test =
+                [&]( FractureEdge* aEdge )
+                {
+                    if( !aEdge->m_connected || !aEdge->matches( aPt.y ) )
+                        return;
 
-        if( dist >= 0 && dist < min_dist && e->m_connected )
+                    int x_intersect = aEdge->intersectX( aPt.y );
+
+                    if( x_intersect > aPt.x )
+                        return;
+
+                    if( !nearest || x_intersect > aXIntersect
+                            || ( x_intersect == aXIntersect && aEdge->m_index < nearest->m_index ) )
+                    {
+                        nearest = aEdge;
+                        aXIntersect = x_intersect;
+                    }
+                };
+
+        // Edges starting right of the point can't cross the line left of it
+        auto end = std::upper_bound( band.m_sorted.begin(), band.m_sorted.end(), aPt.x,
+                                     []( int aX, const ENTRY& aEntry )
+                                     {
+                                         return aX < aEntry.m_minX;
+                                     } );
+
+        for( auto it = end; it != band.m_sorted.begin(); )
         {
-            min_dist    = dist;
-            x_nearest   = x_intersect;
-            e_nearest   = e;
+            --it;
+
+            if( nearest && it->m_maxX < aXIntersect )
+                break;
+
+            test( it->m_edge );
         }
+
+        for( FractureEdge* edge : band.m_added )
+            test( edge );
+
+        return nearest;
     }
 
-    if( e_nearest && e_nearest->m_connected )
+private:
+    struct ENTRY
     {
-        int count = 0;
+        int           m_minX;
+        int           m_maxX;       ///< Right-most x of this and all the entries before it
+        FractureEdge* m_edge;
+    };
+
+    struct BAND
+    {
+        std::vector<ENTRY>         m_sorted;
+        std::vector<FractureEdge*> m_added;
+    };
 
-        FractureEdge* lead1 = new FractureEdge( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ) );
-        FractureEdge* lead2 = new FractureEdge( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ) );
-        FractureEdge* split_2 = new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
+    int bandOf( int64_t aY ) const
+    {
+        aY = std::max( m_minY, std::min( m_maxY, aY ) );
+
+        return ( aY - m_minY ) * m_count / ( m_maxY - m_minY + 1 );
+    }
+
+    int64_t           m_minY;
+    int64_t           m_maxY;
+    int64_t           m_count;
+    std::vector<BAND> m_bands;
+};
 
-        edges.push_back( split_2 );
-        edges.push_back( lead1 );
-        edges.push_back( lead2 );
+
+static int processEdge( FractureEdgeSet& edges, FRACTURE_INDEX& index, FractureEdge* edge )
+{
+    int x   = edge->m_p1.x;
+    int y   = edge->m_p1.y;
+    int x_nearest   = 0;
+
+    FractureEdge* e_nearest = index.FindNearest( edge->m_p1, x_nearest );
+
+    if( e_nearest )
+    {
+        int count = 0;
+
+        edges.emplace_back( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2, edges.size() );
+        FractureEdge* split_2 = &edges.back();
+        edges.emplace_back( true, VECTOR2I( x_nearest, y ), VECTOR2I( x, y ), edges.size() );
+        FractureEdge* lead1 = &edges.back();
+        edges.emplace_back( true, VECTOR2I( x, y ), VECTOR2I( x_nearest, y ), edges.size() );
+        FractureEdge* lead2 = &edges.back();
 
         FractureEdge* link = e_nearest->m_next;
 
@@ -731,6 +907,10 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         e_nearest->m_next = lead1;
         lead1->m_next = edge;
 
+        index.Add( split_2 );
+        index.Add( lead1 );
+        index.Add( lead2 );
+
         FractureEdge* last;
 
         for( last = edge; last->m_next != edge; last = last->m_next )
@@ -754,7 +934,7 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
     FractureEdgeSet edges;
-    FractureEdgeSet border_edges;
+    std::vector<FractureEdge*> border_edges;
     FractureEdge*   root = NULL;
 
     bool first = true;
@@ -783,8 +963,9 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         {
             // Do not use path.CPoint() here; open-coding it using the local variables "points"
             // and "pointCount" gives a non-trivial performance boost to zone fill times.
-            FractureEdge* fe = new FractureEdge( first, points[ i ],
-                                                        points[ i+1 == pointCount ? 0 : i+1 ] );
+            edges.emplace_back( first, points[ i ], points[ i+1 == pointCount ? 0 : i+1 ],
+                                edges.size() );
+            FractureEdge* fe = &edges.back();
 
             if( !root )
                 root = fe;
@@ -799,7 +980,6 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
                 fe->m_next = first_edge;
 
             prev = fe;
-            edges.push_back( fe );
 
             if( !first )
             {
@@ -814,26 +994,24 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         first = false;    // first path is always the outline
     }
 
-    // keep connecting holes to the main outline, until there's no holes left...
-    while( num_unconnected > 0 )
-    {
-        int x_min = std::numeric_limits<int>::max();
-
-        FractureEdge* smallestX = NULL;
+    FRACTURE_INDEX index( edges );
 
-        // find the left-most hole edge and merge with the outline
-        for( FractureEdge* border_edge : border_edges )
-        {
-            int xt = border_edge->m_p1.x;
+    // Sweep left to right, connecting each hole at its left-most edge to the outline (or an
+    // already connected hole), until there's no holes left.  A hole may have several left-most
+    // edges; once one of them is connected, so are the others.
+    std::stable_sort( border_edges.begin(), border_edges.end(),
+                      []( const FractureEdge* aA, const FractureEdge* aB )
+                      {
+                          return aA->m_p1.x < aB->m_p1.x;
+                      } );
 
-            if( ( xt < x_min ) && !border_edge->m_connected )
-            {
-                x_min = xt;
-                smallestX = border_edge;
-            }
-        }
+    for( FractureEdge* border_edge : border_edges )
+    {
+        if( num_unconnected == 0 )
+            break;
 
-        num_unconnected -= processEdge( edges, smallestX );
+        if( !border_edge->m_connected )
+            num_unconnected -= processEdge( edges, index, border_edge );
     }
 
     paths.clear();
@@ -848,18 +1026,17 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.Append( e->m_p1 );
 
-    for( FractureEdge* edge : edges )
-        delete edge;
-
     paths.push_back( std::move( newPath ) );
 }
 
 
 void SHAPE_POLY_SET::Fracture( POLYGON_MODE aFastMode )
 {
+    invalidateContainsIndex();
+
     Simplify( aFastMode );    // remove overlapping holes/degeneracy
 
-    for( POLYGON& paths : m_polys )
+    for( POLYGON& paths : m_polys.Edit() )
     {
         fractureSingle( paths );
     }
@@ -1044,7 +1221,9 @@ bool SHAPE_POLY_SET::HasHoles() const
 
 void SHAPE_POLY_SET::Unfracture( POLYGON_MODE aFastMode )
 {
-    for( POLYGON& path : m_polys )
+    invalidateContainsIndex();
+
+    for( POLYGON& path : m_polys.Edit() )
     {
         unfractureSingle( path );
     }
@@ -1061,14 +1240,114 @@ void SHAPE_POLY_SET::Simplify( POLYGON_MODE aFastMode )
 }
 
 
+void SHAPE_POLY_SET::BatchUnion( POLYGON_MODE aFastMode, size_t aMaxThreads )
+{
+    invalidateContainsIndex();
+
+    // Below this there is nothing to gain from splitting the work
+    const size_t minBatchSize = 64;
+
+    size_t threadCount = aMaxThreads ? aMaxThreads : std::thread::hardware_concurrency();
+    threadCount = std::max<size_t>( 1, threadCount );
+
+    if( threadCount == 1 || m_polys.size() < 2 * minBatchSize )
+    {
+        Simplify( aFastMode );
+        return;
+    }
+
+    struct ITEM
+    {
+        VECTOR2I m_centre;
+        int      m_index;
+    };
+
+    std::vector<ITEM> items;
+    items.reserve( m_polys.size() );
+
+    for( size_t ii = 0; ii < m_polys.size(); ++ii )
+    {
+        if( !m_polys[ii].empty() )
+            items.push_back( { m_polys[ii][0].BBox().Centre(), (int) ii } );
+    }
+
+    // Split until there are a few batches per thread, so that uneven batches even out
+    size_t batchSize = std::max( minBatchSize, items.size() / ( 4 * threadCount ) );
+    int    parallelDepth = 0;
+
+    // Each level above parallelDepth hands one half to a new thread, so 2^parallelDepth
+    // threads work at once; keep that within threadCount.
+    while( ( (size_t) 2 << parallelDepth ) <= threadCount )
+        parallelDepth++;
+
+    std::function<SHAPE_POLY_SET( size_t, size_t, int )> merge =
+            [&]( size_t aFirst, size_t aLast, int aDepth ) -> SHAPE_POLY_SET
+            {
+                SHAPE_POLY_SET result;
+
+                if( aLast - aFirst <= batchSize )
+                {
+                    for( size_t ii = aFirst; ii < aLast; ++ii )
+                        result.m_polys.Edit().push_back( m_polys[ items[ii].m_index ] );
+
+                    result.Simplify( aFastMode );
+                    return result;
+                }
+
+                // Bisect across the longer side of the items' extents, so each half covers
+                // a compact area and the halves overlap as little as possible
+                BOX2I extents( items[aFirst].m_centre );
+
+                for( size_t ii = aFirst + 1; ii < aLast; ++ii )
+                    extents.Merge( items[ii].m_centre );
+
+                bool   splitX = extents.GetWidth() >= extents.GetHeight();
+                size_t mid = ( aFirst + aLast ) / 2;
+
+                std::nth_element( items.begin() + aFirst, items.begin() + mid,
+                                  items.begin() + aLast,
+                                  [splitX]( const ITEM& a, const ITEM& b )
+                                  {
+                                      return splitX ? a.m_centre.x < b.m_centre.x
+                                                    : a.m_centre.y < b.m_centre.y;
+                                  } );
+
+                SHAPE_POLY_SET other;
+
+                if( aDepth < parallelDepth )
+                {
+                    std::future<SHAPE_POLY_SET> firstHalf =
+                            std::async( std::launch::async, merge, aFirst, mid, aDepth + 1 );
+
+                    other = merge( mid, aLast, aDepth + 1 );
+                    result = firstHalf.get();
+                }
+                else
+                {
+                    result = merge( aFirst, mid, aDepth + 1 );
+                    other = merge( mid, aLast, aDepth + 1 );
+                }
+
+                result.BooleanAdd( other, aFastMode );
+                return result;
+            };
+
+    SHAPE_POLY_SET merged = merge( 0, items.size(), 0 );
+
+    m_polys = std::move( merged.m_polys );
+}
+
+
 int SHAPE_POLY_SET::NormalizeAreaOutlines()
 {
+    invalidateContainsIndex();
+
     // We are expecting only one main outline, but this main outline can have holes
     // if holes: combine holes and remove them from the main outline.
     // Note also we are using SHAPE_POLY_SET::PM_STRICTLY_SIMPLE in polygon
     // calculations, but it is not mandatory. It is used mainly
     // because there is usually only very few vertices in area outlines
-    SHAPE_POLY_SET::POLYGON& outline = Polygon( 0 );
+    SHAPE_POLY_SET::POLYGON& outline = m_polys.Edit()[0];
     SHAPE_POLY_SET holesBuffer;
 
     // Move holes stored in outline to holesBuffer:
@@ -1127,6 +1406,8 @@ const std::string SHAPE_POLY_SET::Format() const
 
 bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
 {
+    invalidateContainsIndex();
+
     std::string tmp;
 
     aStream >> tmp;
@@ -1177,7 +1458,7 @@ bool SHAPE_POLY_SET::Parse( std::stringstream& aStream )
             paths.push_back( outline );
         }
 
-        m_polys.push_back( paths );
+        m_polys.Edit().push_back( paths );
     }
 
     return true;
@@ -1356,22 +1637,30 @@ bool SHAPE_POLY_SET::Collide( const SHAPE* aShape, int aClearance, int* aActual,
 
 void SHAPE_POLY_SET::RemoveAllContours()
 {
-    m_polys.clear();
+    invalidateContainsIndex();
+
+    m_polys = POLYSET();
 }
 
 
 void SHAPE_POLY_SET::RemoveContour( int aContourIdx, int aPolygonIdx )
 {
+    invalidateContainsIndex();
+
     // Default polygon is the last one
     if( aPolygonIdx < 0 )
         aPolygonIdx += m_polys.size();
 
-    m_polys[aPolygonIdx].erase( m_polys[aPolygonIdx].begin() + aContourIdx );
+    POLYGON& polygon = m_polys.Edit()[aPolygonIdx];
+
+    polygon.erase( polygon.begin() + aContourIdx );
 }
 
 
 int SHAPE_POLY_SET::RemoveNullSegments()
 {
+    invalidateContainsIndex();
+
     int removed = 0;
 
     ITERATOR iterator = IterateWithHoles();
@@ -1425,13 +1714,21 @@ int SHAPE_POLY_SET::RemoveNullSegments()
 
 void SHAPE_POLY_SET::DeletePolygon( int aIdx )
 {
-    m_polys.erase( m_polys.begin() + aIdx );
+    invalidateContainsIndex();
+
+    POLYSET& polys = m_polys.Edit();
+
+    polys.erase( polys.begin() + aIdx );
 }
 
 
 void SHAPE_POLY_SET::Append( const SHAPE_POLY_SET& aSet )
 {
-    m_polys.insert( m_polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
+    invalidateContainsIndex();
+
+    POLYSET& polys = m_polys.Edit();
+
+    polys.insert( polys.end(), aSet.m_polys.begin(), aSet.m_polys.end() );
 }
 
 
@@ -1511,12 +1808,10 @@ bool SHAPE_POLY_SET::CollideEdge( const VECTOR2I& aPoint,
 
 void SHAPE_POLY_SET::BuildBBoxCaches()
 {
-    for( int polygonIdx = 0; polygonIdx < OutlineCount(); polygonIdx++ )
+    for( POLYGON& poly : m_polys.Edit() )
     {
-        Outline( polygonIdx ).GenerateBBoxCache();
-
-        for( int holeIdx = 0; holeIdx < HoleCount( polygonIdx ); holeIdx++ )
-            Hole( polygonIdx, holeIdx ).GenerateBBoxCache();
+        for( SHAPE_LINE_CHAIN& path : poly )
+            path.GenerateBBoxCache();
     }
 }
 
@@ -1556,7 +1851,9 @@ void SHAPE_POLY_SET::RemoveVertex( int aGlobalIndex )
 
 void SHAPE_POLY_SET::RemoveVertex( VERTEX_INDEX aIndex )
 {
-    m_polys[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
+    invalidateContainsIndex();
+
+    m_polys.Edit()[aIndex.m_polygon][aIndex.m_contour].Remove( aIndex.m_vertex );
 }
 
 
@@ -1573,24 +1870,302 @@ void SHAPE_POLY_SET::SetVertex( int aGlobalIndex, const VECTOR2I& aPos )
 
 void SHAPE_POLY_SET::SetVertex( const VERTEX_INDEX& aIndex, const VECTOR2I& aPos )
 {
-    m_polys[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
+    invalidateContainsIndex();
+
+    m_polys.Edit()[aIndex.m_polygon][aIndex.m_contour].SetPoint( aIndex.m_vertex, aPos );
+}
+
+
+/**
+ * Splits the vertical extent of each large outline and hole into horizontal bands, and lists
+ * the edges overlapping each band.  A horizontal ray from a point can only cross the edges of
+ * the point's band, so PointInside() only needs to test those, and gives the same answer as
+ * SHAPE_LINE_CHAIN_BASE::PointInside() testing every edge.
+ */
+class SHAPE_POLY_SET::CONTAINS_INDEX
+{
+public:
+    /// Chains with fewer points are quicker to test directly
+    static const int MIN_POINTS = 32;
+
+    /// Checksum of the polygons the index was built from
+    const MD5_HASH m_checksum;
+
+    CONTAINS_INDEX( const SHAPE_POLY_SET& aSet ) :
+            m_checksum( aSet.Checksum() )
+    {
+        m_chains.resize( aSet.m_polys.size() );
+
+        for( size_t ii = 0; ii < aSet.m_polys.size(); ++ii )
+        {
+            m_chains[ii].resize( aSet.m_polys[ii].size() );
+
+            for( size_t jj = 0; jj < aSet.m_polys[ii].size(); ++jj )
+                buildBands( aSet.m_polys[ii][jj], m_chains[ii][jj] );
+        }
+    }
+
+    /**
+     * Equivalent to aChain.PointInside( aPt, aAccuracy ), where aChain is the aContour-th
+     * contour of the aPolygon-th polygon of the indexed set.
+     */
+    bool PointInside( const SHAPE_LINE_CHAIN& aChain, int aPolygon, int aContour,
+                      const VECTOR2I& aPt, int aAccuracy ) const
+    {
+        if( aPolygon >= (int) m_chains.size() || aContour >= (int) m_chains[aPolygon].size() )
+            return aChain.PointInside( aPt, aAccuracy );
+
+        const BANDS& bands = m_chains[aPolygon][aContour];
+
+        if( bands.m_count == 0 || bands.m_pointCount != aChain.PointCount() )
+            return aChain.PointInside( aPt, aAccuracy );
+
+        if( !aChain.IsClosed() || aChain.PointCount() < 3 )
+            return false;
+
+        const std::vector<VECTOR2I>& pts = aChain.CPoints();
+        int                          pointCount = pts.size();
+        bool                         inside = false;
+
+        if( aPt.y >= bands.m_minY && aPt.y <= bands.m_maxY )
+        {
+            int band = bandOf( bands, aPt.y );
+
+            for( int ii = bands.m_start[band]; ii < bands.m_start[band + 1]; ++ii )
+            {
+                int             edge = bands.m_edges[ii];
+                const VECTOR2I& p1 = pts[edge];
+                const VECTOR2I& p2 = pts[edge + 1 == pointCount ? 0 : edge + 1];
+                const VECTOR2I  diff = p2 - p1;
+
+                if( diff.y != 0 )
+                {
+                    const int d = rescale( diff.x, ( aPt.y - p1.y ), diff.y );
+
+                    if( ( ( p1.y > aPt.y ) != ( p2.y > aPt.y ) ) && ( aPt.x - p1.x < d ) )
+                        inside = !inside;
+                }
+            }
+        }
+
+        if( aAccuracy <= 1 || inside )
+            return inside;
+
+        // Only edges within aAccuracy + 1 of the point can count as containing it.  Allow for
+        // SEG::Distance() rounding and truncating.
+        int64_t reach = int64_t( aAccuracy ) + 3;
+        int64_t top = std::max<int64_t>( int64_t( aPt.y ) - reach, bands.m_minY );
+        int64_t bottom = std::min<int64_t>( int64_t( aPt.y ) + reach, bands.m_maxY );
+
+        if( top > bottom )
+            return false;
+
+        int firstBand = bandOf( bands, top );
+        int lastBand = bandOf( bands, bottom );
+
+        if( lastBand - firstBand > bands.m_count / 4 )
+            return aChain.PointOnEdge( aPt, aAccuracy );
+
+        for( int band = firstBand; band <= lastBand; ++band )
+        {
+            for( int ii = bands.m_start[band]; ii < bands.m_start[band + 1]; ++ii )
+            {
+                int       edge = bands.m_edges[ii];
+                const SEG s( pts[edge], pts[edge + 1 == pointCount ? 0 : edge + 1] );
+
+                if( s.A == aPt || s.B == aPt || s.Distance( aPt ) <= aAccuracy + 1 )
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    struct BANDS
+    {
+        int              m_pointCount = 0;
+        int              m_count = 0;       ///< Number of bands, or 0 if the chain isn't indexed
+        int64_t          m_minY = 0;
+        int64_t          m_maxY = 0;
+        std::vector<int> m_start;           ///< Offset in m_edges of each band's edges
+        std::vector<int> m_edges;           ///< Indices of the first vertex of each edge
+    };
+
+    static int bandOf( const BANDS& aBands, int64_t aY )
+    {
+        return ( aY - aBands.m_minY ) * aBands.m_count / ( aBands.m_maxY - aBands.m_minY + 1 );
+    }
+
+    static void buildBands( const SHAPE_LINE_CHAIN& aChain, BANDS& aBands )
+    {
+        const int pointsPerBand = 4;
+        const int maxBands = 4096;
+
+        const std::vector<VECTOR2I>& pts = aChain.CPoints();
+        int                          pointCount = pts.size();
+
+        aBands.m_pointCount = pointCount;
+
+        if( pointCount < MIN_POINTS )
+            return;
+
+        aBands.m_minY = aBands.m_maxY = pts[0].y;
+
+        for( const VECTOR2I& pt : pts )
+        {
+            aBands.m_minY = std::min<int64_t>( aBands.m_minY, pt.y );
+            aBands.m_maxY = std::max<int64_t>( aBands.m_maxY, pt.y );
+        }
+
+        aBands.m_count = std::min( maxBands, pointCount / pointsPerBand );
+
+        // Counting sort of the edges into the bands they overlap
+        std::vector<int> counts( aBands.m_count + 1, 0 );
+
+        auto forEachEdgeBand =
+                [&]( const std::function<void( int, int )>& aFunc )
+                {
+                    for( int ii = 0; ii < pointCount; ++ii )
+                    {
+                        int y1 = pts[ii].y;
+                        int y2 = pts[ii + 1 == pointCount ? 0 : ii + 1].y;
+                        int first = bandOf( aBands, std::min( y1, y2 ) );
+                        int last = bandOf( aBands, std::max( y1, y2 ) );
+
+                        for( int band = first; band <= last; ++band )
+                            aFunc( ii, band );
+                    }
+                };
+
+        forEachEdgeBand( [&]( int aEdge, int aBand )
+                         {
+                             counts[aBand + 1]++;
+                         } );
+
+        for( int band = 0; band < aBands.m_count; ++band )
+            counts[band + 1] += counts[band];
+
+        aBands.m_start = counts;
+        aBands.m_edges.resize( counts.back() );
+
+        forEachEdgeBand( [&]( int aEdge, int aBand )
+                         {
+                             aBands.m_edges[counts[aBand]++] = aEdge;
+                         } );
+    }
+
+    std::vector<std::vector<BANDS>> m_chains;
+};
+
+
+/// States of SHAPE_POLY_SET::m_containsIndexState
+enum CONTAINS_INDEX_STATE
+{
+    CONTAINS_INDEX_VERIFIED = 0,
+    CONTAINS_INDEX_SUSPECT,         ///< the polygons may have changed since the index was built
+    CONTAINS_INDEX_VERIFYING
+};
+
+
+std::shared_ptr<const SHAPE_POLY_SET::CONTAINS_INDEX> SHAPE_POLY_SET::containsIndex() const
+{
+    // Only build the index once the set has been queried a few times without being edited,
+    // so that one-off queries and sets which are edited between queries don't pay for it.
+    const int minQueries = 8;
+
+    std::shared_ptr<const CONTAINS_INDEX> index = std::atomic_load( &m_containsIndex );
+
+    if( index )
+    {
+        int state = m_containsIndexState.load( std::memory_order_acquire );
+
+        if( state == CONTAINS_INDEX_VERIFIED )
+            return index;
+
+        // Only one query checks a suspect index; concurrent ones use the plain tests meanwhile.
+        if( state != CONTAINS_INDEX_SUSPECT
+                || !m_containsIndexState.compare_exchange_strong( state,
+                                                                  CONTAINS_INDEX_VERIFYING ) )
+        {
+            return nullptr;
+        }
+
+        if( index->m_checksum != Checksum() )
+        {
+            index = nullptr;
+            std::atomic_store( &m_containsIndex, index );
+            m_containsQueries = 0;
+        }
+
+        m_containsIndexState.store( CONTAINS_INDEX_VERIFIED, std::memory_order_release );
+        return index;
+    }
+
+    // Only the query which reaches the count builds the index; concurrent queries use the
+    // plain tests until it is published.
+    if( m_containsQueries.fetch_add( 1, std::memory_order_relaxed ) != minQueries )
+        return nullptr;
+
+    bool worthwhile = false;
+
+    for( const POLYGON& poly : m_polys )
+    {
+        for( const SHAPE_LINE_CHAIN& chain : poly )
+            worthwhile |= chain.PointCount() >= CONTAINS_INDEX::MIN_POINTS;
+    }
+
+    if( !worthwhile )
+        return nullptr;
+
+    index = std::make_shared<CONTAINS_INDEX>( *this );
+    m_containsIndexState.store( CONTAINS_INDEX_VERIFIED, std::memory_order_relaxed );
+    std::atomic_store( &m_containsIndex, index );
+
+    return index;
+}
+
+
+void SHAPE_POLY_SET::invalidateContainsIndex()
+{
+    std::atomic_store( &m_containsIndex, std::shared_ptr<const CONTAINS_INDEX>() );
+    m_containsIndexState = CONTAINS_INDEX_VERIFIED;
+    m_containsQueries = 0;
+}
+
+
+void SHAPE_POLY_SET::suspectContainsIndex()
+{
+    if( std::atomic_load( &m_containsIndex ) )
+        m_containsIndexState = CONTAINS_INDEX_SUSPECT;
 }
 
 
 bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int aAccuracy,
                                      bool aUseBBoxCaches ) const
 {
+    std::shared_ptr<const CONTAINS_INDEX> index = containsIndex();
+
+    auto pointInside =
+            [&]( int aContour, int aContourAccuracy ) -> bool
+            {
+                const SHAPE_LINE_CHAIN& chain = m_polys[aSubpolyIndex][aContour];
+
+                if( index )
+                    return index->PointInside( chain, aSubpolyIndex, aContour, aP, aContourAccuracy );
+
+                return chain.PointInside( aP, aContourAccuracy, aContour > 0 && aUseBBoxCaches );
+            };
+
     // Check that the point is inside the outline
-    if( m_polys[aSubpolyIndex][0].PointInside( aP, aAccuracy ) )
+    if( pointInside( 0, aAccuracy ) )
     {
         // Check that the point is not in any of the holes
         for( int holeIdx = 0; holeIdx < HoleCount( aSubpolyIndex ); holeIdx++ )
         {
-            const SHAPE_LINE_CHAIN& hole = CHole( aSubpolyIndex, holeIdx );
-
             // If the point is inside a hole it is outside of the polygon.  Do not use aAccuracy
             // here as it's meaning would be inverted.
-            if( hole.PointInside( aP, 1, aUseBBoxCaches ) )
+            if( pointInside( holeIdx + 1, 1 ) )
                 return false;
         }
 
@@ -1603,22 +2178,29 @@ bool SHAPE_POLY_SET::containsSingle( const VECTOR2I& aP, int aSubpolyIndex, int
 
 void SHAPE_POLY_SET::Move( const VECTOR2I& aVector )
 {
-    for( POLYGON& poly : m_polys )
+    invalidateContainsIndex();
+
+    for( POLYGON& poly : m_polys.Edit() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Move( aVector );
     }
 
-    for( auto& tri : m_triangulatedPolys )
-        tri->Move( aVector );
+    for( std::shared_ptr<TRIANGULATED_POLYGON>& tri : m_triangulatedPolys )
+        editTriangulation( tri ).Move( aVector );
+
+    for( TRIANGULATION_SOURCE& source : m_triangulationSources )
+        source.m_anchor += aVector;
 
-    m_hash = checksum();
+    m_hash = Checksum();
 }
 
 
 void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 {
-    for( POLYGON& poly : m_polys )
+    invalidateContainsIndex();
+
+    for( POLYGON& poly : m_polys.Edit() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
         {
@@ -1630,7 +2212,9 @@ void SHAPE_POLY_SET::Mirror( bool aX, bool aY, const VECTOR2I& aRef )
 
 void SHAPE_POLY_SET::Rotate( double aAngle, const VECTOR2I& aCenter )
 {
-    for( POLYGON& poly : m_polys )
+    invalidateContainsIndex();
+
+    for( POLYGON& poly : m_polys.Edit() )
     {
         for( SHAPE_LINE_CHAIN& path : poly )
             path.Rotate( aAngle, aCenter );
@@ -1684,21 +2268,31 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( VECTOR2I aPoint, int aPoly
         return 0;
     }
 
-    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
-
-    SEG::ecoord minDistance = (*iterator).SquaredDistance( aPoint );
+    SEG::ecoord minDistance = VECTOR2I::ECOORD_MAX;
 
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+    // Walk the outline and then the holes; the kernels skip segments which can't be the
+    // nearest one.
+    for( const SHAPE_LINE_CHAIN& chain : m_polys[aPolygonIndex] )
     {
-        SEG::ecoord currentDistance = (*iterator).SquaredDistance( aPoint );
+        bool done = !SegKernelForEachCandidate( aPoint, chain, minDistance,
+                [&]( int aIndex ) -> bool
+                {
+                    SEG         seg = chain.CSegment( aIndex );
+                    SEG::ecoord currentDistance = seg.SquaredDistance( aPoint );
 
-        if( currentDistance < minDistance )
-        {
-            if( aNearest )
-                *aNearest = (*iterator).NearestPoint( aPoint );
+                    if( currentDistance < minDistance )
+                    {
+                        if( aNearest )
+                            *aNearest = seg.NearestPoint( aPoint );
 
-            minDistance = currentDistance;
-        }
+                        minDistance = currentDistance;
+                    }
+
+                    return minDistance > 0;
+                } );
+
+        if( done )
+            break;
     }
 
     return minDistance;
@@ -1720,20 +2314,29 @@ SEG::ecoord SHAPE_POLY_SET::SquaredDistanceToPolygon( const SEG& aSegment, int a
         return 0;
     }
 
-    CONST_SEGMENT_ITERATOR iterator = CIterateSegmentsWithHoles( aPolygonIndex );
-    SEG::ecoord            minDistance = (*iterator).SquaredDistance( aSegment );
+    SEG::ecoord minDistance = VECTOR2I::ECOORD_MAX;
 
-    for( iterator++; iterator && minDistance > 0; iterator++ )
+    for( const SHAPE_LINE_CHAIN& chain : m_polys[aPolygonIndex] )
     {
-        SEG::ecoord currentDistance = (*iterator).SquaredDistance( aSegment );
+        bool done = !SegKernelForEachCandidate( aSegment, chain, minDistance,
+                [&]( int aIndex ) -> bool
+                {
+                    SEG         seg = chain.CSegment( aIndex );
+                    SEG::ecoord currentDistance = seg.SquaredDistance( aSegment );
 
-        if( currentDistance < minDistance )
-        {
-            if( aNearest )
-                *aNearest = (*iterator).NearestPoint( aSegment );
+                    if( currentDistance < minDistance )
+                    {
+                        if( aNearest )
+                            *aNearest = seg.NearestPoint( aSegment );
 
-            minDistance = currentDistance;
-        }
+                        minDistance = currentDistance;
+                    }
+
+                    return minDistance > 0;
+                } );
+
+        if( done )
+            break;
     }
 
     // Return the maximum of minDistance and zero
@@ -1809,7 +2412,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Chamfer( int aDistance )
     SHAPE_POLY_SET chamfered;
 
     for( unsigned int idx = 0; idx < m_polys.size(); idx++ )
-        chamfered.m_polys.push_back( ChamferPolygon( aDistance, idx ) );
+        chamfered.m_polys.Edit().push_back( ChamferPolygon( aDistance, idx ) );
 
     return chamfered;
 }
@@ -1820,7 +2423,7 @@ SHAPE_POLY_SET SHAPE_POLY_SET::Fillet( int aRadius, int aErrorMax )
     SHAPE_POLY_SET filleted;
 
     for( size_t idx = 0; idx < m_polys.size(); idx++ )
-        filleted.m_polys.push_back( FilletPolygon( aRadius, aErrorMax, idx ) );
+        filleted.m_polys.Edit().push_back( FilletPolygon( aRadius, aErrorMax, idx ) );
 
     return filleted;
 }
@@ -1832,7 +2435,7 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
     // Null segments create serious issues in calculations. Remove them:
     RemoveNullSegments();
 
-    SHAPE_POLY_SET::POLYGON currentPoly = Polygon( aIndex );
+    SHAPE_POLY_SET::POLYGON currentPoly = CPolygon( aIndex );
     SHAPE_POLY_SET::POLYGON newPoly;
 
     // If the chamfering distance is zero, then the polygon remain intact.
@@ -1990,27 +2593,30 @@ SHAPE_POLY_SET::POLYGON SHAPE_POLY_SET::chamferFilletPolygon( CORNER_MODE aMode,
 SHAPE_POLY_SET &SHAPE_POLY_SET::operator=( const SHAPE_POLY_SET& aOther )
 {
     static_cast<SHAPE&>(*this) = aOther;
+    invalidateContainsIndex();
     m_polys = aOther.m_polys;
-    m_triangulatedPolys.clear();
     m_triangulationValid = false;
 
     if( aOther.IsTriangulationUpToDate() )
     {
-        for( unsigned i = 0; i < aOther.TriangulatedPolyCount(); i++ )
-            m_triangulatedPolys.push_back(
-                    std::make_unique<TRIANGULATED_POLYGON>( *aOther.TriangulatedPolygon( i ) ) );
-
+        m_triangulatedPolys = aOther.m_triangulatedPolys;
         m_hash = aOther.GetHash();
         m_triangulationValid = true;
+        m_triangulationSources = aOther.m_triangulationSources;
+        m_triangulationPartitioned = aOther.m_triangulationPartitioned;
     }
 
+    // Otherwise the old triangulation is kept, though no longer valid: CacheTriangulation()
+    // takes over the parts of it made from polygons that are still there, such as the islands
+    // of a zone which a refill didn't change.
+
     return *this;
 }
 
 MD5_HASH SHAPE_POLY_SET::GetHash() const
 {
     if( !m_hash.IsValid() )
-        return checksum();
+        return Checksum();
 
     return m_hash;
 }
@@ -2024,7 +2630,7 @@ bool SHAPE_POLY_SET::IsTriangulationUpToDate() const
     if( !m_hash.IsValid() )
         return false;
 
-    auto hash = checksum();
+    auto hash = Checksum();
 
     return hash == m_hash;
 }
@@ -2099,69 +2705,268 @@ static void partitionPolyIntoRegularCellGrid(
 }
 
 
-void SHAPE_POLY_SET::CacheTriangulation( bool aPartition )
+/**
+ * Hashes the shape of a polygon with its holes, whatever its position.
+ * @param aAnchor is set to the first vertex of the outline, to which the points are hashed
+ *                relative.
+ */
+static MD5_HASH polygonShapeHash( const SHAPE_POLY_SET::POLYGON& aPoly, VECTOR2I& aAnchor )
 {
-    bool recalculate = !m_hash.IsValid();
     MD5_HASH hash;
 
-    if( !m_triangulationValid )
-        recalculate = true;
+    aAnchor = VECTOR2I( 0, 0 );
+
+    if( !aPoly.empty() && aPoly[0].PointCount() > 0 )
+        aAnchor = aPoly[0].CPoint( 0 );
+
+    hash.Hash( aPoly.size() );
 
-    if( !recalculate )
+    for( const SHAPE_LINE_CHAIN& lc : aPoly )
     {
-        hash = checksum();
+        hash.Hash( lc.PointCount() );
 
-        if( m_hash != hash )
+        for( const VECTOR2I& pt : lc.CPoints() )
         {
-            m_hash = hash;
-            recalculate = true;
+            hash.Hash( pt.x - aAnchor.x );
+            hash.Hash( pt.y - aAnchor.y );
         }
     }
 
-    if( !recalculate )
-        return;
+    hash.Finalize();
 
+    return hash;
+}
+
+
+/**
+ * Triangulates the polygons of aPolySet, appending the result to aResult.
+ * @return false if the triangulation of the last part failed.
+ */
+static bool triangulate( const SHAPE_POLY_SET& aPolySet, bool aPartition,
+                         std::vector<std::shared_ptr<SHAPE_POLY_SET::TRIANGULATED_POLYGON>>& aResult )
+{
     SHAPE_POLY_SET tmpSet;
 
     if( aPartition )
         // This partitions into regularly-sized grids (1cm in pcbnew)
-        partitionPolyIntoRegularCellGrid( *this, 1e7, tmpSet );
+        partitionPolyIntoRegularCellGrid( aPolySet, 1e7, tmpSet );
     else
-    {
-        tmpSet = *this;
+        tmpSet = aPolySet;
 
-        if( tmpSet.HasHoles() )
-            tmpSet.Fracture( PM_FAST );
-    }
+    // Polygons smaller than a cell come back from the partitioning as they were
+    if( tmpSet.HasHoles() )
+        tmpSet.Fracture( SHAPE_POLY_SET::PM_FAST );
 
-    m_triangulatedPolys.clear();
-    m_triangulationValid = true;
+    bool valid = true;
 
     while( tmpSet.OutlineCount() > 0 )
     {
-        m_triangulatedPolys.push_back( std::make_unique<TRIANGULATED_POLYGON>() );
-        PolygonTriangulation tess( *m_triangulatedPolys.back() );
+        aResult.push_back( std::make_shared<SHAPE_POLY_SET::TRIANGULATED_POLYGON>() );
+        PolygonTriangulation tess( *aResult.back() );
 
         // If the tesselation fails, we re-fracture the polygon, which will
         // first simplify the system before fracturing and removing the holes
         // This may result in multiple, disjoint polygons.
         if( !tess.TesselatePolygon( tmpSet.Polygon( 0 ).front() ) )
         {
-            tmpSet.Fracture( PM_FAST );
-            m_triangulationValid = false;
+            tmpSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+            valid = false;
             continue;
         }
 
         tmpSet.DeletePolygon( 0 );
-        m_triangulationValid = true;
+        valid = true;
     }
 
-    if( m_triangulationValid )
-        m_hash = checksum();
+    return valid;
+}
+
+
+void SHAPE_POLY_SET::CacheTriangulation( bool aPartition )
+{
+    CacheTriangulations( { this }, aPartition );
+}
+
+
+void SHAPE_POLY_SET::CacheTriangulations( const std::vector<SHAPE_POLY_SET*>& aSets,
+                                          bool aPartition )
+{
+    typedef std::vector<std::shared_ptr<TRIANGULATED_POLYGON>> PARTS;
+
+    struct POLYGON_TRIANGULATION
+    {
+        TRIANGULATION_SOURCE m_source;
+        PARTS                m_parts;
+        bool                 m_valid = true;
+        SHAPE_POLY_SET       m_polygon;     ///< the polygon alone, when it must be triangulated
+        int                  m_vertexCount = 0;
+    };
+
+    struct SET_TRIANGULATION
+    {
+        SHAPE_POLY_SET*                    m_set;
+        MD5_HASH                           m_hash;
+        std::vector<POLYGON_TRIANGULATION> m_polygons;
+    };
+
+    // A deque, so that adding entries leaves those already there in place
+    std::deque<SET_TRIANGULATION> updates;
+
+    for( SHAPE_POLY_SET* set : aSets )
+    {
+        MD5_HASH hash = set->Checksum();
+
+        if( set->m_triangulationValid && set->m_hash.IsValid() && set->m_hash == hash )
+            continue;
+
+        // Sort out what's left of the last triangulation by the polygon each part came from
+        std::vector<PARTS>               oldParts;
+        std::multimap<MD5_HASH, size_t>  oldPartsByShape;
+        size_t                           oldPartCount = 0;
+
+        for( const TRIANGULATION_SOURCE& source : set->m_triangulationSources )
+            oldPartCount += source.m_partCount;
+
+        if( set->m_triangulationPartitioned == aPartition
+                && oldPartCount == set->m_triangulatedPolys.size() )
+        {
+            auto part = set->m_triangulatedPolys.begin();
+
+            for( const TRIANGULATION_SOURCE& source : set->m_triangulationSources )
+            {
+                oldParts.emplace_back( std::make_move_iterator( part ),
+                                       std::make_move_iterator( part + source.m_partCount ) );
+                part += source.m_partCount;
+
+                if( source.m_shapeHash.IsValid() )
+                    oldPartsByShape.emplace( source.m_shapeHash, oldParts.size() - 1 );
+            }
+        }
+
+        updates.emplace_back();
+
+        SET_TRIANGULATION& update = updates.back();
+
+        update.m_set = set;
+        update.m_hash = hash;
+        update.m_polygons = std::vector<POLYGON_TRIANGULATION>( set->m_polys.size() );
+
+        for( size_t ii = 0; ii < set->m_polys.size(); ++ii )
+        {
+            POLYGON_TRIANGULATION& poly = update.m_polygons[ii];
+
+            poly.m_source.m_shapeHash = polygonShapeHash( set->m_polys[ii], poly.m_source.m_anchor );
+
+            auto reusable = oldPartsByShape.find( poly.m_source.m_shapeHash );
+
+            if( reusable != oldPartsByShape.end() )
+            {
+                const TRIANGULATION_SOURCE& was = set->m_triangulationSources[reusable->second];
+
+                poly.m_parts = std::move( oldParts[reusable->second] );
+
+                if( poly.m_source.m_anchor != was.m_anchor )
+                {
+                    for( std::shared_ptr<TRIANGULATED_POLYGON>& part : poly.m_parts )
+                        editTriangulation( part ).Move( poly.m_source.m_anchor - was.m_anchor );
+                }
+
+                oldPartsByShape.erase( reusable );
+            }
+            else
+            {
+                poly.m_polygon.m_polys.Edit().push_back( set->m_polys[ii] );
+                poly.m_vertexCount = poly.m_polygon.TotalVertices();
+            }
+        }
+
+        // The parts moved out are picked up from the update from now on
+        set->m_triangulatedPolys.clear();
+        set->m_triangulationSources.clear();
+        set->m_triangulationValid = false;
+    }
+
+    std::vector<POLYGON_TRIANGULATION*> jobs;
+    int                                 jobVertexCount = 0;
+
+    for( SET_TRIANGULATION& update : updates )
+    {
+        for( POLYGON_TRIANGULATION& poly : update.m_polygons )
+        {
+            if( poly.m_polygon.OutlineCount() )
+            {
+                jobs.push_back( &poly );
+                jobVertexCount += poly.m_vertexCount;
+            }
+        }
+    }
+
+    // Largest first, so that the threads run out of work at about the same time
+    std::sort( jobs.begin(), jobs.end(),
+               []( const POLYGON_TRIANGULATION* a, const POLYGON_TRIANGULATION* b )
+               {
+                   return a->m_vertexCount > b->m_vertexCount;
+               } );
+
+    // Below this, starting threads costs more than the triangulation itself
+    const int minParallelVertexCount = 1000;
+
+    size_t threadCount = std::min<size_t>( jobs.size(), std::thread::hardware_concurrency() );
+
+    if( jobVertexCount < minParallelVertexCount )
+        threadCount = 1;
+
+    std::atomic<size_t> nextJob( 0 );
+
+    auto triangulateJobs =
+            [&]()
+            {
+                for( size_t ii = nextJob++; ii < jobs.size(); ii = nextJob++ )
+                    jobs[ii]->m_valid = triangulate( jobs[ii]->m_polygon, aPartition,
+                                                     jobs[ii]->m_parts );
+            };
+
+    std::vector<std::future<void>> workers;
+
+    for( size_t ii = 1; ii < threadCount; ++ii )
+        workers.push_back( std::async( std::launch::async, triangulateJobs ) );
+
+    triangulateJobs();
+
+    for( std::future<void>& worker : workers )
+        worker.wait();
+
+    for( SET_TRIANGULATION& update : updates )
+    {
+        SHAPE_POLY_SET* set = update.m_set;
+
+        set->m_triangulatedPolys.clear();
+        set->m_triangulationSources.clear();
+        set->m_triangulationPartitioned = aPartition;
+        set->m_triangulationValid = true;
+        set->m_hash = update.m_hash;
+
+        for( POLYGON_TRIANGULATION& poly : update.m_polygons )
+        {
+            // A failed triangulation is kept, as it is still better than nothing, but never
+            // reused
+            if( !poly.m_valid )
+            {
+                set->m_triangulationValid = false;
+                poly.m_source.m_shapeHash = MD5_HASH();
+            }
+
+            poly.m_source.m_partCount = poly.m_parts.size();
+            set->m_triangulationSources.push_back( poly.m_source );
+
+            for( std::shared_ptr<TRIANGULATED_POLYGON>& part : poly.m_parts )
+                set->m_triangulatedPolys.push_back( std::move( part ) );
+        }
+    }
 }
 
 
-MD5_HASH SHAPE_POLY_SET::checksum() const
+MD5_HASH SHAPE_POLY_SET::Checksum() const
 {
     MD5_HASH hash;
 
@@ -32,7 +32,10 @@
 #include <tools/pcb_tool_base.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <tools/drc_tool.h>
+#include <advanced_config.h>
 
+#include <algorithm>
 #include <functional>
 using namespace std::placeholders;
 
@@ -93,6 +96,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     SELECTION_TOOL*     selTool = m_toolMgr->GetTool<SELECTION_TOOL>();
     bool                itemsDeselected = false;
 
+    // Items to be checked again by the online DRC
+    std::vector<BOARD_ITEM*> changedItems;
+    std::set<KIID>           removedItems;
+
     if( Empty() )
         return;
 
@@ -134,6 +141,36 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
             }
         }
 
+        if( !m_isFootprintEditor )
+        {
+            board->MarkZoneFillsDirty( boardItem );
+
+            if( changeType == CHT_MODIFY && ent.m_copy )
+                board->MarkZoneFillsDirty( static_cast<BOARD_ITEM*>( ent.m_copy ) );
+
+            if( boardItem->Type() != PCB_MARKER_T && boardItem->Type() != PCB_NETINFO_T
+                    && boardItem->Type() != PCB_GROUP_T )
+            {
+                if( changeType != CHT_REMOVE )
+                {
+                    changedItems.push_back( boardItem );
+                }
+                else
+                {
+                    removedItems.insert( boardItem->m_Uuid );
+
+                    if( boardItem->Type() == PCB_MODULE_T )
+                    {
+                        static_cast<MODULE*>( boardItem )->RunOnChildren(
+                                [&]( BOARD_ITEM* aChild )
+                                {
+                                    removedItems.insert( aChild->m_Uuid );
+                                } );
+                    }
+                }
+            }
+        }
+
         switch( changeType )
         {
             case CHT_ADD:
@@ -326,6 +363,9 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
 
                 auto boardItem = static_cast<BOARD_ITEM*>( ent.m_item );
 
+                board->MarkZoneFillsDirty( boardItem );
+                changedItems.push_back( boardItem );
+
                 if( aCreateUndoEntry )
                 {
                     ITEM_PICKER itemWrapper( nullptr, boardItem, UNDO_REDO::CHANGED );
@@ -359,6 +399,21 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     frame->UpdateMsgPanel();
 
     clear();
+
+    if( ADVANCED_CFG::GetCfg().m_OnlineDRC && ( !changedItems.empty() || !removedItems.empty() ) )
+    {
+        DRC_TOOL* drcTool = m_toolMgr->GetTool<DRC_TOOL>();
+
+        changedItems.erase( std::remove_if( changedItems.begin(), changedItems.end(),
+                                            [&]( BOARD_ITEM* aItem )
+                                            {
+                                                return removedItems.count( aItem->m_Uuid ) > 0;
+                                            } ),
+                            changedItems.end() );
+
+        if( drcTool )
+            drcTool->TestChangedItems( changedItems, removedItems );
+    }
 }
 
 
@@ -663,11 +663,23 @@ void D_PAD::TransformShapeWithClearanceToPolygon( SHAPE_POLY_SET& aCornerBuffer,
     case PAD_SHAPE_CUSTOM:
     {
         SHAPE_POLY_SET outline;
-        MergePrimitivesAsPolygon( &outline, aLayer );
+
+        // A positive clearance grows each primitive, which is cheaper than inflating the
+        // merged shape and keeps arcs round
+        if( aClearanceValue > 0 )
+        {
+            MergeInflatedPrimitivesAsPolygon( &outline, aLayer, aClearanceValue, aError,
+                                              aErrorLoc );
+        }
+        else
+        {
+            MergePrimitivesAsPolygon( &outline, aLayer );
+        }
+
         outline.Rotate( -DECIDEG2RAD( m_orient ) );
         outline.Move( VECTOR2I( m_pos ) );
 
-        if( aClearanceValue )
+        if( aClearanceValue < 0 )
         {
             int numSegs = std::max( GetArcToSegmentCount( aClearanceValue, aError, 360.0 ),
                                                           pad_min_seg_per_circle_count );
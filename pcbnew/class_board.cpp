@@ -64,6 +64,7 @@ BOARD::BOARD() :
         m_project( nullptr ),
         m_designSettings( new BOARD_DESIGN_SETTINGS( nullptr, "board.design_settings" ) ),
         m_NetInfo( this ),
+        m_allZoneFillsDirty( true ),
         m_LegacyDesignSettingsLoaded( false ),
         m_LegacyNetclassesLoaded( false )
 {
@@ -641,6 +642,10 @@ void BOARD::Remove( BOARD_ITEM* aBoardItem )
     // find these calls and fix them!  Don't send me no stinking' NULL.
     wxASSERT( aBoardItem );
 
+    // The item's address may be reused; don't let a later item pick up its knockouts.  This
+    // also drops those of a footprint's pads.
+    m_zoneKnockoutCache.Invalidate( aBoardItem );
+
     switch( aBoardItem->Type() )
     {
     case PCB_NETINFO_T:
@@ -1955,6 +1960,51 @@ void BOARD::OnItemChanged( BOARD_ITEM* aItem )
 }
 
 
+void BOARD::MarkZoneFillsDirty( const BOARD_ITEM* aItem )
+{
+    // Also drops the knockouts of a footprint's pads, including any deleted by the change
+    m_zoneKnockoutCache.Invalidate( aItem );
+
+    if( m_allZoneFillsDirty )
+        return;
+
+    LSET layers = aItem->GetLayerSet();
+
+    switch( aItem->Type() )
+    {
+    case PCB_ZONE_AREA_T:
+    case PCB_FP_ZONE_AREA_T:
+        // A zone's own settings affect its fill on all of its layers, copper or not
+        break;
+
+    case PCB_MODULE_T:
+        // Pads of a footprint can be on any copper layer
+        layers = LSET::AllCuMask();
+        break;
+
+    case PCB_NETINFO_T:
+        MarkAllZoneFillsDirty();
+        return;
+
+    case PCB_MARKER_T:
+    case PCB_GROUP_T:
+        return;
+
+    default:
+        // Board edges knock out copper on every layer
+        if( layers.test( Edge_Cuts ) )
+            layers = LSET::AllCuMask();
+        else
+            layers &= LSET::AllCuMask();
+
+        break;
+    }
+
+    if( layers.any() )
+        m_zoneFillDirtyAreas.emplace_back( aItem->GetBoundingBox(), layers );
+}
+
+
 void BOARD::ResetNetHighLight()
 {
     m_highLight.Clear();
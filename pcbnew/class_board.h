@@ -35,6 +35,7 @@
 #include <pcb_plot_params.h>
 #include <title_block.h>
 #include <tools/pcbnew_selection.h>
+#include <zone_knockout_cache.h>
 
 class BOARD_COMMIT;
 class PCB_BASE_FRAME;
@@ -231,6 +232,15 @@ private:
 
     std::vector<BOARD_LISTENER*> m_listeners;
 
+    /// Copper regions (and the layers they affect) changed since the last full zone fill.
+    std::vector<std::pair<EDA_RECT, LSET>> m_zoneFillDirtyAreas;
+
+    /// True if the next zone fill must recompute every zone regardless of m_zoneFillDirtyAreas
+    bool                    m_allZoneFillsDirty;
+
+    /// Knockout polygons of pads, vias and tracks, shared by all zone fills
+    ZONE_KNOCKOUT_CACHE     m_zoneKnockoutCache;
+
     // The default copy constructor & operator= are inadequate,
     // either write one or do not use it at all
     BOARD( const BOARD& aOther ) = delete;
@@ -1128,6 +1138,41 @@ public:
       */
     void OnItemChanged( BOARD_ITEM* aItem );
 
+    /**
+     * Record that \a aItem has been added, removed or changed so that an incremental zone
+     * fill knows which regions of copper need to be recomputed.  Items which cannot affect
+     * a zone fill (such as silkscreen graphics) are ignored.
+     */
+    void MarkZoneFillsDirty( const BOARD_ITEM* aItem );
+
+    /**
+     * Force the next zone fill to recompute every zone.  Used for changes which have no
+     * spatial extent, such as design rule or netclass changes.
+     */
+    void MarkAllZoneFillsDirty()
+    {
+        m_allZoneFillsDirty = true;
+        m_zoneKnockoutCache.Clear();
+    }
+
+    bool AreAllZoneFillsDirty() const { return m_allZoneFillsDirty; }
+
+    const std::vector<std::pair<EDA_RECT, LSET>>& GetZoneFillDirtyAreas() const
+    {
+        return m_zoneFillDirtyAreas;
+    }
+
+    ZONE_KNOCKOUT_CACHE& GetZoneKnockoutCache() { return m_zoneKnockoutCache; }
+
+    /**
+     * Forget all recorded zone fill changes.  To be called once all zones have been refilled.
+     */
+    void ClearZoneFillsDirty()
+    {
+        m_zoneFillDirtyAreas.clear();
+        m_allZoneFillsDirty = false;
+    }
+
     /*
      * Consistency check of internal m_groups structure.
      * @param repair if true, modify groups structure until it passes the sanity check.
@@ -279,6 +279,17 @@ public:
      */
     void MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_ID aLayer ) const;
 
+    /**
+     * Merge all basic shapes, each grown by aInflateValue, to a SHAPE_POLY_SET.
+     * The shapes are built at their inflated size and merged once, which is cheaper and more
+     * accurate than inflating the merged polygon.
+     * Note: The results are relative to the pad position, orientation 0.
+     * @param aInflateValue is the amount to grow the shapes by; it must not be negative.
+     */
+    void MergeInflatedPrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_ID aLayer,
+                                           int aInflateValue, int aError,
+                                           ERROR_LOC aErrorLoc ) const;
+
     /**
      * clear the basic shapes list
      */
@@ -645,7 +656,7 @@ public:
 
 private:
     void addPadPrimitivesToPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_ID aLayer,
-                                    int aError, ERROR_LOC aErrorLoc ) const;
+                                    int aInflateValue, int aError, ERROR_LOC aErrorLoc ) const;
 
 private:
     wxString      m_name;               // Pad name (pin number in schematic)
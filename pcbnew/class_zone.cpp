@@ -1107,8 +1107,7 @@ void ZONE_CONTAINER::CacheTriangulation( PCB_LAYER_ID aLayer )
 {
     if( aLayer == UNDEFINED_LAYER )
     {
-        for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : m_FilledPolysList )
-            pair.second.CacheTriangulation();
+        CacheTriangulations( { this } );
     }
     else
     {
@@ -1118,6 +1117,20 @@ void ZONE_CONTAINER::CacheTriangulation( PCB_LAYER_ID aLayer )
 }
 
 
+void ZONE_CONTAINER::CacheTriangulations( const std::vector<ZONE_CONTAINER*>& aZones )
+{
+    std::vector<SHAPE_POLY_SET*> fills;
+
+    for( ZONE_CONTAINER* zone : aZones )
+    {
+        for( std::pair<const PCB_LAYER_ID, SHAPE_POLY_SET>& pair : zone->m_FilledPolysList )
+            fills.push_back( &pair.second );
+    }
+
+    SHAPE_POLY_SET::CacheTriangulations( fills );
+}
+
+
 bool ZONE_CONTAINER::IsIsland( PCB_LAYER_ID aLayer, int aPolyIdx )
 {
     if( GetNetCode() < 1 )
@@ -637,6 +637,12 @@ public:
      */
     void CacheTriangulation( PCB_LAYER_ID aLayer = UNDEFINED_LAYER );
 
+    /**
+     * Triangulates the filled areas of all layers of several zones, sharing the work out over
+     * all of their islands.
+     */
+    static void CacheTriangulations( const std::vector<ZONE_CONTAINER*>& aZones );
+
    /**
      * Function SetFilledPolysList
      * sets the list of filled polygons.
@@ -438,6 +438,8 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
 
     size *= 2;      // Our caller us gets the other half of the progress bar
 
+    m_itemList.BeginBulkAdd();
+
     for( ZONE_CONTAINER* zone : aBoard->Zones() )
     {
         Add( zone );
@@ -458,11 +460,15 @@ void CN_CONNECTIVITY_ALGO::Build( BOARD* aBoard, PROGRESS_REPORTER* aReporter )
             reportProgress( aReporter, ii++, size, delta );
         }
     }
+
+    m_itemList.EndBulkAdd();
 }
 
 
 void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
+    m_itemList.BeginBulkAdd();
+
     for( auto item : aItems )
     {
         switch( item->Type() )
@@ -488,6 +494,8 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
                 break;
         }
     }
+
+    m_itemList.EndBulkAdd();
 }
 
 
@@ -415,6 +415,7 @@ class CN_LIST
 private:
     bool m_dirty;
     bool m_hasInvalid;
+    bool m_bulkAdding;
 
     CN_RTREE<CN_ITEM*> m_index;
 
@@ -423,7 +424,8 @@ protected:
 
     void addItemtoTree( CN_ITEM* item )
     {
-        m_index.Insert( item );
+        if( !m_bulkAdding )
+            m_index.Insert( item );
     }
 
 public:
@@ -431,6 +433,25 @@ public:
     {
         m_dirty = false;
         m_hasInvalid = false;
+        m_bulkAdding = false;
+    }
+
+    /**
+     * Defers indexing the items added until EndBulkAdd(), which then packs the index in one
+     * pass.  Items added in between are not found by FindNearby().
+     */
+    void BeginBulkAdd()
+    {
+        m_bulkAdding = true;
+    }
+
+    void EndBulkAdd()
+    {
+        if( m_bulkAdding )
+        {
+            m_bulkAdding = false;
+            m_index.BulkLoad( m_items );
+        }
     }
 
     void Clear()
@@ -21,6 +21,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <stack>
+
 #include <bitmaps.h>
 #include <widgets/paged_dialog.h>
 #include <pcb_edit_frame.h>
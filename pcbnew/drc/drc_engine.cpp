@@ -31,6 +31,12 @@
 #include <drc/drc_rule_condition.h>
 #include <drc/drc_test_provider.h>
 #include <class_track.h>
+#include <class_pad.h>
+#include <class_module.h>
+#include <class_zone.h>
+#include <hash_eda.h>
+
+#include <future>
 
 void drcPrintDebugMessage( int level, const wxString& msg, const char *function, int line )
 {
@@ -55,13 +61,16 @@ DRC_ENGINE::DRC_ENGINE( BOARD* aBoard, BOARD_DESIGN_SETTINGS *aSettings ) :
     m_schematicNetlist( nullptr ),
     m_rulesValid( false ),
     m_userUnits( EDA_UNITS::MILLIMETRES ),
+    m_errorLimits( DRCE_LAST + 1 ),
     m_reportAllTrackErrors( false ),
     m_testFootprints( false ),
     m_reporter( nullptr ),
-    m_progressReporter( nullptr )
+    m_progressReporter( nullptr ),
+    m_deferViolations( false ),
+    m_cacheConstraints( false ),
+    m_runThread( std::this_thread::get_id() ),
+    m_incremental( false )
 {
-    m_errorLimits.resize( DRCE_LAST + 1 );
-
     for( int ii = DRCE_FIRST; ii <= DRCE_LAST; ++ii )
         m_errorLimits[ ii ] = INT_MAX;
 }
@@ -566,6 +575,29 @@ void DRC_ENGINE::compileRules()
             }
         }
     }
+
+    m_cacheableConstraints.clear();
+
+    for( const std::pair< const DRC_CONSTRAINT_TYPE_T,
+                          std::vector<CONSTRAINT_WITH_CONDITIONS*>* >& pair : m_constraintMap )
+    {
+        // Disallow constraints depend on the item's layer set and flags
+        if( pair.first == DISALLOW_CONSTRAINT )
+            continue;
+
+        bool cacheable = true;
+
+        for( const CONSTRAINT_WITH_CONDITIONS* c : *pair.second )
+        {
+            if( c->condition && !c->condition->IsCacheable() )
+                cacheable = false;
+        }
+
+        if( cacheable )
+            m_cacheableConstraints.insert( pair.first );
+    }
+
+    clearConstraintCache();
 }
 
 
@@ -598,6 +630,8 @@ void DRC_ENGINE::InitEngine( const wxFileName& aRulePath )
     }
 
     m_constraintMap.clear();
+    m_cacheableConstraints.clear();
+    clearConstraintCache();
 
     try         // attempt to load full set of rules (implicit + user rules)
     {
@@ -635,6 +669,10 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
     m_reportAllTrackErrors = aReportAllTrackErrors;
     m_testFootprints = aTestFootprints;
 
+    m_incremental = false;
+    m_scope.clear();
+    m_scopeBoxes.clear();
+
     if( m_progressReporter )
     {
         int phases = 0;
@@ -648,6 +686,120 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         m_progressReporter->AddPhases( phases );
     }
 
+    runProviders();
+}
+
+
+void DRC_ENGINE::RunIncrementalTests( EDA_UNITS aUnits,
+                                      const std::vector<BOARD_ITEM*>& aChangedItems )
+{
+    m_userUnits = aUnits;
+    m_reportAllTrackErrors = false;
+    m_testFootprints = false;
+
+    m_incremental = true;
+    m_scope.clear();
+    m_scopeBoxes.clear();
+
+    DRC_CONSTRAINT worstClearanceConstraint;
+    int            worstClearance = 0;
+
+    if( QueryWorstConstraint( CLEARANCE_CONSTRAINT, worstClearanceConstraint ) )
+        worstClearance = worstClearanceConstraint.GetValue().Min();
+
+    std::vector<EDA_RECT> neighbourBoxes;
+
+    auto addToScope =
+            [&]( BOARD_ITEM* aItem )
+            {
+                EDA_RECT box = aItem->GetBoundingBox();
+                box.Inflate( worstClearance );
+
+                m_scope.insert( aItem );
+                m_scopeBoxes.push_back( box );
+
+                if( aItem->Type() != PCB_TRACE_T && aItem->Type() != PCB_ARC_T
+                        && aItem->Type() != PCB_VIA_T && aItem->Type() != PCB_PAD_T )
+                {
+                    neighbourBoxes.push_back( box );
+                }
+            };
+
+    auto isNeighbour =
+            [&]( BOARD_ITEM* aItem ) -> bool
+            {
+                EDA_RECT box = aItem->GetBoundingBox();
+
+                for( const EDA_RECT& neighbourBox : neighbourBoxes )
+                {
+                    if( neighbourBox.Intersects( box ) )
+                        return true;
+                }
+
+                return false;
+            };
+
+    for( BOARD_ITEM* item : aChangedItems )
+    {
+        if( item->Type() == PCB_MODULE_T )
+        {
+            MODULE* module = static_cast<MODULE*>( item );
+
+            for( D_PAD* pad : module->Pads() )
+                addToScope( pad );
+
+            for( BOARD_ITEM* child : module->GraphicalItems() )
+                addToScope( child );
+
+            for( ZONE_CONTAINER* zone : module->Zones() )
+                addToScope( zone );
+
+            addToScope( &module->Reference() );
+            addToScope( &module->Value() );
+        }
+
+        addToScope( item );
+    }
+
+    if( !neighbourBoxes.empty() )
+    {
+        for( TRACK* track : m_board->Tracks() )
+        {
+            if( !m_scope.count( track ) && isNeighbour( track ) )
+                addToScope( track );
+        }
+
+        for( MODULE* module : m_board->Modules() )
+        {
+            for( D_PAD* pad : module->Pads() )
+            {
+                if( !m_scope.count( pad ) && isNeighbour( pad ) )
+                    addToScope( pad );
+            }
+        }
+    }
+
+    runProviders();
+}
+
+
+bool DRC_ENGINE::IsNearScope( const EDA_RECT& aBox ) const
+{
+    if( !m_incremental )
+        return true;
+
+    for( const EDA_RECT& scopeBox : m_scopeBoxes )
+    {
+        if( scopeBox.Intersects( aBox ) )
+            return true;
+    }
+
+    return false;
+}
+
+
+void DRC_ENGINE::runProviders()
+{
     for( int ii = DRCE_FIRST; ii < DRCE_LAST; ++ii )
     {
         if( m_designSettings->Ignore( ii ) )
@@ -656,22 +808,29 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
             m_errorLimits[ ii ] = INT_MAX;
     }
 
-    for( ZONE_CONTAINER* zone : m_board->Zones() )
-        zone->CacheBoundingBox();
+    prepareBoardCaches();
+    SetConstraintCaching( true );
 
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( ZONE_CONTAINER* zone : module->Zones() )
-            zone->CacheBoundingBox();
+    std::vector<DRC_TEST_PROVIDER*> concurrentProviders;
 
-        module->BuildPolyCourtyards();
-    }
+    m_runThread = std::this_thread::get_id();
+    m_deferViolations = true;
+    m_pendingViolations.clear();
 
     for( DRC_TEST_PROVIDER* provider : m_testProviders )
     {
         if( !provider->IsEnabled() )
             continue;
 
+        if( m_incremental && !provider->CanRunIncrementally() )
+            continue;
+
+        if( provider->CanRunConcurrently() )
+        {
+            concurrentProviders.push_back( provider );
+            continue;
+        }
+
         drc_dbg( 0, "Running test provider: '%s'\n", provider->GetName() );
 
         ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
@@ -679,6 +838,123 @@ void DRC_ENGINE::RunTests( EDA_UNITS aUnits, bool aReportAllTrackErrors, bool aT
         if( !provider->Run() )
             break;
     }
+
+    if( !m_progressReporter || !m_progressReporter->IsCancelled() )
+        runConcurrentProviders( concurrentProviders );
+
+    SetConstraintCaching( false );
+    flushPendingViolations();
+}
+
+
+void DRC_ENGINE::prepareBoardCaches()
+{
+    DRC_TEST_PROVIDER::InitBasicItemLists();
+
+    // insideArea() collides items with zone outlines, and SHAPE_POLY_SET::Collide()
+    // triangulates on first use.  Do it here, before the concurrent providers can race on it.
+    std::vector<SHAPE_POLY_SET*> outlines;
+
+    for( ZONE_CONTAINER* zone : m_board->Zones() )
+    {
+        zone->CacheBoundingBox();
+        outlines.push_back( zone->Outline() );
+    }
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( ZONE_CONTAINER* zone : module->Zones() )
+        {
+            zone->CacheBoundingBox();
+            outlines.push_back( zone->Outline() );
+        }
+
+        // Courtyards are only tested by a full run
+        if( !m_incremental )
+        {
+            module->BuildPolyCourtyards();
+            module->GetPolyCourtyardFront().BuildBBoxCaches();
+            module->GetPolyCourtyardBack().BuildBBoxCaches();
+        }
+
+        for( D_PAD* pad : module->Pads() )
+        {
+            if( pad->IsDirty() )
+                pad->BuildEffectiveShapes( UNDEFINED_LAYER );
+        }
+    }
+
+    SHAPE_POLY_SET::CacheTriangulations( outlines, true );
+}
+
+
+void DRC_ENGINE::runConcurrentProviders( const std::vector<DRC_TEST_PROVIDER*>& aProviders )
+{
+    std::atomic<size_t> nextProvider( 0 );
+    std::atomic<bool>   cancelled( false );
+
+    auto run_lambda =
+            [&]() -> size_t
+            {
+                size_t num = 0;
+
+                for( size_t i = nextProvider++; i < aProviders.size(); i = nextProvider++ )
+                {
+                    if( cancelled )
+                        break;
+
+                    DRC_TEST_PROVIDER* provider = aProviders[i];
+
+                    drc_dbg( 0, "Running test provider: '%s'\n", provider->GetName() );
+
+                    ReportAux( wxString::Format( "Run DRC provider: '%s'", provider->GetName() ) );
+
+                    // A provider may also return false when it has nothing to test, so only a
+                    // cancellation stops the others
+                    if( !provider->Run() && m_progressReporter
+                            && m_progressReporter->IsCancelled() )
+                    {
+                        cancelled = true;
+                    }
+
+                    num++;
+                }
+
+                return num;
+            };
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   aProviders.size() );
+
+    // Without other threads, run here so that the UI is kept refreshed
+    if( parallelThreadCount <= 1 )
+    {
+        run_lambda();
+        return;
+    }
+
+    std::vector<std::future<size_t>> returns( parallelThreadCount );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        returns[ii] = std::async( std::launch::async, run_lambda );
+
+    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    {
+        // Here we balance returns with a 100ms timeout to allow UI updating
+        std::future_status status;
+        do
+        {
+            if( m_progressReporter )
+            {
+                m_progressReporter->KeepRefreshing();
+
+                if( m_progressReporter->IsCancelled() )
+                    cancelled = true;
+            }
+
+            status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+        } while( status != std::future_status::ready );
+    }
 }
 
 
@@ -712,6 +988,9 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
     bool                        implicit = false;
 
     // Local overrides take precedence
+    // May be called from several providers at once, so no member scratch strings here
+    wxString source;
+
     if( aConstraintId == CLEARANCE_CONSTRAINT )
     {
         int overrideA = 0;
@@ -719,7 +998,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( connectedA && connectedA->GetLocalClearanceOverrides( nullptr ) > 0 )
         {
-            overrideA = connectedA->GetLocalClearanceOverrides( &m_msg );
+            overrideA = connectedA->GetLocalClearanceOverrides( &source );
 
             REPORT( "" )
             REPORT( wxString::Format( _( "Local override on %s; clearance: %s." ),
@@ -729,7 +1008,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( connectedB && connectedB->GetLocalClearanceOverrides( nullptr ) > 0 )
         {
-            overrideB = connectedB->GetLocalClearanceOverrides( &m_msg );
+            overrideB = connectedB->GetLocalClearanceOverrides( &source );
 
             REPORT( "" )
             REPORT( wxString::Format( _( "Local override on %s; clearance: %s." ),
@@ -739,12 +1018,40 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 
         if( overrideA || overrideB )
         {
-            DRC_CONSTRAINT constraint( CLEARANCE_CONSTRAINT, m_msg );
+            DRC_CONSTRAINT constraint( CLEARANCE_CONSTRAINT, source );
             constraint.m_Value.SetMin( std::max( overrideA, overrideB ) );
             return constraint;
         }
     }
 
+    // Resolutions which only depend on the item signatures can be shared between items.  The
+    // reporter needs to see every rule being checked, so it always goes through the rules.
+    bool                    useCache = m_cacheConstraints && !aReporter
+                                            && m_cacheableConstraints.count( aConstraintId );
+    bool                    cached = false;
+    CONSTRAINT_CACHE_KEY    key;
+    CONSTRAINT_CACHE_SHARD* shard = nullptr;
+
+    if( useCache )
+    {
+        key.constraintType = aConstraintId;
+        key.layer = aLayer;
+        key.a = itemSignature( a );
+        key.b = itemSignature( b );
+
+        shard = &m_constraintCache[ CONSTRAINT_CACHE_KEY_HASH()( key ) % m_constraintCache.size() ];
+
+        std::lock_guard<std::mutex> lock( shard->mutex );
+        auto                        it = shard->entries.find( key );
+
+        if( it != shard->entries.end() )
+        {
+            constraintRef = it->second.constraint;
+            implicit = it->second.implicit;
+            cached = true;
+        }
+    }
+
     auto processConstraint =
             [&]( const CONSTRAINT_WITH_CONDITIONS* c ) -> bool
             {
@@ -927,7 +1234,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
                 }
             };
 
-    if( m_constraintMap.count( aConstraintId ) )
+    if( !cached && m_constraintMap.count( aConstraintId ) )
     {
         std::vector<CONSTRAINT_WITH_CONDITIONS*>* ruleset = m_constraintMap[ aConstraintId ];
 
@@ -950,6 +1257,12 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
         }
     }
 
+    if( useCache && !cached )
+    {
+        std::lock_guard<std::mutex> lock( shard->mutex );
+        shard->entries.emplace( key, CONSTRAINT_CACHE_ENTRY{ constraintRef, implicit } );
+    }
+
     // Unfortunately implicit rules don't work for local clearances (such as zones) because
     // they have to be max'ed with netclass values (which are already implicit rules), and our
     // rule selection paradigm is "winner takes all".
@@ -968,7 +1281,7 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
                                       MessageTextFromValue( UNITS, localA ) ) )
 
             if( localA > clearance )
-                clearance = connectedA->GetLocalClearance( &m_msg );
+                clearance = connectedA->GetLocalClearance( &source );
         }
 
         if( localB > 0 )
@@ -979,19 +1292,18 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
                                       MessageTextFromValue( UNITS, localB ) ) )
 
             if( localB > clearance )
-                clearance = connectedB->GetLocalClearance( &m_msg );
+                clearance = connectedB->GetLocalClearance( &source );
         }
 
         if( localA > global || localB > global )
         {
-            DRC_CONSTRAINT constraint( CLEARANCE_CONSTRAINT, m_msg );
+            DRC_CONSTRAINT constraint( CLEARANCE_CONSTRAINT, source );
             constraint.m_Value.SetMin( clearance );
             return constraint;
         }
     }
 
-    static DRC_CONSTRAINT nullConstraint( NULL_CONSTRAINT );
-    nullConstraint.m_DisallowFlags = 0;
+    static const DRC_CONSTRAINT nullConstraint( NULL_CONSTRAINT );
 
     return constraintRef ? *constraintRef : nullConstraint;
 
@@ -1000,6 +1312,56 @@ DRC_CONSTRAINT DRC_ENGINE::EvalRulesForItems( DRC_CONSTRAINT_TYPE_T aConstraintI
 }
 
 
+size_t DRC_ENGINE::CONSTRAINT_CACHE_KEY_HASH::operator()( const CONSTRAINT_CACHE_KEY& aKey ) const
+{
+    return hash_val( (int) aKey.constraintType, (int) aKey.layer,
+                     (int) aKey.a.type, aKey.a.subtype, (int) aKey.a.layer, aKey.a.net,
+                     aKey.a.keepout,
+                     (int) aKey.b.type, aKey.b.subtype, (int) aKey.b.layer, aKey.b.net,
+                     aKey.b.keepout );
+}
+
+
+DRC_ENGINE::ITEM_SIGNATURE DRC_ENGINE::itemSignature( const BOARD_ITEM* aItem )
+{
+    ITEM_SIGNATURE signature = { NOT_USED, 0, UNDEFINED_LAYER, nullptr, false };
+
+    if( !aItem )
+        return signature;
+
+    signature.type = aItem->Type();
+    signature.layer = aItem->GetLayer();
+    signature.keepout = isKeepoutZone( aItem );
+
+    if( aItem->IsConnected() )
+        signature.net = static_cast<const BOARD_CONNECTED_ITEM*>( aItem )->GetNet();
+
+    if( aItem->Type() == PCB_PAD_T )
+        signature.subtype = (int) static_cast<const D_PAD*>( aItem )->GetAttribute();
+    else if( aItem->Type() == PCB_VIA_T )
+        signature.subtype = (int) static_cast<const VIA*>( aItem )->GetViaType();
+
+    return signature;
+}
+
+
+void DRC_ENGINE::clearConstraintCache()
+{
+    for( CONSTRAINT_CACHE_SHARD& shard : m_constraintCache )
+    {
+        std::lock_guard<std::mutex> lock( shard.mutex );
+        shard.entries.clear();
+    }
+}
+
+
+void DRC_ENGINE::SetConstraintCaching( bool aEnable )
+{
+    clearConstraintCache();
+    m_cacheConstraints = aEnable;
+}
+
+
 bool DRC_ENGINE::IsErrorLimitExceeded( int error_code )
 {
     assert( error_code >= 0 && error_code <= DRCE_LAST );
@@ -1011,6 +1373,46 @@ void DRC_ENGINE::ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoin
 {
     m_errorLimits[ aItem->GetErrorCode() ] -= 1;
 
+    std::lock_guard<std::mutex> lock( m_reportMutex );
+
+    if( m_deferViolations )
+        m_pendingViolations[ aItem->GetViolatingTest() ].emplace_back( aItem, aPos );
+    else
+        dispatchViolation( aItem, aPos );
+}
+
+
+void DRC_ENGINE::flushPendingViolations()
+{
+    std::lock_guard<std::mutex> lock( m_reportMutex );
+
+    m_deferViolations = false;
+
+    auto flush =
+            [&]( const DRC_TEST_PROVIDER* aProvider )
+            {
+                auto it = m_pendingViolations.find( aProvider );
+
+                if( it == m_pendingViolations.end() )
+                    return;
+
+                for( const std::pair<std::shared_ptr<DRC_ITEM>, wxPoint>& violation : it->second )
+                    dispatchViolation( violation.first, violation.second );
+
+                m_pendingViolations.erase( it );
+            };
+
+    for( DRC_TEST_PROVIDER* provider : m_testProviders )
+        flush( provider );
+
+    // Anything not reported through a provider
+    while( !m_pendingViolations.empty() )
+        flush( m_pendingViolations.begin()->first );
+}
+
+
+void DRC_ENGINE::dispatchViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+{
     if( m_violationHandler )
         m_violationHandler( aItem, aPos );
 
@@ -1036,11 +1438,14 @@ void DRC_ENGINE::ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoin
     }
 }
 
+
 void DRC_ENGINE::ReportAux ( const wxString& aStr )
 {
     if( !m_reporter )
         return;
 
+    std::lock_guard<std::mutex> lock( m_reportMutex );
+
     m_reporter->Report( aStr, RPT_SEVERITY_INFO );
 }
 
@@ -1050,6 +1455,10 @@ bool DRC_ENGINE::ReportProgress( double aProgress )
     if( !m_progressReporter )
         return true;
 
+    // Concurrent providers would fight over the bar; they move it a phase at a time
+    if( !isRunThread() )
+        return !m_progressReporter->IsCancelled();
+
     m_progressReporter->SetCurrentProgress( aProgress );
     return m_progressReporter->KeepRefreshing( false );
 }
@@ -1061,6 +1470,10 @@ bool DRC_ENGINE::ReportPhase( const wxString& aMessage )
         return true;
 
     m_progressReporter->AdvancePhase( aMessage );
+
+    if( !isRunThread() )
+        return !m_progressReporter->IsCancelled();
+
     return m_progressReporter->KeepRefreshing( false );
 }
 
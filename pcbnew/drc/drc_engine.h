@@ -24,10 +24,17 @@
 #ifndef DRC_ENGINE_H
 #define DRC_ENGINE_H
 
+#include <array>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
+#include <eda_rect.h>
 #include <drc/drc_rule.h>
 
 
@@ -135,9 +142,43 @@ public:
 
     /**
      * Runs the DRC tests.
+     *
+     * Providers which can run concurrently are run on a pool of threads once the others have
+     * finished.  Violations are handed to the violation handler after all the tests, in the
+     * order of the providers, so the results don't depend on scheduling.
      */
     void RunTests( EDA_UNITS aUnits,  bool aReportAllTrackErrors, bool aTestFootprints );
 
+    /**
+     * Runs the DRC tests which can be limited to a set of items, for \a aChangedItems only.
+     *
+     * Footprints are tested through their pads, graphics and zones.  Other items are only
+     * tested from the tracks and pads near them, so those are tested too.  The items in scope
+     * are still tested against the rest of the board, so any violation involving one of them
+     * is reported again; violations between other items are not.
+     */
+    void RunIncrementalTests( EDA_UNITS aUnits, const std::vector<BOARD_ITEM*>& aChangedItems );
+
+    /**
+     * @return true if \a aItem is to be tested by the current run, which is every item unless
+     *         the run is incremental.
+     */
+    bool IsInScope( const BOARD_ITEM* aItem ) const
+    {
+        return !m_incremental || m_scope.count( aItem );
+    }
+
+    /**
+     * @return the items tested by the last incremental run.
+     */
+    const std::unordered_set<const BOARD_ITEM*>& GetScope() const { return m_scope; }
+
+    /**
+     * @return true if an item with the bounding box \a aBox may be within the worst clearance
+     *         of an item under test.
+     */
+    bool IsNearScope( const EDA_RECT& aBox ) const;
+
 
     bool IsErrorLimitExceeded( int error_code );
 
@@ -146,6 +187,14 @@ public:
                                       PCB_LAYER_ID aLayer = UNDEFINED_LAYER,
                                       REPORTER* aReporter = nullptr );
 
+    /**
+     * Enables or disables the reuse of constraints resolved by EvalRulesForItems() for other
+     * items with the same type, layer, net, pad attribute and via type.  Only constraints whose
+     * rule conditions test nothing else are reused.  The board must not change while caching
+     * is enabled.
+     */
+    void SetConstraintCaching( bool aEnable );
+
     std::vector<DRC_CONSTRAINT> QueryConstraintsById( DRC_CONSTRAINT_TYPE_T ruleID );
 
     bool HasRulesForConstraintType( DRC_CONSTRAINT_TYPE_T constraintID );
@@ -156,6 +205,10 @@ public:
 
     bool RulesValid() { return m_rulesValid; }
 
+    /**
+     * Report methods may be called from the threads running concurrent providers.  Progress
+     * from those threads updates the phase only; the UI is refreshed by RunTests().
+     */
     void ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos );
     bool ReportProgress( double aProgress );
     bool ReportPhase( const wxString& aMessage );
@@ -192,10 +245,77 @@ private:
         DRC_CONSTRAINT       constraint;
     };
 
+    // The item properties which a cacheable rule condition may test
+    struct ITEM_SIGNATURE
+    {
+        KICAD_T             type;
+        int                 subtype;       // Pad attribute or via type
+        PCB_LAYER_ID        layer;
+        const NETINFO_ITEM* net;
+        bool                keepout;
+
+        bool operator==( const ITEM_SIGNATURE& aOther ) const
+        {
+            return type == aOther.type && subtype == aOther.subtype && layer == aOther.layer
+                    && net == aOther.net && keepout == aOther.keepout;
+        }
+    };
+
+    struct CONSTRAINT_CACHE_KEY
+    {
+        DRC_CONSTRAINT_TYPE_T constraintType;
+        PCB_LAYER_ID          layer;
+        ITEM_SIGNATURE        a;
+        ITEM_SIGNATURE        b;
+
+        bool operator==( const CONSTRAINT_CACHE_KEY& aOther ) const
+        {
+            return constraintType == aOther.constraintType && layer == aOther.layer
+                    && a == aOther.a && b == aOther.b;
+        }
+    };
+
+    struct CONSTRAINT_CACHE_KEY_HASH
+    {
+        size_t operator()( const CONSTRAINT_CACHE_KEY& aKey ) const;
+    };
+
+    struct CONSTRAINT_CACHE_ENTRY
+    {
+        const DRC_CONSTRAINT* constraint;
+        bool                  implicit;
+    };
+
+    // The cache is split so that concurrent providers rarely wait on the same lock
+    struct CONSTRAINT_CACHE_SHARD
+    {
+        std::mutex mutex;
+        std::unordered_map<CONSTRAINT_CACHE_KEY, CONSTRAINT_CACHE_ENTRY,
+                           CONSTRAINT_CACHE_KEY_HASH> entries;
+    };
+
+    static ITEM_SIGNATURE itemSignature( const BOARD_ITEM* aItem );
+
+    void clearConstraintCache();
+
     void loadImplicitRules();
     void loadTestProviders();
     DRC_RULE* createImplicitRule( const wxString& name );
 
+    /**
+     * Builds the cached shapes and bounding boxes which the providers would otherwise build
+     * lazily, so that concurrent providers only ever read the board.
+     */
+    void prepareBoardCaches();
+
+    void runProviders();
+    void runConcurrentProviders( const std::vector<DRC_TEST_PROVIDER*>& aProviders );
+
+    void dispatchViolation( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos );
+    void flushPendingViolations();
+
+    bool isRunThread() const { return std::this_thread::get_id() == m_runThread; }
+
 protected:
     BOARD_DESIGN_SETTINGS*           m_designSettings;
     BOARD*                           m_board;
@@ -207,7 +327,7 @@ protected:
     std::vector<DRC_TEST_PROVIDER*>  m_testProviders;
 
     EDA_UNITS                        m_userUnits;
-    std::vector<int>                 m_errorLimits;
+    std::vector<std::atomic<int>>    m_errorLimits;
     bool                             m_reportAllTrackErrors;
     bool                             m_testFootprints;
 
@@ -215,12 +335,30 @@ protected:
     std::unordered_map< DRC_CONSTRAINT_TYPE_T,
                         std::vector<CONSTRAINT_WITH_CONDITIONS*>* > m_constraintMap;
 
+    // Constraint types whose rule conditions all allow their results to be cached
+    std::unordered_set<DRC_CONSTRAINT_TYPE_T> m_cacheableConstraints;
+    bool                             m_cacheConstraints;
+    std::array<CONSTRAINT_CACHE_SHARD, 32> m_constraintCache;
+
     DRC_VIOLATION_HANDLER            m_violationHandler;
     REPORTER*                        m_reporter;
     PROGRESS_REPORTER*               m_progressReporter;
 
-    wxString m_msg;  // Allocating strings gets expensive enough to want to avoid it
     std::shared_ptr<KIGFX::VIEW_OVERLAY> m_debugOverlay;
+
+    // Violations held back while RunTests() is running, by provider
+    std::mutex                       m_reportMutex;
+    bool                             m_deferViolations;
+    std::map<const DRC_TEST_PROVIDER*,
+             std::vector<std::pair<std::shared_ptr<DRC_ITEM>, wxPoint>>> m_pendingViolations;
+
+    std::thread::id                  m_runThread;     // The thread which may refresh the UI
+
+    // The items tested by an incremental run, and their bounding boxes grown by the worst
+    // clearance
+    bool                             m_incremental;
+    std::unordered_set<const BOARD_ITEM*> m_scope;
+    std::vector<EDA_RECT>            m_scopeBoxes;
 };
 
 #endif // DRC_H
@@ -82,7 +82,8 @@ public:
 
     /**
      * Function Insert()
-     * Inserts an item into the tree.
+     * Inserts an item into the tree.  Inserted items are only indexed, and so only found by
+     * queries, once Build() has been called.
      */
     void Insert( BOARD_ITEM* aItem, int aWorstClearance = 0, int aLayer = UNDEFINED_LAYER )
     {
@@ -105,11 +106,12 @@ public:
 
                         bbox.Inflate( aWorstClearance );
 
-                        const int mmin[2] = { bbox.GetX(), bbox.GetY() };
-                        const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
+                        drc_rtree::Rect rect = { { bbox.GetX(), bbox.GetY() },
+                                                 { bbox.GetRight(), bbox.GetBottom() } };
 
-                        m_tree[layer]->Insert( mmin, mmax,
-                                               new ITEM_WITH_SHAPE( aItem, subshape, shape ) );
+                        m_pending[layer].emplace_back( rect,
+                                                       new ITEM_WITH_SHAPE( aItem, subshape,
+                                                                            shape ) );
                         m_count++;
                     }
                 };
@@ -125,6 +127,36 @@ public:
         }
     }
 
+    /**
+     * Function Build()
+     * Indexes the items inserted since the last call.  An empty layer is packed in one pass
+     * from all of its items, which is much faster than growing it item by item and gives a
+     * better balanced tree.
+     */
+    void Build()
+    {
+        for( int layer = 0; layer < PCB_LAYER_ID_COUNT; ++layer )
+        {
+            std::vector<drc_rtree::BulkEntry>& pending = m_pending[layer];
+
+            if( pending.empty() )
+                continue;
+
+            if( m_tree[layer]->Count() == 0 )
+            {
+                m_tree[layer]->BulkLoad( pending );
+            }
+            else
+            {
+                for( const drc_rtree::BulkEntry& entry : pending )
+                    m_tree[layer]->Insert( entry.first.m_min, entry.first.m_max, entry.second );
+            }
+
+            pending.clear();
+            pending.shrink_to_fit();
+        }
+    }
+
     /**
      * Function RemoveAll()
      * Removes all items from the RTree
@@ -134,6 +166,9 @@ public:
         for( auto tree : m_tree )
             tree->RemoveAll();
 
+        for( std::vector<drc_rtree::BulkEntry>& pending : m_pending )
+            pending.clear();
+
         m_count = 0;
     }
 
@@ -430,8 +465,9 @@ public:
 
 
 private:
-    drc_rtree*  m_tree[PCB_LAYER_ID_COUNT];
-    size_t      m_count;
+    drc_rtree*                        m_tree[PCB_LAYER_ID_COUNT];
+    std::vector<drc_rtree::BulkEntry> m_pending[PCB_LAYER_ID_COUNT];
+    size_t                            m_count;
 };
 
 
@@ -22,6 +22,7 @@
  */
 
 
+#include <advanced_config.h>
 #include <class_board_item.h>
 #include <reporter.h>
 #include <drc/drc_rule_condition.h>
@@ -54,7 +55,12 @@ bool DRC_RULE_CONDITION::EvaluateFor( const BOARD_ITEM* aItemA, const BOARD_ITEM
         return false;
     }
 
-    PCB_EXPR_CONTEXT ctx( aLayer );
+    // Conditions are evaluated from several threads at once during DRC; each thread reuses
+    // one context, and so its value arena, for all of its evaluations.
+    static thread_local PCB_EXPR_CONTEXT ctx;
+
+    ctx.Reset();
+    ctx.SetLayer( aLayer );
     ctx.SetErrorCallback(
             [&]( const wxString& aMessage, int aOffset )
             {
@@ -83,6 +89,40 @@ bool DRC_RULE_CONDITION::EvaluateFor( const BOARD_ITEM* aItemA, const BOARD_ITEM
 }
 
 
+bool DRC_RULE_CONDITION::IsCacheable() const
+{
+    static const std::set<wxString> cacheableProperties = { wxT( "type" ),
+                                                            wxT( "layer" ),
+                                                            wxT( "net" ),
+                                                            wxT( "netname" ),
+                                                            wxT( "netclass" ),
+                                                            wxT( "pad type" ),
+                                                            wxT( "via type" ) };
+
+    static const std::set<wxString> cacheableFunctions = { wxT( "isplated" ),
+                                                           wxT( "ismicrovia" ),
+                                                           wxT( "isblindburiedvia" ),
+                                                           wxT( "isdiffpair" ) };
+
+    if( GetExpression().IsEmpty() || !m_ucode )
+        return true;
+
+    for( const wxString& property : m_ucode->GetPropertyNames() )
+    {
+        if( !cacheableProperties.count( property ) )
+            return false;
+    }
+
+    for( const wxString& function : m_ucode->GetFunctionNames() )
+    {
+        if( !cacheableFunctions.count( function ) )
+            return false;
+    }
+
+    return true;
+}
+
+
 bool DRC_RULE_CONDITION::Compile( REPORTER* aReporter, int aSourceLine, int aSourceOffset )
 {
     PCB_EXPR_COMPILER compiler;
@@ -109,6 +149,10 @@ bool DRC_RULE_CONDITION::Compile( REPORTER* aReporter, int aSourceLine, int aSou
     PCB_EXPR_CONTEXT preflightContext( F_Cu );
 
     bool ok = compiler.Compile( GetExpression().ToUTF8().data(), m_ucode.get(), &preflightContext );
+
+    if( ok && ADVANCED_CFG::GetCfg().m_CompileRuleConditions )
+        m_ucode->Lower();
+
     return ok;
 }
 
@@ -46,6 +46,13 @@ public:
     void SetExpression( const wxString& aExpression ) { m_expression = aExpression; }
     wxString GetExpression() const { return m_expression; }
 
+    /**
+     * @return true if the result only depends on the layer and on the type, layer, net, pad
+     *         attribute and via type of the items, so it can be reused for other items which
+     *         share these.
+     */
+    bool IsCacheable() const;
+
 private:
     wxString                        m_expression;
     std::unique_ptr<PCB_EXPR_UCODE> m_ucode;
@@ -125,26 +125,32 @@ void DRC_TEST_PROVIDER::reportRuleStatistics()
 }
 
 
-int DRC_TEST_PROVIDER::forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
-                                            const std::function<bool( BOARD_ITEM*)>& aFunc )
+void DRC_TEST_PROVIDER::InitBasicItemLists()
 {
-    BOARD *brd = m_drcEngine->GetBoard();
-    std::bitset<MAX_STRUCT_TYPE_ID> typeMask;
-    int n = 0;
+    if( s_allBasicItems.size() != 0 )
+        return;
 
-    if( s_allBasicItems.size() == 0 )
+    for( int i = 0; i < MAX_STRUCT_TYPE_ID; i++ )
     {
-        for( int i = 0; i < MAX_STRUCT_TYPE_ID; i++ )
+        if( i != PCB_MODULE_T && i != PCB_GROUP_T )
         {
-            if( i != PCB_MODULE_T && i != PCB_GROUP_T )
-            {
-                s_allBasicItems.push_back( (KICAD_T) i );
+            s_allBasicItems.push_back( (KICAD_T) i );
 
-                if( i != PCB_ZONE_AREA_T && i != PCB_FP_ZONE_AREA_T )
-                    s_allBasicItemsButZones.push_back( (KICAD_T) i );
-            }
+            if( i != PCB_ZONE_AREA_T && i != PCB_FP_ZONE_AREA_T )
+                s_allBasicItemsButZones.push_back( (KICAD_T) i );
         }
     }
+}
+
+
+int DRC_TEST_PROVIDER::forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
+                                            const std::function<bool( BOARD_ITEM*)>& aFunc )
+{
+    BOARD *brd = m_drcEngine->GetBoard();
+    std::bitset<MAX_STRUCT_TYPE_ID> typeMask;
+    int n = 0;
+
+    InitBasicItemLists();
 
     if( aTypes.size() == 0 )
     {
@@ -92,6 +92,24 @@ public:
 
     virtual int GetNumPhases() const = 0;
 
+    /**
+     * Providers which only read the board (and their own members) can be run alongside each
+     * other on separate threads.
+     */
+    virtual bool CanRunConcurrently() const
+    {
+        return false;
+    }
+
+    /**
+     * Providers which only test the items for which DRC_ENGINE::IsInScope() is true (against
+     * any other items) are run by DRC_ENGINE::RunIncrementalTests().
+     */
+    virtual bool CanRunIncrementally() const
+    {
+        return false;
+    }
+
     virtual bool IsRuleDriven() const
     {
         return m_isRuleDriven;
@@ -107,6 +125,12 @@ public:
         m_enabled = aEnable;
     }
 
+    /**
+     * Fills s_allBasicItems and s_allBasicItemsButZones.  Must be called before providers
+     * are run concurrently.
+     */
+    static void InitBasicItemLists();
+
 protected:
     int forEachGeometryItem( const std::vector<KICAD_T>& aTypes, LSET aLayers,
                              const std::function<bool(BOARD_ITEM*)>& aFunc );
@@ -64,6 +64,16 @@ public:
     virtual std::set<DRC_CONSTRAINT_TYPE_T> GetConstraintTypes() const override;
 
     int GetNumPhases() const override;
+
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
+    bool CanRunIncrementally() const override
+    {
+        return true;
+    }
 };
 
 
@@ -86,6 +96,9 @@ bool DRC_TEST_PROVIDER_ANNULUS::Run()
                 if( m_drcEngine->IsErrorLimitExceeded( DRCE_ANNULAR_WIDTH ) )
                     return false;
 
+                if( !m_drcEngine->IsInScope( item ) )
+                    return true;
+
                 int  v_min = 0;
                 int  v_max = 0;
                 VIA* via = dyn_cast<VIA*>( item );
@@ -40,6 +40,11 @@
 #include <drc/drc_test_provider_clearance_base.h>
 #include <class_dimension.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 /*
     Copper clearance test. Checks all copper items (pads, vias, tracks, drawings, zones) for their electrical clearance.
     Errors generated:
@@ -49,6 +54,27 @@
     - DRCE_SHORTING_ITEMS
 */
 
+/**
+ * The results of testing one chunk of items on a worker thread.  They are handed to the
+ * DRC engine once all chunks have been tested.
+ */
+struct CLEARANCE_SHARD
+{
+    void ReportViolation( const std::shared_ptr<DRC_ITEM>& aItem, const wxPoint& aPos )
+    {
+        m_violations.emplace_back( aItem, aPos );
+    }
+
+    void AccountCheck( const DRC_RULE* aRule )
+    {
+        m_stats[ aRule ]++;
+    }
+
+    std::vector<std::pair<std::shared_ptr<DRC_ITEM>, wxPoint>> m_violations;
+    std::unordered_map<const DRC_RULE*, int>                   m_stats;
+};
+
+
 class DRC_TEST_PROVIDER_COPPER_CLEARANCE : public DRC_TEST_PROVIDER_CLEARANCE_BASE
 {
 public:
@@ -78,19 +104,46 @@ public:
 
     int GetNumPhases() const override;
 
+    bool CanRunIncrementally() const override
+    {
+        return true;
+    }
+
 private:
     bool testTrackAgainstItem( TRACK* track, SHAPE* trackShape, PCB_LAYER_ID layer,
-                               BOARD_ITEM* other );
+                               BOARD_ITEM* other, CLEARANCE_SHARD& aShard );
 
     void testTrackClearances();
 
-    bool testPadAgainstItem( D_PAD* pad, SHAPE* padShape, PCB_LAYER_ID layer, BOARD_ITEM* other );
+    bool testPadAgainstItem( D_PAD* pad, SHAPE* padShape, PCB_LAYER_ID layer, BOARD_ITEM* other,
+                             CLEARANCE_SHARD& aShard );
 
     void testPadClearances();
 
     void testZones();
 
-    void testItemAgainstZones( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer );
+    void testItemAgainstZones( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, CLEARANCE_SHARD& aShard );
+
+    /**
+     * Call \a aTestItem for the item indices 0 to \a aCount - 1, spread in chunks over as many
+     * threads as there are cores.  The results are reported in item order when all are done.
+     *
+     * The workers evaluate clearance rules, whose insideArea() conditions collide with zone
+     * outlines; this relies on DRC_ENGINE::prepareBoardCaches() having triangulated them.
+     */
+    void testItemsSharded( size_t aCount,
+                           const std::function<void( size_t, CLEARANCE_SHARD& )>& aTestItem );
+
+    /**
+     * Tracks and pads are tested against the items that come after them in this order, so
+     * that each pair is tested once.  Items which aren't tested themselves (including those
+     * outside the scope of an incremental run) come last.
+     */
+    int testOrder( const BOARD_ITEM* aItem ) const
+    {
+        auto it = m_testOrder.find( aItem );
+        return it == m_testOrder.end() ? INT_MAX : it->second;
+    }
 
 private:
     DRC_RTREE m_copperTree;
@@ -99,6 +152,10 @@ private:
     std::vector<ZONE_CONTAINER*>                          m_zones;
     std::map<ZONE_CONTAINER*, std::unique_ptr<DRC_RTREE>> m_zoneTrees;
 
+    std::vector<TRACK*>                        m_tracks;
+    std::vector<D_PAD*>                        m_pads;
+    std::unordered_map<const BOARD_ITEM*, int> m_testOrder;
+
 };
 
 
@@ -158,11 +215,12 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
                 if( !reportProgress( ii++, count, delta ) )
                     return false;
 
-                item->ClearFlags( SKIP_STRUCT );
-
                 if( item->Type() == PCB_FP_TEXT_T && !static_cast<FP_TEXT*>( item )->IsVisible() )
                     return true;
 
+                if( !m_drcEngine->IsNearScope( item->GetBoundingBox() ) )
+                    return true;
+
                 m_copperTree.Insert( item, m_largestClearance );
                 return true;
             };
@@ -179,6 +237,8 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), countItems );
     forEachGeometryItem( itemTypes, LSET::AllCuMask(), addToCopperTree );
 
+    m_copperTree.Build();
+
     if( !reportPhase( _( "Tessellating copper zones..." ) ) )
         return false;
 
@@ -192,6 +252,10 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
             break;
 
         zone->CacheBoundingBox();
+
+        if( !m_drcEngine->IsNearScope( zone->GetCachedBoundingBox() ) )
+            continue;
+
         m_zoneTrees[ zone ] = std::make_unique<DRC_RTREE>();
 
         for( int layer : zone->GetLayerSet().Seq() )
@@ -200,6 +264,35 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::Run()
                 m_zoneTrees[ zone ]->Insert( zone, layer );
         }
 
+        m_zoneTrees[ zone ]->Build();
+
+    }
+
+    int order = 0;
+
+    m_tracks.clear();
+    m_pads.clear();
+    m_testOrder.clear();
+
+    for( TRACK* track : m_board->Tracks() )
+    {
+        if( m_drcEngine->IsInScope( track ) )
+        {
+            m_tracks.push_back( track );
+            m_testOrder[ track ] = order++;
+        }
+    }
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            if( m_drcEngine->IsInScope( pad ) )
+            {
+                m_pads.push_back( pad );
+                m_testOrder[ pad ] = order++;
+            }
+        }
     }
 
     reportAux( "Testing %d copper items and %d zones...", count, m_zones.size() );
@@ -250,7 +343,8 @@ static std::shared_ptr<SHAPE> getShape( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer )
 
 bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( TRACK* track, SHAPE* trackShape,
                                                                PCB_LAYER_ID layer,
-                                                               BOARD_ITEM* other )
+                                                               BOARD_ITEM* other,
+                                                               CLEARANCE_SHARD& aShard )
 {
     if( m_drcEngine->IsErrorLimitExceeded( DRCE_CLEARANCE ) )
         return false;
@@ -261,7 +355,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( TRACK* track, SHA
     int      actual;
     VECTOR2I pos;
 
-    accountCheck( constraint );
+    aShard.AccountCheck( constraint.GetParentRule() );
 
     // Special processing for track:track intersections
     if( track->Type() == PCB_TRACE_T && other->Type() == PCB_TRACE_T )
@@ -275,7 +369,7 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( TRACK* track, SHA
             drcItem->SetItems( track, other );
             drcItem->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drcItem, (wxPoint) intersection.get() );
+            aShard.ReportViolation( drcItem, (wxPoint) intersection.get() );
             return true;
         }
     }
@@ -285,17 +379,18 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( TRACK* track, SHA
     if( trackShape->Collide( otherShape.get(), minClearance - m_drcEpsilon, &actual, &pos ) )
     {
         std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+        wxString                  msg;
 
-        m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                      constraint.GetName(),
-                      MessageTextFromValue( userUnits(), minClearance ),
-                      MessageTextFromValue( userUnits(), actual ) );
+        msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                    constraint.GetName(),
+                    MessageTextFromValue( userUnits(), minClearance ),
+                    MessageTextFromValue( userUnits(), actual ) );
 
-        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+        drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
         drce->SetItems( track, other );
         drce->SetViolatingRule( constraint.GetParentRule() );
 
-        reportViolation( drce, (wxPoint) pos );
+        aShard.ReportViolation( drce, (wxPoint) pos );
 
         if( !m_drcEngine->GetReportAllTrackErrors() )
             return false;
@@ -306,7 +401,8 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackAgainstItem( TRACK* track, SHA
 
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZones( BOARD_ITEM* aItem,
-                                                               PCB_LAYER_ID aLayer )
+                                                               PCB_LAYER_ID aLayer,
+                                                               CLEARANCE_SHARD& aShard )
 {
     for( ZONE_CONTAINER* zone : m_zones )
     {
@@ -329,22 +425,23 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZones( BOARD_ITEM* aItem
             int        clearance = constraint.GetValue().Min();
             int        actual;
             VECTOR2I   pos;
-            DRC_RTREE* zoneTree = m_zoneTrees[ zone ].get();
+            DRC_RTREE* zoneTree = m_zoneTrees.at( zone ).get();
 
             if( zoneTree->QueryColliding( aItem, aLayer, clearance - m_drcEpsilon, &actual, &pos ) )
             {
                 std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+                wxString                  msg;
 
-                m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                              constraint.GetName(),
-                              MessageTextFromValue( userUnits(), clearance ),
-                              MessageTextFromValue( userUnits(), actual ) );
+                msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                            constraint.GetName(),
+                            MessageTextFromValue( userUnits(), clearance ),
+                            MessageTextFromValue( userUnits(), actual ) );
 
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
                 drce->SetItems( aItem, zone );
                 drce->SetViolatingRule( constraint.GetParentRule() );
 
-                reportViolation( drce, (wxPoint) pos );
+                aShard.ReportViolation( drce, (wxPoint) pos );
             }
         }
     }
@@ -353,53 +450,50 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemAgainstZones( BOARD_ITEM* aItem
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testTrackClearances()
 {
-    // This is the number of tests between 2 calls to the progress bar
-    const int delta = 25;
-    int       ii = 0;
-
-    reportAux( "Testing %d tracks & vias...", m_board->Tracks().size() );
-
-    for( TRACK* track : m_board->Tracks() )
-    {
-        if( !reportProgress( ii++, m_board->Tracks().size(), delta ) )
-            break;
-
-        for( PCB_LAYER_ID layer : track->GetLayerSet().Seq() )
-        {
-            std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
-
-            m_copperTree.QueryColliding( track, layer, layer,
-                    // Filter:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        if( other->HasFlag( SKIP_STRUCT ) )
-                            return false;
+    reportAux( "Testing %d tracks & vias...", m_tracks.size() );
 
-                        auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
-
-                        if( otherCItem && otherCItem->GetNetCode() == track->GetNetCode() )
-                            return false;
-
-                        return true;
-                    },
-                    // Visitor:
-                    [&]( BOARD_ITEM* other ) -> bool
-                    {
-                        return testTrackAgainstItem( track, trackShape.get(), layer, other );
-                    },
-                    m_largestClearance );
-
-            testItemAgainstZones( track, layer );
-        }
+    testItemsSharded( m_tracks.size(),
+            [&]( size_t aIndex, CLEARANCE_SHARD& aShard )
+            {
+                TRACK* track = m_tracks[ aIndex ];
+                int    order = testOrder( track );
 
-        track->SetFlags( SKIP_STRUCT );
-    }
+                for( PCB_LAYER_ID layer : track->GetLayerSet().Seq() )
+                {
+                    std::shared_ptr<SHAPE> trackShape = track->GetEffectiveShape( layer );
+
+                    m_copperTree.QueryColliding( track, layer, layer,
+                            // Filter:
+                            [&]( BOARD_ITEM* other ) -> bool
+                            {
+                                if( testOrder( other ) < order )
+                                    return false;
+
+                                auto otherCItem = dynamic_cast<BOARD_CONNECTED_ITEM*>( other );
+
+                                if( otherCItem && otherCItem->GetNetCode() == track->GetNetCode() )
+                                    return false;
+
+                                return true;
+                            },
+                            // Visitor:
+                            [&]( BOARD_ITEM* other ) -> bool
+                            {
+                                return testTrackAgainstItem( track, trackShape.get(), layer, other,
+                                                             aShard );
+                            },
+                            m_largestClearance );
+
+                    testItemAgainstZones( track, layer, aShard );
+                }
+            } );
 }
 
 
 bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( D_PAD* pad, SHAPE* padShape,
                                                              PCB_LAYER_ID layer,
-                                                             BOARD_ITEM* other )
+                                                             BOARD_ITEM* other,
+                                                             CLEARANCE_SHARD& aShard )
 {
     bool testClearance = !m_drcEngine->IsErrorLimitExceeded( DRCE_CLEARANCE );
     bool testShorting = !m_drcEngine->IsErrorLimitExceeded( DRCE_SHORTING_ITEMS );
@@ -431,15 +525,16 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( D_PAD* pad, SHAPE*
                     && testShorting )
             {
                 std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_SHORTING_ITEMS );
+                wxString                  msg;
 
-                m_msg.Printf( _( "(nets %s and %s)" ),
-                              pad->GetNetname(),
-                              otherPad->GetNetname() );
+                msg.Printf( _( "(nets %s and %s)" ),
+                            pad->GetNetname(),
+                            otherPad->GetNetname() );
 
-                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+                drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
                 drce->SetItems( pad, otherPad );
 
-                reportViolation( drce, otherPad->GetPosition());
+                aShard.ReportViolation( drce, otherPad->GetPosition());
             }
 
             return true;
@@ -454,22 +549,23 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( D_PAD* pad, SHAPE*
                                                              otherPad );
                 clearance = constraint.GetValue().Min();
 
-                accountCheck( constraint.GetParentRule() );
+                aShard.AccountCheck( constraint.GetParentRule() );
 
                 if( padShape->Collide( otherShape.get(), clearance - m_drcEpsilon, &actual, &pos ) )
                 {
                     std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_HOLE_CLEARANCE );
+                    wxString                  msg;
 
-                    m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                                  constraint.GetName(),
-                                  MessageTextFromValue( userUnits(), clearance ),
-                                  MessageTextFromValue( userUnits(), actual ) );
+                    msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                                constraint.GetName(),
+                                MessageTextFromValue( userUnits(), clearance ),
+                                MessageTextFromValue( userUnits(), actual ) );
 
-                    drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+                    drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
                     drce->SetItems( pad, other );
                     drce->SetViolatingRule( constraint.GetParentRule() );
 
-                    reportViolation( drce, (wxPoint) pos );
+                    aShard.ReportViolation( drce, (wxPoint) pos );
                 }
             }
         }
@@ -484,22 +580,23 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( D_PAD* pad, SHAPE*
         constraint = m_drcEngine->EvalRulesForItems( CLEARANCE_CONSTRAINT, pad, other, layer );
         clearance = constraint.GetValue().Min();
 
-        accountCheck( constraint );
+        aShard.AccountCheck( constraint.GetParentRule() );
 
         if( padShape->Collide( otherShape.get(), clearance - m_drcEpsilon, &actual, &pos ) )
         {
             std::shared_ptr<DRC_ITEM> drce = DRC_ITEM::Create( DRCE_CLEARANCE );
+            wxString                  msg;
 
-            m_msg.Printf( _( "(%s clearance %s; actual %s)" ),
-                          constraint.GetName(),
-                          MessageTextFromValue( userUnits(), clearance ),
-                          MessageTextFromValue( userUnits(), actual ) );
+            msg.Printf( _( "(%s clearance %s; actual %s)" ),
+                        constraint.GetName(),
+                        MessageTextFromValue( userUnits(), clearance ),
+                        MessageTextFromValue( userUnits(), actual ) );
 
-            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + m_msg );
+            drce->SetErrorMessage( drce->GetErrorText() + wxS( " " ) + msg );
             drce->SetItems( pad, other );
             drce->SetViolatingRule( constraint.GetParentRule() );
 
-            reportViolation( drce, (wxPoint) pos );
+            aShard.ReportViolation( drce, (wxPoint) pos );
         }
     }
 
@@ -509,50 +606,128 @@ bool DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadAgainstItem( D_PAD* pad, SHAPE*
 
 void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testPadClearances( )
 {
-    const int delta = 25;  // This is the number of tests between 2 calls to the progress bar
+    reportAux( "Testing %d pads...", m_pads.size() );
 
-    size_t count = 0;
+    testItemsSharded( m_pads.size(),
+            [&]( size_t aIndex, CLEARANCE_SHARD& aShard )
+            {
+                D_PAD* pad = m_pads[ aIndex ];
+                int    order = testOrder( pad );
 
-    for( MODULE* module : m_board->Modules() )
-        count += module->Pads().size();
+                for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
+                {
+                    std::shared_ptr<SHAPE> padShape = getShape( pad, layer );
+
+                    m_copperTree.QueryColliding( pad, layer, layer,
+                            // Filter:
+                            [&]( BOARD_ITEM* other ) -> bool
+                            {
+                                return testOrder( other ) > order;
+                            },
+                            // Visitor
+                            [&]( BOARD_ITEM* other ) -> bool
+                            {
+                                return testPadAgainstItem( pad, padShape.get(), layer, other,
+                                                           aShard );
+                            },
+                            m_largestClearance );
+
+                    testItemAgainstZones( pad, layer, aShard );
+                }
+            } );
+}
 
-    reportAux( "Testing %d pads...", count );
 
-    int ii = 0;
+void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testItemsSharded( size_t aCount,
+        const std::function<void( size_t, CLEARANCE_SHARD& )>& aTestItem )
+{
+    // Results are kept per chunk rather than per thread so that they come out in the same
+    // order however the chunks were shared out
+    const size_t chunkSize = 16;
+    const size_t chunkCount = ( aCount + chunkSize - 1 ) / chunkSize;
+
+    std::vector<CLEARANCE_SHARD> shards( chunkCount );
+    std::atomic<size_t>          nextChunk( 0 );
+    std::atomic<size_t>          tested( 0 );
+    std::atomic<bool>            cancelled( false );
+
+    auto test_chunk =
+            [&]( size_t aChunk )
+            {
+                size_t last = std::min( aCount, ( aChunk + 1 ) * chunkSize );
 
-    for( MODULE* module : m_board->Modules() )
+                for( size_t ii = aChunk * chunkSize; ii < last; ++ii )
+                    aTestItem( ii, shards[ aChunk ] );
+
+                tested += last - aChunk * chunkSize;
+            };
+
+    auto run_lambda =
+            [&]() -> size_t
+            {
+                size_t num = 0;
+
+                for( size_t i = nextChunk++; i < chunkCount && !cancelled; i = nextChunk++ )
+                {
+                    test_chunk( i );
+                    num++;
+                }
+
+                return num;
+            };
+
+    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
+                                                   chunkCount );
+
+    if( parallelThreadCount <= 1 )
     {
-        for( D_PAD* pad : module->Pads() )
+        for( size_t i = 0; i < chunkCount; ++i )
         {
-            if( !reportProgress( ii++, count, delta ) )
+            if( !reportProgress( (int) tested, (int) aCount, 1 ) )
                 break;
 
-            for( PCB_LAYER_ID layer : pad->GetLayerSet().Seq() )
-            {
-                std::shared_ptr<SHAPE> padShape = getShape( pad, layer );
+            test_chunk( i );
+        }
+    }
+    else
+    {
+        // A lazy triangulation in SHAPE_POLY_SET::Collide() would race between the workers
+        for( ZONE_CONTAINER* zone : m_board->Zones() )
+            wxASSERT( zone->Outline()->IsTriangulationUpToDate() );
 
-                m_copperTree.QueryColliding( pad, layer, layer,
-                        // Filter:
-                        [&]( BOARD_ITEM* other ) -> bool
-                        {
-                            if( other->HasFlag( SKIP_STRUCT ) )
-                                return false;
+        for( MODULE* module : m_board->Modules() )
+        {
+            for( ZONE_CONTAINER* zone : module->Zones() )
+                wxASSERT( zone->Outline()->IsTriangulationUpToDate() );
+        }
 
-                            return true;
-                        },
-                        // Visitor
-                        [&]( BOARD_ITEM* other ) -> bool
-                        {
-                            return testPadAgainstItem( pad, padShape.get(), layer, other );
-                        },
-                        m_largestClearance );
+        std::vector<std::future<size_t>> returns( parallelThreadCount );
 
-                testItemAgainstZones( pad, layer );
-            }
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, run_lambda );
 
-            pad->SetFlags( SKIP_STRUCT );
+        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+        {
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
+            {
+                if( !cancelled && !reportProgress( (int) tested, (int) aCount, 1 ) )
+                    cancelled = true;
+
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
         }
     }
+
+    for( CLEARANCE_SHARD& shard : shards )
+    {
+        for( const std::pair<const DRC_RULE* const, int>& stat : shard.m_stats )
+            m_stats[ stat.first ] += stat.second;
+
+        for( std::pair<std::shared_ptr<DRC_ITEM>, wxPoint>& violation : shard.m_violations )
+            reportViolation( violation.first, violation.second );
+    }
 }
 
 
@@ -563,6 +738,15 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
     SHAPE_POLY_SET  buffer;
     SHAPE_POLY_SET* boardOutline = nullptr;
 
+    auto inScope =
+            [&]( ZONE_CONTAINER* aZone )
+            {
+                return m_drcEngine->IsInScope( aZone );
+            };
+
+    if( std::none_of( m_zones.begin(), m_zones.end(), inScope ) )
+        return;
+
     if( m_board->GetBoardPolygonOutlines( buffer ) )
         boardOutline = &buffer;
 
@@ -602,6 +786,10 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 if( zoneRef == zoneToTest )
                     continue;
 
+                // An incremental run only tests the pairs involving a changed zone
+                if( !inScope( zoneRef ) && !inScope( zoneToTest ) )
+                    continue;
+
                 // test for same layer
                 if( !zoneToTest->IsOnLayer( layer ) )
                     continue;
@@ -633,7 +821,7 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                     zone2zoneClearance = 1;
 
                 // test for some corners of zoneRef inside zoneToTest
-                for( auto iterator = smoothed_polys[ia].IterateWithHoles(); iterator; iterator++ )
+                for( auto iterator = smoothed_polys[ia].CIterateWithHoles(); iterator; iterator++ )
                 {
                     VECTOR2I currentVertex = *iterator;
                     wxPoint pt( currentVertex.x, currentVertex.y );
@@ -649,7 +837,7 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 }
 
                 // test for some corners of zoneToTest inside zoneRef
-                for( auto iterator = smoothed_polys[ia2].IterateWithHoles(); iterator; iterator++ )
+                for( auto iterator = smoothed_polys[ia2].CIterateWithHoles(); iterator; iterator++ )
                 {
                     VECTOR2I currentVertex = *iterator;
                     wxPoint pt( currentVertex.x, currentVertex.y );
@@ -667,13 +855,13 @@ void DRC_TEST_PROVIDER_COPPER_CLEARANCE::testZones()
                 // Iterate through all the segments of refSmoothedPoly
                 std::map<wxPoint, int> conflictPoints;
 
-                for( auto refIt = smoothed_polys[ia].IterateSegmentsWithHoles(); refIt; refIt++ )
+                for( auto refIt = smoothed_polys[ia].CIterateSegmentsWithHoles(); refIt; refIt++ )
                 {
                     // Build ref segment
                     SEG refSegment = *refIt;
 
                     // Iterate through all the segments in smoothed_polys[ia2]
-                    for( auto testIt = smoothed_polys[ia2].IterateSegmentsWithHoles(); testIt; testIt++ )
+                    for( auto testIt = smoothed_polys[ia2].CIterateSegmentsWithHoles(); testIt; testIt++ )
                     {
                         // Build test segment
                         SEG testSegment = *testIt;
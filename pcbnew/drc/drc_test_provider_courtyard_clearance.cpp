@@ -65,6 +65,11 @@ public:
 
     int GetNumPhases() const override;
 
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
 private:
     void testFootprintCourtyardDefinitions();
 
@@ -110,11 +115,6 @@ void DRC_TEST_PROVIDER_COURTYARD_CLEARANCE::testFootprintCourtyardDefinitions()
             drcItem->SetItems( footprint );
             reportViolation( drcItem, footprint->GetPosition());
         }
-        else
-        {
-            footprint->GetPolyCourtyardFront().BuildBBoxCaches();
-            footprint->GetPolyCourtyardBack().BuildBBoxCaches();
-        }
     }
 }
 
@@ -324,6 +324,8 @@ bool test::DRC_TEST_PROVIDER_DIFF_PAIR_COUPLING::Run()
     forEachGeometryItem( { PCB_TRACE_T, PCB_VIA_T, PCB_PAD_T, PCB_ZONE_AREA_T, PCB_ARC_T },
                          LSET::AllCuMask(), addToTree );
 
+    copperTree.Build();
+
 
     reportAux( wxString::Format( _("DPs evaluated:") ) );
 
@@ -72,6 +72,11 @@ public:
 
     int GetNumPhases() const override;
 
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
 private:
     bool testAgainstEdge( BOARD_ITEM* item, SHAPE* itemShape, BOARD_ITEM* other,
                           DRC_CONSTRAINT_TYPE_T aConstraintType, PCB_DRC_CODE aErrorCode );
@@ -162,7 +167,7 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
                 else if( shape->GetShape() == S_POLYGON )
                 {
                     // Same for polygons
-                    SHAPE_LINE_CHAIN poly = shape->GetPolyShape().Outline( 0 );
+                    SHAPE_LINE_CHAIN poly = shape->GetPolyShape().COutline( 0 );
 
                     for( size_t ii = 0; ii < poly.GetSegmentCount(); ++ii )
                     {
@@ -194,6 +199,8 @@ bool DRC_TEST_PROVIDER_EDGE_CLEARANCE::Run()
     for( const std::unique_ptr<PCB_SHAPE>& edge : edges )
         edgesTree.Insert( edge.get(), m_largestClearance );
 
+    edgesTree.Build();
+
     wxString val;
     wxGetEnv( "WXTRACE", &val );
 
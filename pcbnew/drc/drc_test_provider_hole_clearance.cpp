@@ -165,6 +165,8 @@ bool DRC_TEST_PROVIDER_HOLE_CLEARANCE::Run()
 
     forEachGeometryItem( { PCB_PAD_T, PCB_VIA_T }, LSET::AllLayersMask(), addToHoleTree );
 
+    m_holeTree.Build();
+
     for( TRACK* track : m_board->Tracks() )
     {
         if( track->Type() != PCB_VIA_T )
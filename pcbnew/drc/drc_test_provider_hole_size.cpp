@@ -66,6 +66,16 @@ public:
 
     int GetNumPhases() const override;
 
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
+    bool CanRunIncrementally() const override
+    {
+        return true;
+    }
+
 private:
     void checkVia( VIA* via, bool aExceedMicro, bool aExceedStd );
     void checkPad( D_PAD* aPad );
@@ -91,7 +101,8 @@ bool DRC_TEST_PROVIDER_HOLE_SIZE::Run()
             if( m_drcEngine->IsErrorLimitExceeded( DRCE_TOO_SMALL_DRILL ) )
                 break;
 
-            checkPad( pad );
+            if( m_drcEngine->IsInScope( pad ) )
+                checkPad( pad );
         }
     }
 
@@ -102,7 +113,7 @@ bool DRC_TEST_PROVIDER_HOLE_SIZE::Run()
 
     for( TRACK* track : m_board->Tracks() )
     {
-        if( track->Type() == PCB_VIA_T )
+        if( track->Type() == PCB_VIA_T && m_drcEngine->IsInScope( track ) )
             vias.push_back( static_cast<VIA*>( track ) );
     }
 
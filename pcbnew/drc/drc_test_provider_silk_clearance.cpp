@@ -71,6 +71,11 @@ public:
         return 1;
     }
 
+    virtual bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
     virtual std::set<DRC_CONSTRAINT_TYPE_T> GetConstraintTypes() const override;
 
 private:
@@ -205,6 +210,9 @@ bool DRC_TEST_PROVIDER_SILK_CLEARANCE::Run()
 
     forEachGeometryItem( s_allBasicItems, LSET::FrontMask() | LSET::BackMask(), addToTargetTree );
 
+    silkTree.Build();
+    targetTree.Build();
+
     reportAux( _("Testing %d silkscreen features against %d board items."),
                silkTree.size(),
                targetTree.size() );
@@ -69,6 +69,11 @@ public:
         return 1;
     }
 
+    virtual bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
     virtual std::set<DRC_CONSTRAINT_TYPE_T> GetConstraintTypes() const override;
 
 private:
@@ -165,6 +170,9 @@ bool DRC_TEST_PROVIDER_SILK_TO_MASK::Run()
     int numMask = forEachGeometryItem( s_allBasicItems, LSET( 2, F_Mask, B_Mask ), addMaskToTree );
     int numSilk = forEachGeometryItem( s_allBasicItems, LSET( 2, F_SilkS, B_SilkS ), addSilkToTree );
 
+    maskTree.Build();
+    silkTree.Build();
+
     reportAux( _("Testing %d mask apertures against %d silkscreen features."), numMask, numSilk );
 
     const std::vector<DRC_RTREE::LAYER_PAIR> layerPairs =
@@ -60,6 +60,16 @@ public:
     virtual std::set<DRC_CONSTRAINT_TYPE_T> GetConstraintTypes() const override;
 
     int GetNumPhases() const override;
+
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
+    bool CanRunIncrementally() const override
+    {
+        return true;
+    }
 };
 
 
@@ -82,6 +92,9 @@ bool DRC_TEST_PROVIDER_TRACK_WIDTH::Run()
                 if( m_drcEngine->IsErrorLimitExceeded( DRCE_TRACK_WIDTH ) )
                     return false;
 
+                if( !m_drcEngine->IsInScope( item ) )
+                    return true;
+
                 int     actual;
                 wxPoint p0;
 
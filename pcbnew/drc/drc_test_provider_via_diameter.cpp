@@ -59,6 +59,16 @@ public:
     virtual std::set<DRC_CONSTRAINT_TYPE_T> GetConstraintTypes() const override;
 
     int GetNumPhases() const override;
+
+    bool CanRunConcurrently() const override
+    {
+        return true;
+    }
+
+    bool CanRunIncrementally() const override
+    {
+        return true;
+    }
 };
 
 
@@ -81,6 +91,9 @@ bool DRC_TEST_PROVIDER_VIA_DIAMETER::Run()
                 if( m_drcEngine->IsErrorLimitExceeded( DRCE_VIA_DIAMETER ) )
                     return false;
 
+                if( !m_drcEngine->IsInScope( item ) )
+                    return true;
+
                 VIA* via = dyn_cast<VIA*>( item );
 
                 // fixme: move to pad stack check?
@@ -843,9 +843,14 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool addToHistory,
     {
         PLUGIN::RELEASER    pi( IO_MGR::PluginFind( IO_MGR::KICAD_SEXP ) );
 
+        PROPERTIES          props;
+
         wxASSERT( tempFile.IsAbsolute() );
 
-        pi->Save( tempFile.GetFullPath(), GetBoard(), NULL );
+        // Name any side files after the real board file, not the temporary one
+        props["board_file"] = TO_UTF8( pcbFileName.GetFullPath() );
+
+        pi->Save( tempFile.GetFullPath(), GetBoard(), &props );
     }
     catch( const IO_ERROR& ioe )
     {
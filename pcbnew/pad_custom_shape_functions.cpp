@@ -173,16 +173,22 @@ void D_PAD::DeletePrimitivesList()
 
 
 void D_PAD::addPadPrimitivesToPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_ID aLayer,
-                                       int aError, ERROR_LOC aErrorLoc ) const
+                                       int aInflateValue, int aError, ERROR_LOC aErrorLoc ) const
 {
     SHAPE_POLY_SET polyset;
 
     for( const std::shared_ptr<PCB_SHAPE>& primitive : m_editPrimitives )
-        primitive->TransformShapeWithClearanceToPolygon( polyset, aLayer, 0, aError, aErrorLoc );
+    {
+        // Shapes without a line width are filled, and inflating their outline alone would
+        // leave them hollow
+        if( aInflateValue > 0 && primitive->GetWidth() == 0 )
+            primitive->TransformShapeWithClearanceToPolygon( polyset, aLayer, 0, aError, aErrorLoc );
 
-    polyset.Simplify( SHAPE_POLY_SET::PM_FAST );
+        primitive->TransformShapeWithClearanceToPolygon( polyset, aLayer, aInflateValue, aError,
+                                                         aErrorLoc );
+    }
 
-    // Merge all polygons with the initial pad anchor shape
+    // Merge all polygons with the initial pad anchor shape, in a single union
     if( polyset.OutlineCount() )
     {
         aMergedPolygon->BooleanAdd( polyset, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
@@ -190,11 +196,22 @@ void D_PAD::addPadPrimitivesToPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER
     }
 }
 
+
 void D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_ID aLayer ) const
 {
     BOARD* board = GetBoard();
     int    maxError = board ? board->GetDesignSettings().m_MaxError: ARC_HIGH_DEF;
 
+    MergeInflatedPrimitivesAsPolygon( aMergedPolygon, aLayer, 0, maxError, ERROR_INSIDE );
+}
+
+
+void D_PAD::MergeInflatedPrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon,
+                                              PCB_LAYER_ID aLayer, int aInflateValue,
+                                              int aError, ERROR_LOC aErrorLoc ) const
+{
+    wxASSERT( aInflateValue >= 0 );
+
     aMergedPolygon->RemoveAllContours();
 
     // Add the anchor pad shape in aMergedPolygon, others in aux_polyset:
@@ -202,27 +219,35 @@ void D_PAD::MergePrimitivesAsPolygon( SHAPE_POLY_SET* aMergedPolygon, PCB_LAYER_
     switch( GetAnchorPadShape() )
     {
     case PAD_SHAPE_RECT:
-    {
-        SHAPE_RECT rect( -GetSize().x / 2, -GetSize().y / 2, GetSize().x, GetSize().y );
-        aMergedPolygon->AddOutline( rect.Outline() );
-    }
+        if( aInflateValue > 0 )
+        {
+            wxSize size( GetSize().x + 2 * aInflateValue, GetSize().y + 2 * aInflateValue );
+
+            TransformRoundChamferedRectToPolygon( *aMergedPolygon, wxPoint( 0, 0 ), size, 0.0,
+                                                  aInflateValue, 0.0, 0, aError, aErrorLoc );
+        }
+        else
+        {
+            SHAPE_RECT rect( -GetSize().x / 2, -GetSize().y / 2, GetSize().x, GetSize().y );
+            aMergedPolygon->AddOutline( rect.Outline() );
+        }
         break;
 
     default:
     case PAD_SHAPE_CIRCLE:
-        TransformCircleToPolygon( *aMergedPolygon, wxPoint( 0, 0 ), GetSize().x / 2, maxError,
-                                  ERROR_INSIDE );
+        TransformCircleToPolygon( *aMergedPolygon, wxPoint( 0, 0 ),
+                                  GetSize().x / 2 + aInflateValue, aError, aErrorLoc );
         break;
     }
 
-    addPadPrimitivesToPolygon( aMergedPolygon, aLayer, maxError, ERROR_INSIDE );
+    addPadPrimitivesToPolygon( aMergedPolygon, aLayer, aInflateValue, aError, aErrorLoc );
 }
 
 
 bool D_PAD::GetBestAnchorPosition( VECTOR2I& aPos )
 {
     SHAPE_POLY_SET poly;
-    addPadPrimitivesToPolygon( &poly, UNDEFINED_LAYER, ARC_LOW_DEF, ERROR_INSIDE );
+    addPadPrimitivesToPolygon( &poly, UNDEFINED_LAYER, 0, ARC_LOW_DEF, ERROR_INSIDE );
 
     if( poly.OutlineCount() > 1 )
         return false;
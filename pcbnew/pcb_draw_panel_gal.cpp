@@ -32,6 +32,7 @@
 #include <class_board.h>
 #include <class_module.h>
 #include <class_track.h>
+#include <class_zone.h>
 #include <class_marker_pcb.h>
 #include <pcb_base_frame.h>
 #include <pcbnew_settings.h>
@@ -46,7 +47,7 @@
 
 #include <functional>
 #include <memory>
-#include <thread>
+#include <future>
 using namespace std::placeholders;
 
 const LAYER_NUM GAL_LAYER_ORDER[] =
@@ -166,24 +167,14 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 {
 
     m_view->Clear();
+    m_view->BeginBulkAdd();
 
-    auto zones = aBoard->Zones();
-    std::atomic<size_t> next( 0 );
-    std::atomic<size_t> count_done( 0 );
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [ &count_done, &next, &zones ]( )
-        {
-            for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
-
-            count_done++;
-        } );
-
-        t.detach();
-    }
+    // Triangulate zone fills in the background while the other items are added
+    std::future<void> triangulation = std::async( std::launch::async,
+            [aBoard]()
+            {
+                ZONE_CONTAINER::CacheTriangulations( aBoard->Zones() );
+            } );
 
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
@@ -204,9 +195,7 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     for( auto marker : aBoard->Markers() )
         m_view->Add( marker );
 
-    // Finalize the triangulation threads
-    while( count_done < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    triangulation.wait();
 
     // Load zones
     for( auto zone : aBoard->Zones() )
@@ -215,6 +204,8 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
     // Ratsnest
     m_ratsnest = std::make_unique<KIGFX::RATSNEST_VIEWITEM>( aBoard->GetConnectivity() );
     m_view->Add( m_ratsnest.get() );
+
+    m_view->EndBulkAdd();
 }
 
 
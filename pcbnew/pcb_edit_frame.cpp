@@ -862,6 +862,7 @@ void PCB_EDIT_FRAME::ShowBoardSetupDialog( const wxString& aInitialPage )
         Prj().GetProjectFile().NetSettings().ResolveNetClassAssignments( true );
 
         GetBoard()->SynchronizeNetsAndNetClasses();
+        GetBoard()->MarkAllZoneFillsDirty();
         SaveProjectSettings();
 
         UpdateUserInterface();
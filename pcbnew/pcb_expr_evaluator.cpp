@@ -267,7 +267,7 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                         }
                         else
                         {
-                            return zone->Outline()->Collide( &courtyard.Outline( 0 ) );
+                            return zone->Outline()->Collide( &courtyard.COutline( 0 ) );
                         }
                     }
 
@@ -282,7 +282,7 @@ static void insideArea( LIBEVAL::CONTEXT* aCtx, void* self )
                         }
                         else
                         {
-                            return zone->Outline()->Collide( &courtyard.Outline( 0 ) );
+                            return zone->Outline()->Collide( &courtyard.COutline( 0 ) );
                         }
                     }
 
@@ -574,6 +574,8 @@ LIBEVAL::FUNC_CALL_REF PCB_EXPR_UCODE::CreateFuncCall( const wxString& aName )
 {
     PCB_EXPR_BUILTIN_FUNCTIONS& registry = PCB_EXPR_BUILTIN_FUNCTIONS::Instance();
 
+    m_functionNames.insert( aName.Lower() );
+
     return registry.Get( aName.Lower() );
 }
 
@@ -601,6 +603,8 @@ std::unique_ptr<LIBEVAL::VAR_REF> PCB_EXPR_UCODE::CreateVarRef( const wxString&
     wxString field( aField );
     field.Replace( "_",  " " );
 
+    m_propertyNames.insert( field.Lower() );
+
     for( const PROPERTY_MANAGER::CLASS_INFO& cls : propMgr.GetAllClasses() )
     {
         if( propMgr.IsOfType( cls.type, TYPE_HASH( BOARD_ITEM ) ) )
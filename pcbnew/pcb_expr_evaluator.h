@@ -25,6 +25,7 @@
 #ifndef __PCB_EXPR_EVALUATOR_H
 #define __PCB_EXPR_EVALUATOR_H
 
+#include <set>
 #include <unordered_map>
 
 #include <property.h>
@@ -45,6 +46,17 @@ public:
 
     virtual std::unique_ptr<LIBEVAL::VAR_REF> CreateVarRef( const wxString& aVar, const wxString& aField ) override;
     virtual LIBEVAL::FUNC_CALL_REF CreateFuncCall( const wxString& aName ) override;
+
+    /**
+     * @return the names of the item properties (with underscores replaced by spaces) and of
+     *         the functions referenced by the compiled expression, in lower case.
+     */
+    const std::set<wxString>& GetPropertyNames() const { return m_propertyNames; }
+    const std::set<wxString>& GetFunctionNames() const { return m_functionNames; }
+
+private:
+    std::set<wxString> m_propertyNames;
+    std::set<wxString> m_functionNames;
 };
 
 
@@ -69,6 +81,11 @@ public:
         return m_items[index];
     }
 
+    void SetLayer( PCB_LAYER_ID aLayer )
+    {
+        m_layer = aLayer;
+    }
+
     PCB_LAYER_ID GetLayer() const
     {
         return m_layer;
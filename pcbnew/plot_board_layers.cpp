@@ -337,12 +337,24 @@ void PlotStandardLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
                 // so build a similar pad shape, and inflate/deflate the polygonal shape
                 D_PAD dummy( *pad );
                 SHAPE_POLY_SET shape;
-                pad->MergePrimitivesAsPolygon( &shape, UNDEFINED_LAYER );
-                // Shape polygon can have holes so use InflateWithLinkedHoles(), not Inflate()
-                // which can create bad shapes if margin.x is < 0
                 int maxError = aBoard->GetDesignSettings().m_MaxError;
-                int numSegs = GetArcToSegmentCount( margin.x, maxError, 360.0 );
-                shape.InflateWithLinkedHoles( margin.x, numSegs, SHAPE_POLY_SET::PM_FAST );
+
+                if( margin.x > 0 )
+                {
+                    // Grow each primitive rather than the merged shape
+                    pad->MergeInflatedPrimitivesAsPolygon( &shape, UNDEFINED_LAYER, margin.x,
+                                                           maxError, ERROR_INSIDE );
+                }
+                else
+                {
+                    pad->MergePrimitivesAsPolygon( &shape, UNDEFINED_LAYER );
+
+                    // Shape polygon can have holes so use InflateWithLinkedHoles(), not
+                    // Inflate() which can create bad shapes if margin.x is < 0
+                    int numSegs = GetArcToSegmentCount( margin.x, maxError, 360.0 );
+                    shape.InflateWithLinkedHoles( margin.x, numSegs, SHAPE_POLY_SET::PM_FAST );
+                }
+
                 dummy.DeletePrimitivesList();
                 dummy.AddPrimitivePoly( shape, 0 );
 
@@ -824,7 +836,7 @@ void PlotSolderMaskLayer( BOARD *aBoard, PLOTTER* aPlotter, LSET aLayerMask,
 
         // Merge all polygons: After deflating, not merged (not overlapping) polygons
         // will have the initial shape (with perhaps small changes due to deflating transform)
-        areas.Simplify( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+        areas.BatchUnion( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
         areas.Deflate( inflate, numSegs );
     }
 
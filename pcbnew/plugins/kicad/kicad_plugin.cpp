@@ -41,6 +41,7 @@
 #include <zones.h>
 #include <plugins/kicad/kicad_plugin.h>
 #include <plugins/kicad/pcb_parser.h>
+#include <plugins/kicad/zone_fill_cache_file.h>
 #include <pcbnew_settings.h>
 #include <boost/ptr_container/ptr_map.hpp>
 #include <convert_basic_shapes_to_polygon.h>    // for enum RECT_CHAMFER_POSITIONS definition
@@ -348,6 +349,14 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     // Prepare net mapping that assures that net codes saved in a file are consecutive integers
     m_mapping->SetBoard( aBoard );
 
+    std::unique_ptr<ZONE_FILL_CACHE_FILE> fillCache;
+
+    if( ADVANCED_CFG::GetCfg().m_ZoneFillCacheFile )
+    {
+        fillCache = std::make_unique<ZONE_FILL_CACHE_FILE>();
+        m_fillCache = fillCache.get();
+    }
+
     FILE_OUTPUTFORMATTER    formatter( aFileName );
 
     m_out = &formatter;     // no ownership
@@ -357,6 +366,19 @@ void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, const PROPERTIES* a
     Format( aBoard, 1 );
 
     m_out->Print( 0, ")\n" );
+
+    m_fillCache = nullptr;
+
+    if( fillCache )
+    {
+        UTF8     boardFile;
+        wxString fillCacheName = ZONE_FILL_CACHE_FILE::FileNameFor( aFileName );
+
+        if( m_props && m_props->Value( "board_file", &boardFile ) )
+            fillCacheName = ZONE_FILL_CACHE_FILE::FileNameFor( boardFile.wx_str() );
+
+        fillCache->Save( fillCacheName );
+    }
 }
 
 
@@ -1951,7 +1973,23 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
         const SHAPE_POLY_SET& fv = aZone->GetFilledPolysList( layer );
         newLine                  = 0;
 
-        if( !fv.IsEmpty() )
+        if( !fv.IsEmpty() && m_fillCache )
+        {
+            std::set<int> islands;
+
+            for( int ii = 0; ii < fv.OutlineCount(); ++ii )
+            {
+                if( aZone->IsIsland( layer, ii ) )
+                    islands.insert( ii );
+            }
+
+            std::string key = m_fillCache->Add( fv, islands );
+
+            m_out->Print( aNestLevel + 1, "(fill_cache (layer %s) (hash %s))\n",
+                          m_out->Quotew( LSET::Name( layer ) ).c_str(),
+                          m_out->Quotes( key ).c_str() );
+        }
+        else if( !fv.IsEmpty() )
         {
             int  poly_index  = 0;
             bool new_polygon = true;
@@ -2038,7 +2076,8 @@ PCB_IO::PCB_IO( int aControlFlags ) :
     m_cache( 0 ),
     m_ctl( aControlFlags ),
     m_parser( new PCB_PARSER() ),
-    m_mapping( new NETINFO_MAPPING() )
+    m_mapping( new NETINFO_MAPPING() ),
+    m_fillCache( nullptr )
 {
     init( 0 );
     m_out = &m_sf;
@@ -2059,6 +2098,8 @@ BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPER
 
     BOARD* board = DoLoad( reader, aAppendToMe, aProperties );
 
+    loadZoneFillCache( aFileName );
+
     // Give the filename to the board if it's new
     if( !aAppendToMe )
         board->SetFileName( aFileName );
@@ -2105,12 +2146,52 @@ BOARD* PCB_IO::DoLoad( LINE_READER& aReader, BOARD* aAppendToMe, const PROPERTIE
 }
 
 
+void PCB_IO::loadZoneFillCache( const wxString& aFileName )
+{
+    const std::vector<PCB_PARSER::CACHED_ZONE_FILL>& cachedFills = m_parser->GetCachedZoneFills();
+
+    if( cachedFills.empty() )
+        return;
+
+    ZONE_FILL_CACHE_FILE fillCache;
+
+    if( !fillCache.Load( ZONE_FILL_CACHE_FILE::FileNameFor( aFileName ) ) )
+    {
+        wxLogWarning( _( "Zone fill cache file for \"%s\" is missing or damaged; zones "
+                         "will need to be refilled." ), aFileName );
+    }
+
+    for( const PCB_PARSER::CACHED_ZONE_FILL& cachedFill : cachedFills )
+    {
+        ZONE_CONTAINER*                   zone = cachedFill.m_zone;
+        const ZONE_FILL_CACHE_FILE::FILL* fill = fillCache.Get( cachedFill.m_key );
+
+        if( !fill )
+        {
+            // The cached fill is missing or stale, so the zone has to be refilled.
+            zone->SetIsFilled( false );
+            zone->SetNeedRefill( true );
+            continue;
+        }
+
+        SHAPE_POLY_SET polys = fill->m_polys;
+        zone->SetFilledPolysList( cachedFill.m_layer, polys );
+
+        for( int island : fill->m_islands )
+            zone->SetIsIsland( cachedFill.m_layer, island );
+
+        zone->CalculateFilledArea();
+    }
+}
+
+
 void PCB_IO::init( const PROPERTIES* aProperties )
 {
     m_board = NULL;
     m_reader = NULL;
     m_loading_format_version = SEXPR_BOARD_FILE_VERSION;
     m_props = aProperties;
+    m_fillCache = nullptr;
 }
 
 
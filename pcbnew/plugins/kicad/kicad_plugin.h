@@ -44,6 +44,7 @@ class FP_TEXT;
 class PCB_GROUP;
 class TRACK;
 class ZONE_CONTAINER;
+class ZONE_FILL_CACHE_FILE;
 class PCB_TEXT;
 
 
@@ -88,7 +89,8 @@ class PCB_TEXT;
 //#define SEXPR_BOARD_FILE_VERSION    20200916  // Add center dimension
 //#define SEXPR_BOARD_FILE_VERSION    20200921  // Add orthogonal dimension
 //#define SEXPR_BOARD_FILE_VERSION    20200922  // Add user name to layer definition.
-#define SEXPR_BOARD_FILE_VERSION      20201002  // Add groups in footprints (for footprint editor).
+//#define SEXPR_BOARD_FILE_VERSION    20201002  // Add groups in footprints (for footprint editor).
+#define SEXPR_BOARD_FILE_VERSION      20201012  // Zone fills in an external fill cache file
 
 
 #define BOARD_FILE_HOST_VERSION       20200825  ///< Earlier files than this include the host tag
@@ -144,6 +146,11 @@ public:
         return wxT( "kicad_pcb" );
     }
 
+    /**
+     * When ADVANCED_CFG::m_ZoneFillCacheFile is set, zone fills are written to a binary
+     * fill cache file instead of inline.  The cache file is named after \a aFileName,
+     * or after the "board_file" property if present (for saves made to a temporary file).
+     */
     virtual void Save( const wxString& aFileName, BOARD* aBoard,
                const PROPERTIES* aProperties = NULL ) override;
 
@@ -229,6 +236,7 @@ protected:
     PCB_PARSER*         m_parser;
     NETINFO_MAPPING*    m_mapping;  ///< mapping for net codes, so only not empty net codes
                                     ///< are stored with consecutive integers as net codes
+    ZONE_FILL_CACHE_FILE* m_fillCache;  ///< receives zone fills while saving, no ownership
 
     void validateCache( const wxString& aLibraryPath, bool checkModified = true );
 
@@ -237,6 +245,9 @@ protected:
 
     void init( const PROPERTIES* aProperties );
 
+    /// Restore the zone fills which the last board loaded keeps in a fill cache file
+    void loadZoneFillCache( const wxString& aFileName );
+
     /// formats the board setup information
     void formatSetup( BOARD* aBoard, int aNestLevel = 0 ) const;
 
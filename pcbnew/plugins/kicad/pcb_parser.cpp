@@ -66,6 +66,7 @@ void PCB_PARSER::init()
     m_layerIndices.clear();
     m_layerMasks.clear();
     m_resetKIIDMap.clear();
+    m_cachedZoneFills.clear();
 
     // Add untranslated default (i.e. English) layernames.
     // Some may be overridden later if parsing a board rather than a footprint.
@@ -4704,6 +4705,40 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
             }
             break;
 
+        case T_fill_cache:
+            {
+                // "(fill_cache (layer "F.Cu") (hash "..."))"
+                CACHED_ZONE_FILL cachedFill = { zone.get(), zone->GetLayer(), std::string() };
+
+                for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
+                {
+                    if( token != T_LEFT )
+                        Expecting( T_LEFT );
+
+                    token = NextTok();
+
+                    switch( token )
+                    {
+                    case T_layer:
+                        cachedFill.m_layer = parseBoardItemLayer();
+                        NeedRIGHT();
+                        break;
+
+                    case T_hash:
+                        NeedSYMBOLorNUMBER();
+                        cachedFill.m_key = CurText();
+                        NeedRIGHT();
+                        break;
+
+                    default:
+                        Expecting( "layer or hash" );
+                    }
+                }
+
+                m_cachedZoneFills.push_back( cachedFill );
+            }
+            break;
+
         case T_fill_segments:
             {
                 ZONE_SEGMENT_FILL segs;
@@ -4753,7 +4788,7 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER( BOARD_ITEM_CONTAINER* aParent )
 
         default:
             Expecting( "net, layer/layers, tstamp, hatch, priority, connect_pads, min_thickness, "
-                       "fill, polygon, filled_polygon, fill_segments, or name" );
+                       "fill, polygon, filled_polygon, fill_cache, fill_segments, or name" );
         }
     }
 
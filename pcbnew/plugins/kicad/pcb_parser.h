@@ -99,6 +99,18 @@ class PCB_PARSER : public PCB_LEXER
 
     std::vector<GROUP_INFO> m_groupInfos;
 
+public:
+    ///> A zone fill stored in the board's fill cache file rather than inline
+    struct CACHED_ZONE_FILL
+    {
+        ZONE_CONTAINER* m_zone;
+        PCB_LAYER_ID    m_layer;
+        std::string     m_key;
+    };
+
+private:
+    std::vector<CACHED_ZONE_FILL> m_cachedZoneFills;
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -404,6 +416,15 @@ public:
      */
     wxString GetRequiredVersion();
 
+    /**
+     * Return the zone fills of the last board parsed which have to be fetched from its
+     * fill cache file.
+     */
+    const std::vector<CACHED_ZONE_FILL>& GetCachedZoneFills() const
+    {
+        return m_cachedZoneFills;
+    }
+
 };
 
 
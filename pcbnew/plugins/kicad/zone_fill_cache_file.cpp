@@ -0,0 +1,311 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/intl.h>
+
+#include <ki_exception.h>
+#include <md5_hash.h>
+#include <wildcards_and_files_ext.h>
+#include <plugins/kicad/zone_fill_cache_file.h>
+
+
+// File layout, all integers little-endian:
+//   magic, uint32 version, uint32 fill count, then for each fill:
+//     uint32 key length, key bytes,
+//     uint32 island count, int32 island indices,
+//     uint32 polygon count, for each polygon:
+//       uint32 chain count, for each chain (outline first, then holes):
+//         uint32 point count, int32 x/y pairs
+static const char     FILL_CACHE_MAGIC[8] = { 'K', 'I', 'F', 'I', 'L', 'L', 'S', '\0' };
+static const uint32_t FILL_CACHE_VERSION  = 2;
+
+
+namespace
+{
+
+class WRITER
+{
+public:
+    void Bytes( const void* aData, size_t aSize )
+    {
+        const char* data = static_cast<const char*>( aData );
+        m_buf.insert( m_buf.end(), data, data + aSize );
+    }
+
+    void U32( uint32_t aValue )
+    {
+        for( int i = 0; i < 4; ++i )
+            m_buf.push_back( static_cast<char>( ( aValue >> ( 8 * i ) ) & 0xFF ) );
+    }
+
+    void I32( int32_t aValue ) { U32( static_cast<uint32_t>( aValue ) ); }
+
+    const std::vector<char>& Buffer() const { return m_buf; }
+
+private:
+    std::vector<char> m_buf;
+};
+
+
+class READER
+{
+public:
+    READER( const std::vector<char>& aBuf ) :
+            m_buf( aBuf ),
+            m_pos( 0 ),
+            m_ok( true )
+    {
+    }
+
+    bool Bytes( void* aData, size_t aSize )
+    {
+        if( !m_ok || m_buf.size() - m_pos < aSize )
+            return m_ok = false;
+
+        memcpy( aData, m_buf.data() + m_pos, aSize );
+        m_pos += aSize;
+        return true;
+    }
+
+    uint32_t U32()
+    {
+        unsigned char b[4] = { 0, 0, 0, 0 };
+
+        if( !Bytes( b, 4 ) )
+            return 0;
+
+        return b[0] | ( b[1] << 8 ) | ( b[2] << 16 ) | ( uint32_t( b[3] ) << 24 );
+    }
+
+    int32_t I32() { return static_cast<int32_t>( U32() ); }
+
+    /**
+     * Read a count of items each at least \a aMinItemSize bytes long, failing if the
+     * remaining data can't hold that many.
+     */
+    uint32_t Count( size_t aMinItemSize )
+    {
+        uint32_t count = U32();
+
+        if( m_ok && ( m_buf.size() - m_pos ) / aMinItemSize < count )
+            m_ok = false;
+
+        return m_ok ? count : 0;
+    }
+
+    bool Ok() const { return m_ok; }
+    bool AtEnd() const { return m_pos == m_buf.size(); }
+
+private:
+    const std::vector<char>& m_buf;
+    size_t                   m_pos;
+    bool                     m_ok;
+};
+
+} // anonymous namespace
+
+
+wxString ZONE_FILL_CACHE_FILE::FileNameFor( const wxString& aBoardFileName )
+{
+    wxFileName fn( aBoardFileName );
+    fn.SetExt( KiCadZoneFillCacheFileExtension );
+
+    return fn.GetFullPath();
+}
+
+
+std::string ZONE_FILL_CACHE_FILE::HashKey( const SHAPE_POLY_SET& aFill,
+                                           const std::set<int>& aIslands )
+{
+    // The hash cached by the polygon set belongs to its last triangulation, which may not
+    // be that of the polygons any more, so hash the vertices afresh.
+    std::string polysHash = aFill.Checksum().Format();
+    MD5_HASH    hash;
+
+    hash.Hash( reinterpret_cast<uint8_t*>( &polysHash[0] ), polysHash.size() );
+    hash.Hash( aIslands.size() );
+
+    for( int island : aIslands )
+        hash.Hash( island );
+
+    hash.Finalize();
+
+    return hash.Format();
+}
+
+
+std::string ZONE_FILL_CACHE_FILE::Add( const SHAPE_POLY_SET& aFill, const std::set<int>& aIslands )
+{
+    std::string key = HashKey( aFill, aIslands );
+
+    if( !m_fills.count( key ) )
+    {
+        FILL& fill = m_fills[key];
+        fill.m_polys = aFill;
+        fill.m_islands = aIslands;
+    }
+
+    return key;
+}
+
+
+const ZONE_FILL_CACHE_FILE::FILL* ZONE_FILL_CACHE_FILE::Get( const std::string& aKey ) const
+{
+    auto it = m_fills.find( aKey );
+
+    return it == m_fills.end() ? nullptr : &it->second;
+}
+
+
+bool ZONE_FILL_CACHE_FILE::Load( const wxString& aFileName )
+{
+    m_fills.clear();
+
+    wxFFile file( aFileName, "rb" );
+
+    if( !file.IsOpened() )
+        return false;
+
+    std::vector<char> buf( file.Length() );
+
+    if( file.Read( buf.data(), buf.size() ) != buf.size() )
+        return false;
+
+    READER reader( buf );
+    char   magic[sizeof( FILL_CACHE_MAGIC )];
+
+    if( !reader.Bytes( magic, sizeof( magic ) )
+            || memcmp( magic, FILL_CACHE_MAGIC, sizeof( magic ) ) != 0
+            || reader.U32() != FILL_CACHE_VERSION )
+    {
+        return false;
+    }
+
+    uint32_t fillCount = reader.Count( 12 );
+
+    for( uint32_t ii = 0; ii < fillCount && reader.Ok(); ++ii )
+    {
+        std::string key( reader.Count( 1 ), '\0' );
+        reader.Bytes( &key[0], key.size() );
+
+        FILL     fill;
+        uint32_t islandCount = reader.Count( 4 );
+
+        for( uint32_t jj = 0; jj < islandCount; ++jj )
+            fill.m_islands.insert( reader.I32() );
+
+        uint32_t polyCount = reader.Count( 4 );
+
+        for( uint32_t jj = 0; jj < polyCount && reader.Ok(); ++jj )
+        {
+            uint32_t chainCount = reader.Count( 4 );
+
+            for( uint32_t kk = 0; kk < chainCount && reader.Ok(); ++kk )
+            {
+                SHAPE_LINE_CHAIN chain;
+                uint32_t         pointCount = reader.Count( 8 );
+
+                for( uint32_t pp = 0; pp < pointCount; ++pp )
+                {
+                    int x = reader.I32();
+                    int y = reader.I32();
+                    chain.Append( x, y, true );
+                }
+
+                chain.SetClosed( true );
+
+                if( kk == 0 )
+                    fill.m_polys.AddOutline( chain );
+                else
+                    fill.m_polys.AddHole( chain, fill.m_polys.OutlineCount() - 1 );
+            }
+        }
+
+        // Don't trust a record whose contents don't match its key.
+        if( reader.Ok() && HashKey( fill.m_polys, fill.m_islands ) == key )
+            m_fills[key] = std::move( fill );
+    }
+
+    if( !reader.Ok() || !reader.AtEnd() )
+    {
+        m_fills.clear();
+        return false;
+    }
+
+    return true;
+}
+
+
+void ZONE_FILL_CACHE_FILE::Save( const wxString& aFileName ) const
+{
+    WRITER writer;
+
+    writer.Bytes( FILL_CACHE_MAGIC, sizeof( FILL_CACHE_MAGIC ) );
+    writer.U32( FILL_CACHE_VERSION );
+    writer.U32( m_fills.size() );
+
+    for( const std::pair<const std::string, FILL>& entry : m_fills )
+    {
+        const SHAPE_POLY_SET& polys = entry.second.m_polys;
+
+        writer.U32( entry.first.size() );
+        writer.Bytes( entry.first.data(), entry.first.size() );
+
+        writer.U32( entry.second.m_islands.size() );
+
+        for( int island : entry.second.m_islands )
+            writer.I32( island );
+
+        writer.U32( polys.OutlineCount() );
+
+        for( int ii = 0; ii < polys.OutlineCount(); ++ii )
+        {
+            writer.U32( 1 + polys.HoleCount( ii ) );
+
+            for( int jj = -1; jj < polys.HoleCount( ii ); ++jj )
+            {
+                const SHAPE_LINE_CHAIN& chain = jj < 0 ? polys.COutline( ii )
+                                                       : polys.CHole( ii, jj );
+
+                writer.U32( chain.PointCount() );
+
+                for( int pp = 0; pp < chain.PointCount(); ++pp )
+                {
+                    writer.I32( chain.CPoint( pp ).x );
+                    writer.I32( chain.CPoint( pp ).y );
+                }
+            }
+        }
+    }
+
+    wxFFile file( aFileName, "wb" );
+
+    if( !file.IsOpened()
+            || !file.Write( writer.Buffer().data(), writer.Buffer().size() )
+            || !file.Close() )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to write zone fill cache file \"%s\"" ),
+                                          aFileName ) );
+    }
+}
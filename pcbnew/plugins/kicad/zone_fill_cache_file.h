@@ -0,0 +1,90 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZONE_FILL_CACHE_FILE_H
+#define ZONE_FILL_CACHE_FILE_H
+
+#include <map>
+#include <set>
+#include <string>
+
+#include <wx/string.h>
+
+#include <geometry/shape_poly_set.h>
+
+
+/**
+ * ZONE_FILL_CACHE_FILE
+ * is a compact binary store for zone fills, saved next to a board file (as .kicad_fills)
+ * so that the filled polygons don't have to be written and parsed as s-expressions.
+ *
+ * Fills are keyed by a hash of the filled polygons and of which of them are islands.  The
+ * board file only records the hash of each cached fill; a fill is only restored if the cache
+ * holds a fill with that hash.
+ */
+class ZONE_FILL_CACHE_FILE
+{
+public:
+    struct FILL
+    {
+        SHAPE_POLY_SET m_polys;
+        std::set<int>  m_islands;    ///< Indices of the outlines which are isolated islands
+    };
+
+    /**
+     * @return the name of the fill cache file belonging to \a aBoardFileName.
+     */
+    static wxString FileNameFor( const wxString& aBoardFileName );
+
+    /**
+     * @return the key under which \a aFill, with the islands \a aIslands, is stored.
+     */
+    static std::string HashKey( const SHAPE_POLY_SET& aFill, const std::set<int>& aIslands );
+
+    /**
+     * Store a fill under its hash key.
+     * @return the key.
+     */
+    std::string Add( const SHAPE_POLY_SET& aFill, const std::set<int>& aIslands );
+
+    /**
+     * @return the fill stored under \a aKey, or NULL if there isn't one.
+     */
+    const FILL* Get( const std::string& aKey ) const;
+
+    bool IsEmpty() const { return m_fills.empty(); }
+
+    /**
+     * Read a fill cache file, replacing the current contents.  The cache is only an
+     * accelerator, so a missing or damaged file leaves the cache empty rather than failing.
+     * @return true if the file was read.
+     */
+    bool Load( const wxString& aFileName );
+
+    /**
+     * Write the cache to \a aFileName.
+     * @throw IO_ERROR if the file cannot be written.
+     */
+    void Save( const wxString& aFileName ) const;
+
+private:
+    std::map<std::string, FILL> m_fills;
+};
+
+#endif    // ZONE_FILL_CACHE_FILE_H
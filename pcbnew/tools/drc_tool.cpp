@@ -32,7 +32,10 @@
 #include <dialog_drc.h>
 #include <board_commit.h>
 #include <widgets/progress_reporter.h>
+#include <drc/drc_engine.h>
+#include <drc/drc_item.h>
 #include <drc/drc_results_provider.h>
+#include <drc/drc_test_provider.h>
 #include <netlist_reader/pcb_netlist.h>
 
 DRC_TOOL::DRC_TOOL() :
@@ -221,6 +224,87 @@ void DRC_TOOL::RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones
 }
 
 
+void DRC_TOOL::TestChangedItems( const std::vector<BOARD_ITEM*>& aChangedItems,
+                                 const std::set<KIID>& aRemovedItems )
+{
+    if( m_drcRunning || !m_drcEngine || !m_drcEngine->RulesValid() )
+        return;
+
+    BOARD_COMMIT             commit( m_editFrame );
+    std::vector<MARKER_PCB*> newMarkers;
+    std::set<KIID>           testedItems;
+    std::set<wxString>       exclusions;
+
+    m_drcRunning = true;
+
+    if( !aChangedItems.empty() )
+    {
+        m_drcEngine->SetViolationHandler(
+                [&]( const std::shared_ptr<DRC_ITEM>& aItem, wxPoint aPos )
+                {
+                    newMarkers.push_back( new MARKER_PCB( aItem, aPos ) );
+                } );
+
+        m_drcEngine->RunIncrementalTests( m_editFrame->GetUserUnits(), aChangedItems );
+        m_drcEngine->ClearViolationHandler();
+
+        for( const BOARD_ITEM* item : m_drcEngine->GetScope() )
+            testedItems.insert( item->m_Uuid );
+    }
+
+    auto refersTo =
+            []( const std::shared_ptr<RC_ITEM>& aItem, const std::set<KIID>& aIds ) -> bool
+            {
+                return aIds.count( aItem->GetMainItemID() ) || aIds.count( aItem->GetAuxItemID() )
+                        || aIds.count( aItem->GetAuxItem2ID() )
+                        || aIds.count( aItem->GetAuxItem3ID() );
+            };
+
+    std::vector<MARKER_PCB*> staleMarkers;
+
+    for( MARKER_PCB* marker : m_pcb->Markers() )
+    {
+        std::shared_ptr<RC_ITEM> rcItem = marker->GetRCItem();
+        DRC_ITEM*                drcItem = dynamic_cast<DRC_ITEM*>( rcItem.get() );
+        DRC_TEST_PROVIDER*       test = drcItem ? drcItem->GetViolatingTest() : nullptr;
+
+        // Only the markers which the incremental tests would have raised again are replaced
+        if( refersTo( rcItem, aRemovedItems )
+                || ( test && test->CanRunIncrementally() && refersTo( rcItem, testedItems ) ) )
+        {
+            if( marker->IsExcluded() )
+                exclusions.insert( marker->Serialize() );
+
+            staleMarkers.push_back( marker );
+        }
+    }
+
+    for( MARKER_PCB* marker : staleMarkers )
+    {
+        if( marker->IsSelected() )
+            m_toolMgr->RunAction( PCB_ACTIONS::selectionClear, true );
+
+        view()->Remove( marker );
+        m_pcb->Delete( marker );
+    }
+
+    for( MARKER_PCB* marker : newMarkers )
+    {
+        if( exclusions.count( marker->Serialize() ) )
+            marker->SetExcluded( true );
+
+        commit.Add( marker );
+    }
+
+    commit.Push( wxEmptyString, false, false );
+
+    m_drcRunning = false;
+
+    if( m_drcDialog && ( !staleMarkers.empty() || !newMarkers.empty() ) )
+        updatePointers();
+}
+
+
 void DRC_TOOL::updatePointers()
 {
     // update my pointers, m_editFrame is the only unchangeable one
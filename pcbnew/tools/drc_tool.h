@@ -31,6 +31,7 @@
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 #include <memory>
+#include <set>
 #include <vector>
 #include <tools/pcb_tool_base.h>
 
@@ -117,6 +118,13 @@ public:
      */
     void RunTests( PROGRESS_REPORTER* aProgressReporter, bool aRefillZones,
                    bool aReportAllTrackErrors, bool aTestFootprints );
+
+    /**
+     * Re-run the tests which can be limited to \a aChangedItems, and replace the markers
+     * those tests raised for them.  Markers of \a aRemovedItems are deleted.
+     */
+    void TestChangedItems( const std::vector<BOARD_ITEM*>& aChangedItems,
+                           const std::set<KIID>& aRemovedItems );
 };
 
 
@@ -24,6 +24,7 @@
  */
 #include <cstdint>
 #include <thread>
+#include <advanced_config.h>
 #include <class_zone.h>
 #include <connectivity/connectivity_data.h>
 #include <board_commit.h>
@@ -76,6 +77,9 @@ void ZONE_FILLER_TOOL::CheckAllZones( wxWindow* aCaller, PROGRESS_REPORTER* aRep
     {
         commit.Push( _( "Fill Zone(s)" ), false );
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
+
+        // Pushing the fill records the zones themselves as changed; forget them.
+        board()->ClearZoneFillsDirty();
     }
     else
     {
@@ -128,10 +132,15 @@ void ZONE_FILLER_TOOL::FillAllZones( wxWindow* aCaller, PROGRESS_REPORTER* aRepo
     else
         filler.InstallNewProgressReporter( aCaller, _( "Fill All Zones" ), 3 );
 
+    filler.SetIncremental( ADVANCED_CFG::GetCfg().m_IncrementalZoneFill );
+
     if( filler.Fill( toFill ) )
     {
         commit.Push( _( "Fill Zone(s)" ), false );
         getEditFrame<PCB_EDIT_FRAME>()->m_ZoneFillsDirty = false;
+
+        // Pushing the fill records the zones themselves as changed; forget them.
+        board()->ClearZoneFillsDirty();
     }
     else
     {
@@ -25,7 +25,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
 #include <functional>
+#include <set>
 using namespace std::placeholders;
 #include <macros.h>
 #include <pcb_edit_frame.h>
@@ -42,6 +44,8 @@ using namespace std::placeholders;
 #include <tools/selection_tool.h>
 #include <tools/pcbnew_control.h>
 #include <tools/pcb_editor_control.h>
+#include <tools/drc_tool.h>
+#include <advanced_config.h>
 #include <page_layout/ws_proxy_undo_item.h>
 
 /* Functions to undo and redo edit commands.
@@ -390,8 +394,16 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     auto view = GetCanvas()->GetView();
     auto connectivity = GetBoard()->GetConnectivity();
 
+    // Undo/redo doesn't track the extents of what it restores, so the next zone fill can't
+    // be incremental.
+    GetBoard()->MarkAllZoneFillsDirty();
+
     PCB_GROUP* group = nullptr;
 
+    // Items to retest, and items whose markers to drop, when online DRC is enabled
+    std::vector<BOARD_ITEM*> changedItems;
+    std::set<KIID>           removedItems;
+
     // Undo in the reverse order of list creation: (this can allow stacked changes
     // like the same item can be changes and deleted in the same complex command
 
@@ -456,6 +468,39 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
             break;
         }
 
+        if( eda_item->Type() != PCB_MARKER_T && eda_item->Type() != PCB_NETINFO_T
+                && eda_item->Type() != PCB_GROUP_T )
+        {
+            switch( aList->GetPickedItemStatus( ii ) )
+            {
+            case UNDO_REDO::NEWITEM:    // about to be deleted
+                removedItems.insert( eda_item->m_Uuid );
+
+                if( eda_item->Type() == PCB_MODULE_T )
+                {
+                    static_cast<MODULE*>( eda_item )->RunOnChildren(
+                            [&]( BOARD_ITEM* aChild )
+                            {
+                                removedItems.insert( aChild->m_Uuid );
+                            } );
+                }
+
+                break;
+
+            case UNDO_REDO::CHANGED:
+            case UNDO_REDO::DELETED:    // about to be restored
+            case UNDO_REDO::MOVED:
+            case UNDO_REDO::ROTATED:
+            case UNDO_REDO::ROTATED_CLOCKWISE:
+            case UNDO_REDO::FLIPPED:
+                changedItems.push_back( static_cast<BOARD_ITEM*>( eda_item ) );
+                break;
+
+            default:
+                break;
+            }
+        }
+
         switch( aList->GetPickedItemStatus( ii ) )
         {
         case UNDO_REDO::CHANGED:    /* Exchange old and new data for each item */
@@ -596,6 +641,24 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     selTool->RebuildSelection();
 
     GetBoard()->SanitizeNetcodes();
+
+    // Undo and redo don't go through BOARD_COMMIT::Push(), so refresh the online DRC markers
+    // of what they restored here
+    if( IsType( FRAME_PCB_EDITOR ) && ADVANCED_CFG::GetCfg().m_OnlineDRC
+            && ( !changedItems.empty() || !removedItems.empty() ) )
+    {
+        DRC_TOOL* drcTool = m_toolManager->GetTool<DRC_TOOL>();
+
+        changedItems.erase( std::remove_if( changedItems.begin(), changedItems.end(),
+                                            [&]( BOARD_ITEM* aItem )
+                                            {
+                                                return removedItems.count( aItem->m_Uuid ) > 0;
+                                            } ),
+                            changedItems.end() );
+
+        if( drcTool )
+            drcTool->TestChangedItems( changedItems, removedItems );
+    }
 }
 
 
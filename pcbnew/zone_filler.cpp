@@ -25,7 +25,11 @@
 
 #include <thread>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <future>
+#include <mutex>
+#include <set>
 
 #include <advanced_config.h>
 #include <class_board.h>
@@ -57,7 +61,9 @@ ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
         m_commit( aCommit ),
         m_progressReporter( nullptr ),
         m_maxError( ARC_HIGH_DEF ),
-        m_worstClearance( 0 )
+        m_worstClearance( 0 ),
+        m_tileThreadCount( 1 ),
+        m_incremental( false )
 {
     // To enable add "DebugZoneFiller=1" to kicad_advanced settings file.
     m_debugZoneFiller = ADVANCED_CFG::GetCfg().m_DebugZoneFiller;
@@ -111,11 +117,15 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
     m_boardOutline.RemoveAllContours();
     m_brdOutlinesValid = m_board->GetBoardPolygonOutlines( m_boardOutline );
 
-    // Update and cache zone bounding boxes and pad effective shapes so that we don't have to
-    // make them thread-safe.
+    // Update and cache zone bounding boxes, outline triangulations (which insideArea() rule
+    // conditions collide with) and pad effective shapes so that we don't have to make them
+    // thread-safe.
+    std::vector<SHAPE_POLY_SET*> outlines;
+
     for( ZONE_CONTAINER* zone : m_board->Zones() )
     {
         zone->CacheBoundingBox();
+        outlines.push_back( zone->Outline() );
         m_worstClearance = std::max( m_worstClearance, zone->GetLocalClearance() );
     }
 
@@ -124,16 +134,24 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
         for( D_PAD* pad : module->Pads() )
         {
             if( pad->IsDirty() )
+            {
                 pad->BuildEffectiveShapes( UNDEFINED_LAYER );
+                m_board->GetZoneKnockoutCache().Invalidate( pad );
+            }
         }
 
         for( ZONE_CONTAINER* zone : module->Zones() )
         {
             zone->CacheBoundingBox();
+            outlines.push_back( zone->Outline() );
             m_worstClearance = std::max( m_worstClearance, zone->GetLocalClearance() );
         }
     }
 
+    SHAPE_POLY_SET::CacheTriangulations( outlines, true );
+
+    buildKnockoutIndex();
+
     // Sort by priority to reduce deferrals waiting on higher priority zones.
     std::sort( aZones.begin(), aZones.end(),
                []( const ZONE_CONTAINER* lhs, const ZONE_CONTAINER* rhs )
@@ -141,18 +159,95 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
                    return lhs->GetPriority() > rhs->GetPriority();
                } );
 
+    size_t cores = std::thread::hardware_concurrency();
+    std::atomic<size_t> nextItem;
+
+    auto check_fill_dependency =
+            [&]( ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer, ZONE_CONTAINER* aOtherZone ) -> bool
+            {
+                // Check to see if we have to knock-out the filled areas of a higher-priority
+                // zone.  If so we have to wait until said zone is filled before we can fill.
+
+                // Even if keepouts exclude copper pours the exclusion is by outline, not by
+                // filled area, so we're good-to-go here too.
+                if( aOtherZone->GetIsRuleArea() )
+                    return false;
+
+                // If the zones share no common layers
+                if( !aOtherZone->GetLayerSet().test( aLayer ) )
+                    return false;
+
+                if( aOtherZone->GetPriority() <= aZone->GetPriority() )
+                    return false;
+
+                // Same-net zones always use outline to produce predictable results
+                if( aOtherZone->GetNetCode() == aZone->GetNetCode() )
+                    return false;
+
+                // A higher priority zone is found: if we intersect then we have to wait for it.
+                EDA_RECT inflatedBBox = aZone->GetCachedBoundingBox();
+                inflatedBBox.Inflate( m_worstClearance );
+
+                return inflatedBBox.Intersects( aOtherZone->GetCachedBoundingBox() );
+            };
+
+    // In incremental mode a (zone, layer) is only refilled if copper it might knock out has
+    // changed since the last fill, or if it depends on a higher-priority zone which is being
+    // refilled.
+    bool incremental = m_incremental && !aCheck && !m_board->AreAllZoneFillsDirty();
+
+    auto needs_refill =
+            [&]( ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer ) -> bool
+            {
+                if( !aZone->IsFilled() || aZone->NeedRefill()
+                        || aZone->GetFillVersion() != bds.m_ZoneFillVersion )
+                {
+                    return true;
+                }
+
+                EDA_RECT inflatedBBox = aZone->GetCachedBoundingBox();
+                inflatedBBox.Inflate( m_worstClearance );
+
+                for( const std::pair<EDA_RECT, LSET>& area : m_board->GetZoneFillDirtyAreas() )
+                {
+                    if( area.second.test( aLayer ) && inflatedBBox.Intersects( area.first ) )
+                        return true;
+                }
+
+                // aZones is sorted by priority so any zone we depend on has already been
+                // examined.
+                for( const std::pair<ZONE_CONTAINER*, PCB_LAYER_ID>& job : toFill )
+                {
+                    if( job.second == aLayer && check_fill_dependency( aZone, aLayer, job.first ) )
+                        return true;
+                }
+
+                return false;
+            };
+
     for( ZONE_CONTAINER* zone : aZones )
     {
         // Rule areas are not filled
         if( zone->GetIsRuleArea() )
             continue;
 
+        std::vector<PCB_LAYER_ID> layers;
+
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            if( !incremental || needs_refill( zone, layer ) )
+                layers.push_back( layer );
+        }
+
+        if( layers.empty() )
+            continue;
+
         if( m_commit )
             m_commit->Modify( zone );
 
         // calculate the hash value for filled areas. it will be used later
         // to know if the current filled areas are up to date
-        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        for( PCB_LAYER_ID layer : layers )
         {
             zone->BuildHashValue( layer );
 
@@ -163,47 +258,60 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
         islandsList.emplace_back( CN_ZONE_ISOLATED_ISLAND_LIST( zone ) );
 
         // Remove existing fill first to prevent drawing invalid polygons
-        // on some platforms
-        zone->UnFill();
+        // on some platforms.  Layers we're not refilling must keep their fill.
+        if( layers.size() == zone->GetLayerSet().count() )
+            zone->UnFill();
 
         zone->SetFillVersion( bds.m_ZoneFillVersion );
     }
 
-    size_t cores = std::thread::hardware_concurrency();
-    std::atomic<size_t> nextItem;
+    std::set<std::pair<ZONE_CONTAINER*, PCB_LAYER_ID>> refilled( toFill.begin(), toFill.end() );
 
-    auto check_fill_dependency =
-            [&]( ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer, ZONE_CONTAINER* aOtherZone ) -> bool
-            {
-                // Check to see if we have to knock-out the filled areas of a higher-priority
-                // zone.  If so we have to wait until said zone is filled before we can fill.
+    // Build the fill dependency graph once.  Each (zone, layer) job keeps a count of the
+    // higher-priority jobs it must wait for, and a list of the jobs waiting on it.  Since
+    // dependencies always point from a higher to a strictly lower priority the graph is
+    // acyclic.
+    std::vector<int>                 blockerCount( toFill.size(), 0 );
+    std::vector<std::vector<size_t>> dependents( toFill.size() );
+    std::deque<size_t>               readyJobs;
 
-                // If the other zone is already filled then we're good-to-go
-                if( aOtherZone->GetFillFlag( aLayer ) )
-                    return false;
+    for( size_t i = 0; i < toFill.size(); ++i )
+    {
+        ZONE_CONTAINER* zone = toFill[i].first;
+        PCB_LAYER_ID    layer = toFill[i].second;
+        int             count = 0;
 
-                // Even if keepouts exclude copper pours the exclusion is by outline, not by
-                // filled area, so we're good-to-go here too.
-                if( aOtherZone->GetIsRuleArea() )
-                    return false;
+        for( size_t j = 0; j < toFill.size(); ++j )
+        {
+            if( toFill[j].second != layer || toFill[j].first == zone )
+                continue;
 
-                // If the zones share no common layers
-                if( !aOtherZone->GetLayerSet().test( aLayer ) )
-                    return false;
+            if( check_fill_dependency( zone, layer, toFill[j].first ) )
+            {
+                dependents[j].push_back( i );
+                count++;
+            }
+        }
 
-                if( aOtherZone->GetPriority() <= aZone->GetPriority() )
-                    return false;
+        blockerCount[i] = count;
+    }
 
-                // Same-net zones always use outline to produce predictable results
-                if( aOtherZone->GetNetCode() == aZone->GetNetCode() )
-                    return false;
+    // toFill is sorted by priority, so jobs with no blockers are queued highest-priority
+    // first.
+    for( size_t i = 0; i < toFill.size(); ++i )
+    {
+        if( blockerCount[i] == 0 )
+            readyJobs.push_back( i );
+    }
 
-                // A higher priority zone is found: if we intersect and it's not filled yet
-                // then we have to wait.
-                EDA_RECT inflatedBBox = aZone->GetCachedBoundingBox();
-                inflatedBBox.Inflate( m_worstClearance );
+    std::mutex              readyLock;
+    std::condition_variable readyCondition;
+    std::atomic<size_t>     finishedCount( 0 );
 
-                return inflatedBBox.Intersects( aOtherZone->GetCachedBoundingBox() );
+    auto isCancelled =
+            [&]() -> bool
+            {
+                return m_progressReporter && m_progressReporter->IsCancelled();
             };
 
     auto fill_lambda =
@@ -211,90 +319,105 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
             {
                 size_t num = 0;
 
-                for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
+                while( true )
                 {
-                    PCB_LAYER_ID    layer = toFill[i].second;
-                    ZONE_CONTAINER* zone = toFill[i].first;
-                    bool            canFill = true;
+                    size_t job;
 
-                    // Check for any fill dependencies.  If our zone needs to be clipped by
-                    // another zone then we can't fill until that zone is filled.
-                    for( ZONE_CONTAINER* otherZone : aZones )
                     {
-                        if( otherZone == zone )
-                            continue;
+                        std::unique_lock<std::mutex> queueLock( readyLock );
 
-                        if( check_fill_dependency( zone, layer, otherZone ) )
+                        // Wait for a job to become available; poll periodically so that we
+                        // notice cancellation.
+                        while( readyJobs.empty() )
                         {
-                            canFill = false;
-                            break;
+                            if( finishedCount >= toFill.size() || isCancelled() )
+                                return num;
+
+                            readyCondition.wait_for( queueLock, std::chrono::milliseconds( 100 ) );
                         }
+
+                        job = readyJobs.front();
+                        readyJobs.pop_front();
                     }
 
-                    if( m_progressReporter && m_progressReporter->IsCancelled() )
+                    if( isCancelled() )
                         break;
 
-                    if( !canFill )
-                        continue;
+                    PCB_LAYER_ID    layer = toFill[job].second;
+                    ZONE_CONTAINER* zone = toFill[job].first;
 
-                    // Now we're ready to fill.
                     SHAPE_POLY_SET rawPolys, finalPolys;
                     fillSingleZone( zone, layer, rawPolys, finalPolys );
 
-                    std::unique_lock<std::mutex> zoneLock( zone->GetLock() );
+                    {
+                        std::unique_lock<std::mutex> zoneLock( zone->GetLock() );
 
-                    zone->SetRawPolysList( layer, rawPolys );
-                    zone->SetFilledPolysList( layer, finalPolys );
-                    zone->SetFillFlag( layer, true );
+                        zone->SetRawPolysList( layer, rawPolys );
+                        zone->SetFilledPolysList( layer, finalPolys );
+                        zone->SetFillFlag( layer, true );
+                    }
 
                     if( m_progressReporter )
                         m_progressReporter->AdvanceProgress();
 
                     num++;
+
+                    // Release any jobs for which this was the last outstanding blocker
+                    {
+                        std::unique_lock<std::mutex> queueLock( readyLock );
+
+                        for( size_t dependent : dependents[job] )
+                        {
+                            if( --blockerCount[dependent] == 0 )
+                                readyJobs.push_back( dependent );
+                        }
+
+                        finishedCount++;
+                    }
+
+                    readyCondition.notify_all();
                 }
 
                 return num;
             };
 
-    while( !toFill.empty() )
+    size_t fillThreadCount = std::min( cores, toFill.size() );
+
+    // Leave the cores which no zone can use to the tiles of large zones
+    m_tileThreadCount = std::max<size_t>( 1, cores / std::max<size_t>( 1, fillThreadCount ) );
+
+    // Nothing on the board moves while filling, so resolved clearances can be shared
+    if( bds.m_DRCEngine )
+        bds.m_DRCEngine->SetConstraintCaching( true );
+
+    if( fillThreadCount <= 1 )
     {
-        size_t parallelThreadCount = std::min( cores, toFill.size() );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
+        fill_lambda( m_progressReporter );
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( fillThreadCount );
 
-        nextItem = 0;
+        for( size_t ii = 0; ii < fillThreadCount; ++ii )
+            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
 
-        if( parallelThreadCount <= 1 )
-            fill_lambda( m_progressReporter );
-        else
+        for( size_t ii = 0; ii < fillThreadCount; ++ii )
         {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
-
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+            // Here we balance returns with a 100ms timeout to allow UI updating
+            std::future_status status;
+            do
             {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
-                {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+                if( m_progressReporter )
+                    m_progressReporter->KeepRefreshing();
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
+                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
+            } while( status != std::future_status::ready );
         }
-
-        toFill.erase( std::remove_if( toFill.begin(), toFill.end(),
-                      [&] ( const std::pair<ZONE_CONTAINER*, PCB_LAYER_ID> pair ) -> bool
-                      {
-                          return pair.first->GetFillFlag( pair.second );
-                      } ),
-                      toFill.end() );
-
-        if( m_progressReporter && m_progressReporter->IsCancelled() )
-            break;
     }
 
+    if( bds.m_DRCEngine )
+        bds.m_DRCEngine->SetConstraintCaching( false );
+
     // Now update the connectivity to check for copper islands
     if( m_progressReporter )
     {
@@ -330,7 +453,7 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
             if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
                 continue;
 
-            if( !zone.m_islands.count( layer ) )
+            if( !refilled.count( { zone.m_zone, layer } ) || !zone.m_islands.count( layer ) )
                 continue;
 
             std::vector<int>& islands = zone.m_islands.at( layer );
@@ -345,11 +468,10 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
 
             for( int idx : islands )
             {
-                SHAPE_LINE_CHAIN& outline = poly.Outline( idx );
-
                 if( mode == ISLAND_REMOVAL_MODE::ALWAYS )
                     poly.DeletePolygon( idx );
-                else if ( mode == ISLAND_REMOVAL_MODE::AREA && outline.Area() < minArea )
+                else if( mode == ISLAND_REMOVAL_MODE::AREA
+                         && poly.COutline( idx ).Area() < minArea )
                     poly.DeletePolygon( idx );
                 else
                     zone.m_zone->SetIsIsland( layer, idx );
@@ -373,11 +495,14 @@ bool ZONE_FILLER::Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck, wxWin
             if( m_debugZoneFiller && LSET::InternalCuMask().Contains( layer ) )
                 continue;
 
+            if( !refilled.count( { zone, layer } ) )
+                continue;
+
             SHAPE_POLY_SET poly = zone->GetFilledPolysList( layer );
 
             for( int ii = poly.OutlineCount() - 1; ii >= 0; ii-- )
             {
-                std::vector<SHAPE_LINE_CHAIN>& island = poly.Polygon( ii );
+                const SHAPE_POLY_SET::POLYGON& island = poly.CPolygon( ii );
 
                 if( island.empty() || !m_boardOutline.Contains( island.front().CPoint( 0 ) ) )
                     poly.DeletePolygon( ii );
@@ -607,14 +732,84 @@ void ZONE_FILLER::addKnockout( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap,
 
 
 /**
- * Removes thermal reliefs from the shape for any pads connected to the zone.  Does NOT add
- * in spokes, which must be done later.
+ * Add a knockout for a pad, via or track, 'aGap' larger than the item.  If the item isn't
+ * flashed on the layer but has a hole then the knockout is for the hole.  Knockouts are
+ * shared through the board's knockout cache, so stacked zones and later refills don't have
+ * to rebuild them.
  */
-void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
-                                          SHAPE_POLY_SET& aFill )
+void ZONE_FILLER::addCachedKnockout( BOARD_CONNECTED_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap,
+                                     SHAPE_POLY_SET& aHoles )
 {
-    SHAPE_POLY_SET holes;
+    ZONE_KNOCKOUT_CACHE& cache = m_board->GetZoneKnockoutCache();
 
+    if( cache.Get( aItem, aLayer, aGap, m_maxError, aHoles ) )
+        return;
+
+    BOARD_DESIGN_SETTINGS& bds = m_board->GetDesignSettings();
+    SHAPE_POLY_SET         knockout;
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        D_PAD* pad = static_cast<D_PAD*>( aItem );
+
+        if( pad->FlashLayer( aLayer ) )
+        {
+            addKnockout( pad, aLayer, aGap, knockout );
+        }
+        else if( pad->GetDrillSize().x != 0 || pad->GetDrillSize().y != 0 )
+        {
+            int gap = aGap;
+
+            // Note: drill size represents finish size, which means the actual hole size is
+            // the plating thickness larger.
+            if( pad->GetAttribute() == PAD_ATTRIB_PTH )
+                gap += bds.GetHolePlatingThickness();
+
+            pad->TransformHoleWithClearanceToPolygon( knockout, gap, m_maxError, ERROR_OUTSIDE );
+        }
+
+        break;
+    }
+
+    case PCB_VIA_T:
+    {
+        VIA* via = static_cast<VIA*>( aItem );
+
+        if( via->FlashLayer( aLayer ) )
+        {
+            via->TransformShapeWithClearanceToPolygon( knockout, aLayer, aGap, m_maxError,
+                                                       ERROR_OUTSIDE );
+        }
+        else
+        {
+            int radius = via->GetDrillValue() / 2 + bds.GetHolePlatingThickness();
+            TransformCircleToPolygon( knockout, via->GetPosition(), radius + aGap, m_maxError,
+                                      ERROR_OUTSIDE );
+        }
+
+        break;
+    }
+
+    default:
+        aItem->TransformShapeWithClearanceToPolygon( knockout, aLayer, aGap, m_maxError,
+                                                     ERROR_OUTSIDE );
+        break;
+    }
+
+    cache.Add( aItem, aLayer, aGap, m_maxError, knockout );
+    aHoles.Append( knockout );
+}
+
+
+/**
+ * Builds the thermal relief holes for any pads connected to the zone.  Does NOT add in
+ * spokes, which must be done later.
+ */
+void ZONE_FILLER::buildThermalReliefHoles( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
+                                           SHAPE_POLY_SET& aHoles )
+{
     for( MODULE* module : m_board->Modules() )
     {
         for( D_PAD* pad : module->Pads() )
@@ -622,30 +817,73 @@ void ZONE_FILLER::knockoutThermalReliefs( const ZONE_CONTAINER* aZone, PCB_LAYER
             if( !hasThermalConnection( pad, aZone ) )
                 continue;
 
-            int gap = aZone->GetThermalReliefGap( pad );
+            // If the pad isn't on the current layer but has a hole, this knocks out a thermal
+            // relief for the hole.
+            addCachedKnockout( pad, aLayer, aZone->GetThermalReliefGap( pad ), aHoles );
+        }
+    }
+}
+
+
+/**
+ * Builds per-layer R-trees of the pads, tracks and graphic items which may knock out copper,
+ * so that finding the knockouts of a zone is proportional to the size of its neighbourhood
+ * rather than to the size of the board.
+ */
+void ZONE_FILLER::buildKnockoutIndex()
+{
+    m_knockoutTrees.clear();
+    m_knockoutTrees.resize( PCB_LAYER_ID_COUNT );
+
+    for( PCB_LAYER_ID layer : LSET::AllCuMask().Seq() )
+        m_knockoutTrees[layer] = std::make_unique<KNOCKOUT_RTREE>();
 
-            // If the pad isn't on the current layer but has a hole, knock out a thermal relief
-            // for the hole.
-            if( !pad->FlashLayer( aLayer ) )
+    auto insert =
+            [&]( BOARD_ITEM* aItem, LSET aLayers )
             {
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
+                EDA_RECT bbox = aItem->GetBoundingBox();
+                bbox.Normalize();
 
-                // Note: drill size represents finish size, which means the actual holes size is
-                // the plating thickness larger.
-                if( pad->GetAttribute() == PAD_ATTRIB_PTH )
-                    gap += pad->GetBoard()->GetDesignSettings().GetHolePlatingThickness();
+                const int mmin[2] = { bbox.GetX(), bbox.GetY() };
+                const int mmax[2] = { bbox.GetRight(), bbox.GetBottom() };
 
-                pad->TransformHoleWithClearanceToPolygon( holes, gap, m_maxError, ERROR_OUTSIDE );
-            }
-            else
+                for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+                    m_knockoutTrees[layer]->Insert( mmin, mmax, aItem );
+            };
+
+    // Items on Edge_Cuts knock out copper on every layer
+    auto insertGraphic =
+            [&]( BOARD_ITEM* aItem )
             {
-                addKnockout( pad, aLayer, gap, holes );
-            }
+                if( aItem->IsOnLayer( Edge_Cuts ) )
+                    insert( aItem, LSET::AllCuMask() );
+                else
+                    insert( aItem, aItem->GetLayerSet() );
+            };
+
+    for( MODULE* module : m_board->Modules() )
+    {
+        for( D_PAD* pad : module->Pads() )
+        {
+            // Pad holes are knocked out on layers where the pad isn't flashed
+            if( pad->GetDrillSize().x > 0 || pad->GetDrillSize().y > 0 )
+                insert( pad, LSET::AllCuMask() );
+            else
+                insert( pad, pad->GetLayerSet() );
         }
+
+        insertGraphic( &module->Reference() );
+        insertGraphic( &module->Value() );
+
+        for( BOARD_ITEM* item : module->GraphicalItems() )
+            insertGraphic( item );
     }
 
-    aFill.BooleanSubtract( holes, SHAPE_POLY_SET::PM_FAST );
+    for( TRACK* track : m_board->Tracks() )
+        insert( track, track->GetLayerSet() );
+
+    for( BOARD_ITEM* item : m_board->Drawings() )
+        insertGraphic( item );
 }
 
 
@@ -707,44 +945,12 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, PCB_LA
 
                     gap += extra_margin;
 
-                    // If the pad isn't on the current layer but has a hole, knock out the
-                    // hole.
-                    if( !aPad->FlashLayer( aLayer ) )
-                    {
-                        if( aPad->GetDrillSize().x == 0 && aPad->GetDrillSize().y == 0 )
-                            return;
-
-                        // Note: drill size represents finish size, which means the actual hole
-                        // size is the plating thickness larger.
-                        if( aPad->GetAttribute() == PAD_ATTRIB_PTH )
-                            gap += aPad->GetBoard()->GetDesignSettings().GetHolePlatingThickness();
-
-                        aPad->TransformHoleWithClearanceToPolygon( aHoles, gap, m_maxError,
-                                                                   ERROR_OUTSIDE );
-                    }
-                    else
-                    {
-                        addKnockout( aPad, aLayer, gap, aHoles );
-                    }
+                    // If the pad isn't on the current layer but has a hole, this knocks out
+                    // the hole.
+                    addCachedKnockout( aPad, aLayer, gap, aHoles );
                 }
             };
 
-    for( MODULE* module : m_board->Modules() )
-    {
-        for( D_PAD* pad : module->Pads() )
-        {
-            if( checkForCancel( m_progressReporter ) )
-                return;
-
-            if( pad->GetNetCode() != aZone->GetNetCode()
-                    || pad->GetNetCode() <= 0
-                    || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
-            {
-                knockoutPadClearance( pad );
-            }
-        }
-    }
-
     // Add non-connected track clearances
     //
     auto knockoutTrackClearance =
@@ -756,44 +962,10 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, PCB_LA
 
                     gap += extra_margin;
 
-                    if( aTrack->Type() == PCB_VIA_T )
-                    {
-                        VIA* via = static_cast<VIA*>( aTrack );
-
-                        if( !via->FlashLayer( aLayer ) )
-                        {
-                            int radius = via->GetDrillValue() / 2 + bds.GetHolePlatingThickness();
-                            TransformCircleToPolygon( aHoles, via->GetPosition(), radius + gap,
-                                                      m_maxError, ERROR_OUTSIDE );
-                        }
-                        else
-                        {
-                            via->TransformShapeWithClearanceToPolygon( aHoles, aLayer, gap,
-                                                                       m_maxError, ERROR_OUTSIDE );
-                        }
-                    }
-                    else
-                    {
-                        aTrack->TransformShapeWithClearanceToPolygon( aHoles, aLayer, gap,
-                                                                      m_maxError, ERROR_OUTSIDE );
-                    }
+                    addCachedKnockout( aTrack, aLayer, gap, aHoles );
                 }
             };
 
-    for( TRACK* track : m_board->Tracks() )
-    {
-        if( !track->IsOnLayer( aLayer ) )
-            continue;
-
-        if( track->GetNetCode() == aZone->GetNetCode()  && ( aZone->GetNetCode() != 0) )
-            continue;
-
-        if( checkForCancel( m_progressReporter ) )
-            return;
-
-        knockoutTrackClearance( track );
-    }
-
     // Add graphic item clearances.  They are by definition unconnected, and have no clearance
     // definitions of their own.
     //
@@ -818,27 +990,59 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, PCB_LA
                 }
             };
 
-    for( MODULE* module : m_board->Modules() )
-    {
-        knockoutGraphicClearance( &module->Reference() );
-        knockoutGraphicClearance( &module->Value() );
+    // Visit the pads, tracks and graphic items in the neighbourhood of the zone
+    //
+    const int mmin[2] = { zone_boundingbox.GetX(), zone_boundingbox.GetY() };
+    const int mmax[2] = { zone_boundingbox.GetRight(), zone_boundingbox.GetBottom() };
+    bool      cancelled = false;
 
-        for( BOARD_ITEM* item : module->GraphicalItems() )
-        {
-            if( checkForCancel( m_progressReporter ) )
-                return;
+    m_knockoutTrees[aLayer]->Search( mmin, mmax,
+            [&]( BOARD_ITEM* aItem ) -> bool
+            {
+                if( checkForCancel( m_progressReporter ) )
+                {
+                    cancelled = true;
+                    return false;
+                }
 
-            knockoutGraphicClearance( item );
-        }
-    }
+                switch( aItem->Type() )
+                {
+                case PCB_PAD_T:
+                {
+                    D_PAD* pad = static_cast<D_PAD*>( aItem );
 
-    for( BOARD_ITEM* item : m_board->Drawings() )
-    {
-        if( checkForCancel( m_progressReporter ) )
-            return;
+                    if( pad->GetNetCode() != aZone->GetNetCode()
+                            || pad->GetNetCode() <= 0
+                            || aZone->GetPadConnection( pad ) == ZONE_CONNECTION::NONE )
+                    {
+                        knockoutPadClearance( pad );
+                    }
 
-        knockoutGraphicClearance( item );
-    }
+                    break;
+                }
+
+                case PCB_TRACE_T:
+                case PCB_ARC_T:
+                case PCB_VIA_T:
+                {
+                    TRACK* track = static_cast<TRACK*>( aItem );
+
+                    if( track->GetNetCode() != aZone->GetNetCode() || aZone->GetNetCode() == 0 )
+                        knockoutTrackClearance( track );
+
+                    break;
+                }
+
+                default:
+                    knockoutGraphicClearance( aItem );
+                    break;
+                }
+
+                return true;
+            } );
+
+    if( cancelled )
+        return;
 
     // Add non-connected zone clearances
     //
@@ -914,7 +1118,8 @@ void ZONE_FILLER::buildCopperItemClearances( const ZONE_CONTAINER* aZone, PCB_LA
         }
     }
 
-    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+    // This runs on one of the zone filling threads, so only use the cores they left over
+    aHoles.BatchUnion( SHAPE_POLY_SET::PM_FAST, m_tileThreadCount );
 }
 
 
@@ -984,6 +1189,10 @@ void ZONE_FILLER::subtractHigherPriorityZones( const ZONE_CONTAINER* aZone, PCB_
  * 4 - Knocks out unconnected copper items, deleting any affected spokes
  * 5 - Removes unconnected copper islands, deleting any affected spokes
  * 6 - Adds in the remaining spokes
+ *
+ * Steps 4 to 6 are performed by fillWithKnockouts(), either for the whole zone at once or
+ * concurrently for a set of overlapping tiles if the zone is larger than the configured tile
+ * size.
  */
 bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
                                         PCB_LAYER_ID aLayer, PCB_LAYER_ID aDebugLayer,
@@ -993,6 +1202,201 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 {
     m_maxError = m_board->GetDesignSettings().m_MaxError;
 
+    std::deque<SHAPE_LINE_CHAIN> thermalSpokes;
+    SHAPE_POLY_SET thermalHoles;
+    SHAPE_POLY_SET clearanceHoles;
+
+    aRawPolys = aSmoothedOutline;
+    DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In1_Cu, "smoothed-outline" );
+
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return false;
+
+    buildThermalReliefHoles( aZone, aLayer, thermalHoles );
+
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return false;
+
+    buildCopperItemClearances( aZone, aLayer, clearanceHoles );
+    DUMP_POLYS_TO_COPPER_LAYER( clearanceHoles, In3_Cu, "clearance-holes" );
+
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return false;
+
+    buildThermalSpokes( aZone, aLayer, thermalSpokes );
+
+    if( m_progressReporter && m_progressReporter->IsCancelled() )
+        return false;
+
+    int   tileSize = Millimeter2iu( ADVANCED_CFG::GetCfg().m_ZoneFillTileSize );
+    BOX2I zoneBBox = aSmoothedOutline.BBox();
+
+    // Hatch patterns are aligned to the bounding box of the fill, so they can't be tiled.
+    // Nor can debug dumps, which are only meaningful for a whole zone.
+    if( tileSize <= 0 || m_debugZoneFiller
+            || aZone->GetFillMode() == ZONE_FILL_MODE::HATCH_PATTERN
+            || ( zoneBBox.GetWidth() <= tileSize && zoneBBox.GetHeight() <= tileSize ) )
+    {
+        if( !fillWithKnockouts( aZone, aLayer, aDebugLayer, aMaxExtents, thermalHoles,
+                                clearanceHoles, thermalSpokes, aRawPolys ) )
+        {
+            return false;
+        }
+
+        aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+        return true;
+    }
+
+    // Each tile is filled with a margin around it so that min-width pruning and thermal spoke
+    // hit-testing near the tile edges see the same surroundings as they would in an untiled
+    // fill.  The margin is then trimmed off before the tiles are stitched back together.
+    int margin = 2 * aZone->GetMinThickness();
+
+    for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
+    {
+        BOX2I spokeBBox = spoke.BBox();
+        margin = std::max( margin, 2 * aZone->GetMinThickness()
+                                        + (int) std::max( spokeBBox.GetWidth(),
+                                                          spokeBBox.GetHeight() ) );
+    }
+
+    // Keep only those parts of a polygon set whose bounding box touches the given area
+    auto clipToArea =
+            []( const SHAPE_POLY_SET& aPolys, const BOX2I& aArea ) -> SHAPE_POLY_SET
+            {
+                SHAPE_POLY_SET result;
+
+                for( int ii = 0; ii < aPolys.OutlineCount(); ++ii )
+                {
+                    if( !aPolys.COutline( ii ).BBox().Intersects( aArea ) )
+                        continue;
+
+                    int outline = result.AddOutline( aPolys.COutline( ii ) );
+
+                    for( int jj = 0; jj < aPolys.HoleCount( ii ); ++jj )
+                        result.AddHole( aPolys.CHole( ii, jj ), outline );
+                }
+
+                return result;
+            };
+
+    std::vector<BOX2I> tiles;
+
+    for( int x = zoneBBox.GetX(); x < zoneBBox.GetRight(); x += tileSize )
+    {
+        for( int y = zoneBBox.GetY(); y < zoneBBox.GetBottom(); y += tileSize )
+            tiles.emplace_back( VECTOR2I( x, y ), VECTOR2I( tileSize, tileSize ) );
+    }
+
+    std::vector<SHAPE_POLY_SET> tileFills( tiles.size() );
+    std::atomic<size_t>         nextTile( 0 );
+    std::atomic<bool>           failed( false );
+
+    auto tile_lambda =
+            [&]() -> size_t
+            {
+                size_t num = 0;
+
+                for( size_t i = nextTile++; i < tiles.size(); i = nextTile++ )
+                {
+                    BOX2I workArea = tiles[i];
+                    workArea.Inflate( margin );
+
+                    SHAPE_POLY_SET workRect;
+                    workRect.NewOutline();
+                    workRect.Append( workArea.GetLeft(), workArea.GetTop() );
+                    workRect.Append( workArea.GetRight(), workArea.GetTop() );
+                    workRect.Append( workArea.GetRight(), workArea.GetBottom() );
+                    workRect.Append( workArea.GetLeft(), workArea.GetBottom() );
+
+                    SHAPE_POLY_SET tileRect;
+                    tileRect.NewOutline();
+                    tileRect.Append( tiles[i].GetLeft(), tiles[i].GetTop() );
+                    tileRect.Append( tiles[i].GetRight(), tiles[i].GetTop() );
+                    tileRect.Append( tiles[i].GetRight(), tiles[i].GetBottom() );
+                    tileRect.Append( tiles[i].GetLeft(), tiles[i].GetBottom() );
+
+                    SHAPE_POLY_SET tileFill = aSmoothedOutline;
+                    tileFill.BooleanIntersection( workRect, SHAPE_POLY_SET::PM_FAST );
+
+                    if( tileFill.IsEmpty() )
+                        continue;
+
+                    SHAPE_POLY_SET tileExtents = aMaxExtents;
+                    tileExtents.BooleanIntersection( tileRect, SHAPE_POLY_SET::PM_FAST );
+
+                    std::deque<SHAPE_LINE_CHAIN> tileSpokes;
+
+                    for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
+                    {
+                        if( spoke.BBox().Intersects( workArea ) )
+                            tileSpokes.push_back( spoke );
+                    }
+
+                    if( !fillWithKnockouts( aZone, aLayer, aDebugLayer, tileExtents,
+                                            clipToArea( thermalHoles, workArea ),
+                                            clipToArea( clearanceHoles, workArea ),
+                                            tileSpokes, tileFill ) )
+                    {
+                        failed = true;
+                        break;
+                    }
+
+                    tileFills[i] = std::move( tileFill );
+                    num++;
+                }
+
+                return num;
+            };
+
+    // This already runs on one of the zone filling threads
+    size_t parallelThreadCount = std::min( m_tileThreadCount, tiles.size() );
+
+    if( parallelThreadCount <= 1 )
+    {
+        tile_lambda();
+    }
+    else
+    {
+        std::vector<std::future<size_t>> returns( parallelThreadCount - 1 );
+
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+            returns[ii] = std::async( std::launch::async, tile_lambda );
+
+        tile_lambda();
+
+        for( size_t ii = 0; ii < returns.size(); ++ii )
+            returns[ii].wait();
+    }
+
+    if( failed )
+        return false;
+
+    aRawPolys.RemoveAllContours();
+
+    for( const SHAPE_POLY_SET& tileFill : tileFills )
+        aRawPolys.Append( tileFill );
+
+    aRawPolys.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+    return true;
+}
+
+
+/**
+ * Knocks thermal reliefs and clearance holes out of aRawPolys (which must initially contain
+ * the smoothed zone outline or a part of it), adds in the thermal spokes which still connect
+ * to the remaining copper, and prunes features narrower than the zone's minimum width.  The
+ * result is limited to aMaxExtents and is not fractured.
+ */
+bool ZONE_FILLER::fillWithKnockouts( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
+                                     PCB_LAYER_ID aDebugLayer,
+                                     const SHAPE_POLY_SET& aMaxExtents,
+                                     const SHAPE_POLY_SET& aThermalHoles,
+                                     const SHAPE_POLY_SET& aClearanceHoles,
+                                     const std::deque<SHAPE_LINE_CHAIN>& aThermalSpokes,
+                                     SHAPE_POLY_SET& aRawPolys )
+{
     // Features which are min_width should survive pruning; features that are *less* than
     // min_width should not.  Therefore we subtract epsilon from the min_width when
     // deflating/inflating.
@@ -1013,29 +1417,9 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     SHAPE_POLY_SET::CORNER_STRATEGY fastCornerStrategy = SHAPE_POLY_SET::CHAMFER_ALL_CORNERS;
     SHAPE_POLY_SET::CORNER_STRATEGY cornerStrategy = SHAPE_POLY_SET::ROUND_ALL_CORNERS;
 
-    std::deque<SHAPE_LINE_CHAIN> thermalSpokes;
-    SHAPE_POLY_SET clearanceHoles;
-
-    aRawPolys = aSmoothedOutline;
-    DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In1_Cu, "smoothed-outline" );
-
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
-        return false;
-
-    knockoutThermalReliefs( aZone, aLayer, aRawPolys );
+    aRawPolys.BooleanSubtract( aThermalHoles, SHAPE_POLY_SET::PM_FAST );
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In2_Cu, "minus-thermal-reliefs" );
 
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
-        return false;
-
-    buildCopperItemClearances( aZone, aLayer, clearanceHoles );
-    DUMP_POLYS_TO_COPPER_LAYER( clearanceHoles, In3_Cu, "clearance-holes" );
-
-    if( m_progressReporter && m_progressReporter->IsCancelled() )
-        return false;
-
-    buildThermalSpokes( aZone, aLayer, thermalSpokes );
-
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return false;
 
@@ -1043,7 +1427,7 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     // because the "real" subtract-clearance-holes has to be done after the spokes are added.
     static const bool USE_BBOX_CACHES = true;
     SHAPE_POLY_SET testAreas = aRawPolys;
-    testAreas.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    testAreas.BooleanSubtract( aClearanceHoles, SHAPE_POLY_SET::PM_FAST );
     DUMP_POLYS_TO_COPPER_LAYER( testAreas, In4_Cu, "minus-clearance-holes" );
 
     // Prune features that don't meet minimum-width criteria
@@ -1066,7 +1450,7 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
 
     SHAPE_POLY_SET debugSpokes;
 
-    for( const SHAPE_LINE_CHAIN& spoke : thermalSpokes )
+    for( const SHAPE_LINE_CHAIN& spoke : aThermalSpokes )
     {
         const VECTOR2I& testPt = spoke.CPoint( 3 );
 
@@ -1089,7 +1473,7 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
         }
 
         // Hit-test against other spokes
-        for( const SHAPE_LINE_CHAIN& other : thermalSpokes )
+        for( const SHAPE_LINE_CHAIN& other : aThermalSpokes )
         {
             if( &other != &spoke && other.PointInside( testPt, 1, USE_BBOX_CACHES  ) )
             {
@@ -1107,7 +1491,7 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     if( m_progressReporter && m_progressReporter->IsCancelled() )
         return false;
 
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    aRawPolys.BooleanSubtract( aClearanceHoles, SHAPE_POLY_SET::PM_FAST );
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In8_Cu, "after-spoke-trimming" );
 
     // Prune features that don't meet minimum-width criteria
@@ -1146,14 +1530,13 @@ bool ZONE_FILLER::computeRawFilledArea( const ZONE_CONTAINER* aZone,
     // add copper outside the zone boundary or inside the clearance holes
     aRawPolys.BooleanIntersection( aMaxExtents, SHAPE_POLY_SET::PM_FAST );
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In16_Cu, "after-trim-to-outline" );
-    aRawPolys.BooleanSubtract( clearanceHoles, SHAPE_POLY_SET::PM_FAST );
+    aRawPolys.BooleanSubtract( aClearanceHoles, SHAPE_POLY_SET::PM_FAST );
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In17_Cu, "after-trim-to-clearance-holes" );
 
     // Lastly give any same-net but higher-priority zones control over their own area.
     subtractHigherPriorityZones( aZone, aLayer, aRawPolys );
     DUMP_POLYS_TO_COPPER_LAYER( aRawPolys, In18_Cu, "minus-higher-priority-zones" );
 
-    aRawPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
     return true;
 }
 
@@ -1351,6 +1734,128 @@ void ZONE_FILLER::buildThermalSpokes( const ZONE_CONTAINER* aZone, PCB_LAYER_ID
 }
 
 
+enum class HATCH_CELL
+{
+    OUTSIDE,
+    INSIDE,
+    BOUNDARY
+};
+
+
+static int64_t floorDiv( int64_t aNum, int64_t aDenom )
+{
+    int64_t q = aNum / aDenom;
+    return ( aNum % aDenom != 0 && ( ( aNum < 0 ) != ( aDenom < 0 ) ) ) ? q - 1 : q;
+}
+
+
+/**
+ * Classify the cells of a hatch grid against \a aArea with one scanline per row of cells.
+ *
+ * Cell (col, row) covers aCellSize x aCellSize starting at aOrigin + (col, row) * aPitch.
+ * A cell which is crossed by an edge of \a aArea is a BOUNDARY cell; any other cell is
+ * entirely INSIDE or OUTSIDE, which is decided by the crossings of the row's centre line.
+ * Cells are returned in row-major order.
+ */
+static void classifyHatchCells( const SHAPE_POLY_SET& aArea, const VECTOR2I& aOrigin, int aPitch,
+                                int aCellSize, int aColumns, int aRows,
+                                std::vector<HATCH_CELL>& aCells )
+{
+    // Tolerance for the rounding of the (rotated) area coordinates
+    const int margin = 2;
+
+    std::vector<std::vector<std::pair<int, int>>> edgeSpans( aRows );
+    std::vector<std::vector<double>>              crossings( aRows );
+
+    auto addEdge =
+            [&]( const VECTOR2I& a, const VECTOR2I& b )
+            {
+                int64_t ymin = std::min( a.y, b.y ) - margin - aOrigin.y;
+                int64_t ymax = std::max( a.y, b.y ) + margin - aOrigin.y;
+                int     firstRow = std::max<int64_t>( 0, floorDiv( ymin - aCellSize + aPitch - 1,
+                                                                  aPitch ) );
+                int     lastRow = std::min<int64_t>( aRows - 1, floorDiv( ymax, aPitch ) );
+
+                for( int row = firstRow; row <= lastRow; ++row )
+                {
+                    double bandTop = aOrigin.y + (double) row * aPitch;
+                    double bandBottom = bandTop + aCellSize;
+                    double xlo = std::min( a.x, b.x );
+                    double xhi = std::max( a.x, b.x );
+
+                    if( a.y != b.y )
+                    {
+                        // Clip the edge to the band to get its horizontal extent in this row
+                        auto xAt = [&]( double y )
+                                   {
+                                       y = Clamp<double>( std::min( a.y, b.y ), y,
+                                                          std::max( a.y, b.y ) );
+                                       return a.x + ( y - a.y ) * ( b.x - a.x ) / ( b.y - a.y );
+                                   };
+
+                        double x0 = xAt( bandTop - margin );
+                        double x1 = xAt( bandBottom + margin );
+                        xlo = std::min( x0, x1 );
+                        xhi = std::max( x0, x1 );
+
+                        // Half-unit offset so the centre line never passes through a vertex
+                        double centre = bandTop + aCellSize / 2.0 + 0.5;
+
+                        if( ( a.y > centre ) != ( b.y > centre ) )
+                            crossings[row].push_back( xAt( centre ) );
+                    }
+
+                    edgeSpans[row].emplace_back( KiROUND( xlo ) - margin, KiROUND( xhi ) + margin );
+                }
+            };
+
+    for( int ii = 0; ii < aArea.OutlineCount(); ++ii )
+    {
+        for( int jj = -1; jj < aArea.HoleCount( ii ); ++jj )
+        {
+            const SHAPE_LINE_CHAIN& chain = jj < 0 ? aArea.COutline( ii ) : aArea.CHole( ii, jj );
+
+            for( int kk = 0; kk < chain.PointCount(); ++kk )
+                addEdge( chain.CPoint( kk ), chain.CPoint( ( kk + 1 ) % chain.PointCount() ) );
+        }
+    }
+
+    aCells.assign( (size_t) aColumns * aRows, HATCH_CELL::OUTSIDE );
+
+    for( int row = 0; row < aRows; ++row )
+    {
+        std::vector<std::pair<int, int>>& spans = edgeSpans[row];
+        std::vector<double>&              xings = crossings[row];
+
+        std::sort( spans.begin(), spans.end() );
+        std::sort( xings.begin(), xings.end() );
+
+        size_t spanIdx = 0;
+        size_t xingIdx = 0;
+        int    spanReach = std::numeric_limits<int>::min();   // furthest end of spans so far
+
+        for( int col = 0; col < aColumns; ++col )
+        {
+            int left = aOrigin.x + col * aPitch;
+            int right = left + aCellSize;
+
+            while( spanIdx < spans.size() && spans[spanIdx].first <= right )
+                spanReach = std::max( spanReach, spans[spanIdx++].second );
+
+            while( xingIdx < xings.size() && xings[xingIdx] < left )
+                ++xingIdx;
+
+            HATCH_CELL& cell = aCells[(size_t) row * aColumns + col];
+
+            if( spanReach >= left )
+                cell = HATCH_CELL::BOUNDARY;
+            else if( xingIdx % 2 )
+                cell = HATCH_CELL::INSIDE;
+        }
+    }
+}
+
+
 bool ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
                                           PCB_LAYER_ID aDebugLayer, SHAPE_POLY_SET& aRawPolys )
 {
@@ -1452,53 +1957,69 @@ bool ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, PCB_LAYER
         }
     }
 
-    // Build holes
-    SHAPE_POLY_SET holes;
+    int outline_margin = aZone->GetMinThickness() * 1.1;
 
-    for( int xx = 0; ; xx++ )
-    {
-        int xpos = xx * gridsize;
+    // Using GetHatchThickness() can look more consistent than GetMinThickness().
+    if( aZone->GetHatchBorderAlgorithm() && aZone->GetHatchThickness() > outline_margin )
+        outline_margin = aZone->GetHatchThickness();
+
+    // Holes are clipped to the fill, deflated by anything beyond GetMinThickness() (which it
+    // has already been deflated by), and to the deflated zone outline.
+    SHAPE_POLY_SET holeArea = aRawPolys;
+    holeArea.Deflate( outline_margin - aZone->GetMinThickness(), 16 );
+
+    SHAPE_POLY_SET deflatedOutline = *aZone->Outline();
+    deflatedOutline.Deflate( outline_margin, 16 );
+    holeArea.BooleanIntersection( deflatedOutline, SHAPE_POLY_SET::PM_FAST );
+    DUMP_POLYS_TO_COPPER_LAYER( holeArea, In11_Cu, "hatch-hole-area" );
 
-        if( xpos > bbox.GetWidth() )
-            break;
+    // Build holes.  Rather than clipping the whole grid against the hole area, a scanline
+    // pass sorts the grid cells so that only the ones on its boundary need to be clipped.
+    int columns = bbox.GetWidth() / gridsize + 1;
+    int rows = bbox.GetHeight() / gridsize + 1;
 
-        for( int yy = 0; ; yy++ )
+    SHAPE_POLY_SET rotatedHoleArea = holeArea;
+
+    if( orientation != 0.0 )
+        rotatedHoleArea.Rotate( M_PI / 180.0 * orientation, VECTOR2I( 0, 0 ) );
+
+    std::vector<HATCH_CELL> cells;
+    classifyHatchCells( rotatedHoleArea, bbox.GetPosition(), gridsize, hole_size, columns, rows,
+                        cells );
+
+    SHAPE_POLY_SET holes;
+    SHAPE_POLY_SET boundaryHoles;
+
+    for( int yy = 0; yy < rows; yy++ )
+    {
+        for( int xx = 0; xx < columns; xx++ )
         {
-            int ypos = yy * gridsize;
+            HATCH_CELL cell = cells[(size_t) yy * columns + xx];
 
-            if( ypos > bbox.GetHeight() )
-                break;
+            if( cell == HATCH_CELL::OUTSIDE )
+                continue;
 
             // Generate hole
             SHAPE_LINE_CHAIN hole( hole_base );
-            hole.Move( VECTOR2I( xpos, ypos ) );
-            holes.AddOutline( hole );
+            hole.Move( bbox.GetPosition() + VECTOR2I( xx * gridsize, yy * gridsize ) );
+
+            if( cell == HATCH_CELL::INSIDE )
+                holes.AddOutline( hole );
+            else
+                boundaryHoles.AddOutline( hole );
         }
     }
 
-    holes.Move( bbox.GetPosition() );
-
     if( orientation != 0.0 )
+    {
         holes.Rotate( -M_PI/180.0 * orientation, VECTOR2I( 0,0 ) );
+        boundaryHoles.Rotate( -M_PI/180.0 * orientation, VECTOR2I( 0,0 ) );
+    }
 
-    DUMP_POLYS_TO_COPPER_LAYER( holes, In10_Cu, "hatch-holes" );
-
-    int outline_margin = aZone->GetMinThickness() * 1.1;
-
-    // Using GetHatchThickness() can look more consistent than GetMinThickness().
-    if( aZone->GetHatchBorderAlgorithm() && aZone->GetHatchThickness() > outline_margin )
-        outline_margin = aZone->GetHatchThickness();
-
-    // The fill has already been deflated to ensure GetMinThickness() so we just have to
-    // account for anything beyond that.
-    SHAPE_POLY_SET deflatedFilledPolys = aRawPolys;
-    deflatedFilledPolys.Deflate( outline_margin - aZone->GetMinThickness(), 16 );
-    holes.BooleanIntersection( deflatedFilledPolys, SHAPE_POLY_SET::PM_FAST );
-    DUMP_POLYS_TO_COPPER_LAYER( holes, In11_Cu, "fill-clipped-hatch-holes" );
+    DUMP_POLYS_TO_COPPER_LAYER( boundaryHoles, In10_Cu, "boundary-hatch-holes" );
 
-    SHAPE_POLY_SET deflatedOutline = *aZone->Outline();
-    deflatedOutline.Deflate( outline_margin, 16 );
-    holes.BooleanIntersection( deflatedOutline, SHAPE_POLY_SET::PM_FAST );
+    boundaryHoles.BooleanIntersection( holeArea, SHAPE_POLY_SET::PM_FAST );
+    holes.Append( boundaryHoles );
     DUMP_POLYS_TO_COPPER_LAYER( holes, In12_Cu, "outline-clipped-hatch-holes" );
 
     if( aZone->GetNetCode() != 0 )
@@ -26,11 +26,15 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <deque>
+#include <memory>
 #include <vector>
 #include <class_zone.h>
+#include <geometry/rtree.h>
 
 class WX_PROGRESS_REPORTER;
 class BOARD;
+class BOARD_CONNECTED_ITEM;
 class COMMIT;
 class SHAPE_POLY_SET;
 class SHAPE_LINE_CHAIN;
@@ -47,6 +51,13 @@ public:
     bool Fill( std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false,
                wxWindow* aParent = nullptr );
 
+    /**
+     * In incremental mode Fill() only recomputes the zones and layers whose extents touch
+     * copper changed since the last full fill (see BOARD::MarkZoneFillsDirty()), reusing the
+     * existing fills elsewhere.  Has no effect when checking fills.
+     */
+    void SetIncremental( bool aIncremental ) { m_incremental = aIncremental; }
+
     bool IsDebug() const { return m_debugZoneFiller; }
 
 private:
@@ -56,8 +67,13 @@ private:
     void addKnockout( BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap, bool aIgnoreLineWidth,
                       SHAPE_POLY_SET& aHoles );
 
-    void knockoutThermalReliefs( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
-                                 SHAPE_POLY_SET& aFill );
+    void addCachedKnockout( BOARD_CONNECTED_ITEM* aItem, PCB_LAYER_ID aLayer, int aGap,
+                            SHAPE_POLY_SET& aHoles );
+
+    void buildThermalReliefHoles( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
+                                  SHAPE_POLY_SET& aHoles );
+
+    void buildKnockoutIndex();
 
     void buildCopperItemClearances( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
                                     SHAPE_POLY_SET& aHoles );
@@ -82,6 +98,18 @@ private:
                                const SHAPE_POLY_SET& aMaxExtents,
                                SHAPE_POLY_SET& aRawPolys );
 
+    /**
+     * Knock the given thermal relief and clearance holes out of aRawPolys, add in the
+     * thermal spokes which still connect to copper and prune features narrower than the
+     * zone's minimum width.  Used for whole zones and for the tiles of a tiled fill.
+     */
+    bool fillWithKnockouts( const ZONE_CONTAINER* aZone, PCB_LAYER_ID aLayer,
+                            PCB_LAYER_ID aDebugLayer, const SHAPE_POLY_SET& aMaxExtents,
+                            const SHAPE_POLY_SET& aThermalHoles,
+                            const SHAPE_POLY_SET& aClearanceHoles,
+                            const std::deque<SHAPE_LINE_CHAIN>& aThermalSpokes,
+                            SHAPE_POLY_SET& aRawPolys );
+
     /**
      * Function buildThermalSpokes
      * Constructs a list of all thermal spokes for the given zone.
@@ -124,9 +152,19 @@ private:
 
     std::unique_ptr<WX_PROGRESS_REPORTER> m_uniqueReporter;
 
+    using KNOCKOUT_RTREE = RTree<BOARD_ITEM*, int, 2, double>;
+
+    /// Copper knockout candidates, indexed by copper layer.  Built once per Fill() call.
+    std::vector<std::unique_ptr<KNOCKOUT_RTREE>> m_knockoutTrees;
+
     int                   m_maxError;
     int                   m_worstClearance;
 
+    /// Threads each fill may use for its tiles and its knockout union, so that together with
+    /// the threads filling zones in parallel they don't outnumber the cores
+    size_t                m_tileThreadCount;
+
+    bool                  m_incremental;
     bool                  m_debugZoneFiller;
 };
 
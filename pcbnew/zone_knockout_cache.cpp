@@ -0,0 +1,234 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <class_board_item.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <hash_eda.h>
+#include <macros.h>
+#include <pcb_shape.h>
+#include <zone_knockout_cache.h>
+
+
+size_t ZONE_KNOCKOUT_CACHE::geometrySignature( const BOARD_ITEM* aItem )
+{
+    size_t ret = hash_val( (int) aItem->Type(), aItem->GetLayerSet().to_ullong() );
+
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T:
+    {
+        const D_PAD* pad = static_cast<const D_PAD*>( aItem );
+
+        hash_combine( ret, (int) pad->GetShape(), pad->GetSize().x, pad->GetSize().y,
+                      pad->GetPosition().x, pad->GetPosition().y, pad->GetOrientation(),
+                      pad->GetOffset().x, pad->GetOffset().y, pad->GetDelta().x,
+                      pad->GetDelta().y );
+        hash_combine( ret, (int) pad->GetDrillShape(), pad->GetDrillSize().x,
+                      pad->GetDrillSize().y, (int) pad->GetAttribute() );
+        hash_combine( ret, pad->GetRoundRectRadiusRatio(), pad->GetChamferRectRatio(),
+                      pad->GetChamferPositions(), pad->GetRemoveUnconnected(),
+                      pad->GetKeepTopBottom() );
+
+        if( pad->GetShape() == PAD_SHAPE_CUSTOM )
+        {
+            hash_combine( ret, (int) pad->GetAnchorPadShape(),
+                          (int) pad->GetCustomShapeInZoneOpt() );
+
+            for( const std::shared_ptr<PCB_SHAPE>& primitive : pad->GetPrimitives() )
+            {
+                hash_combine( ret, (int) primitive->GetShape(), primitive->GetWidth(),
+                              primitive->GetStart().x, primitive->GetStart().y,
+                              primitive->GetEnd().x, primitive->GetEnd().y,
+                              primitive->GetAngle() );
+
+                for( const wxPoint& pt : primitive->GetBezierPoints() )
+                    hash_combine( ret, pt.x, pt.y );
+
+                const SHAPE_POLY_SET& poly = primitive->GetPolyShape();
+
+                for( auto it = poly.CIterateWithHoles(); it; ++it )
+                    hash_combine( ret, it->x, it->y );
+            }
+        }
+
+        break;
+    }
+
+    case PCB_VIA_T:
+    {
+        const VIA* via = static_cast<const VIA*>( aItem );
+
+        hash_combine( ret, via->GetPosition().x, via->GetPosition().y, via->GetWidth(),
+                      via->GetDrillValue(), (int) via->GetViaType(),
+                      via->GetRemoveUnconnected(), via->GetKeepTopBottom() );
+        break;
+    }
+
+    case PCB_ARC_T:
+    {
+        const ARC* arc = static_cast<const ARC*>( aItem );
+
+        hash_combine( ret, arc->GetMid().x, arc->GetMid().y );
+    }
+        KI_FALLTHROUGH;
+
+    case PCB_TRACE_T:
+    {
+        const TRACK* track = static_cast<const TRACK*>( aItem );
+
+        hash_combine( ret, track->GetStart().x, track->GetStart().y, track->GetEnd().x,
+                      track->GetEnd().y, track->GetWidth() );
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return ret;
+}
+
+
+bool ZONE_KNOCKOUT_CACHE::isFlashed( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_PAD_T: return static_cast<const D_PAD*>( aItem )->FlashLayer( aLayer );
+    case PCB_VIA_T: return static_cast<const VIA*>( aItem )->FlashLayer( aLayer );
+    default:        return true;
+    }
+}
+
+
+bool ZONE_KNOCKOUT_CACHE::Get( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aClearance,
+                               int aMaxError, SHAPE_POLY_SET& aKnockouts ) const
+{
+    BOX2I  bbox = aItem->GetBoundingBox();
+    size_t signature = geometrySignature( aItem );
+    bool   flashed = isFlashed( aItem, aLayer );
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    auto it = m_entries.find( aItem );
+
+    if( it == m_entries.end() )
+        return false;
+
+    for( const ENTRY& entry : it->second.m_entries )
+    {
+        if( entry.m_layer == aLayer && entry.m_clearance == aClearance
+                && entry.m_maxError == aMaxError && entry.m_itemBBox == bbox
+                && entry.m_signature == signature && entry.m_flashed == flashed )
+        {
+            aKnockouts.Append( entry.m_knockout );
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Add( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aClearance,
+                               int aMaxError, const SHAPE_POLY_SET& aKnockout )
+{
+    BOX2I             bbox = aItem->GetBoundingBox();
+    size_t            signature = geometrySignature( aItem );
+    bool              flashed = isFlashed( aItem, aLayer );
+    const BOARD_ITEM* parent = aItem->GetParent();
+
+    if( parent && parent->Type() != PCB_MODULE_T )
+        parent = nullptr;
+
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    ITEM_ENTRIES& itemEntries = m_entries[ aItem ];
+
+    // The address may have been reused by an item in another footprint
+    if( itemEntries.m_parent != parent )
+    {
+        if( itemEntries.m_parent )
+            m_children[ itemEntries.m_parent ].erase( aItem );
+
+        itemEntries.m_parent = parent;
+    }
+
+    if( parent )
+        m_children[ parent ].insert( aItem );
+
+    std::vector<ENTRY>& entries = itemEntries.m_entries;
+
+    // Drop any entry left over from before the item changed
+    entries.erase( std::remove_if( entries.begin(), entries.end(),
+                                   [&]( const ENTRY& aEntry )
+                                   {
+                                       return aEntry.m_itemBBox != bbox
+                                               || aEntry.m_signature != signature
+                                               || ( aEntry.m_layer == aLayer
+                                                    && aEntry.m_clearance == aClearance
+                                                    && aEntry.m_maxError == aMaxError );
+                                   } ),
+                   entries.end() );
+
+    entries.push_back( { aLayer, aClearance, aMaxError, bbox, signature, flashed, aKnockout } );
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Invalidate( const BOARD_ITEM* aItem )
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    invalidate( aItem );
+}
+
+
+void ZONE_KNOCKOUT_CACHE::invalidate( const BOARD_ITEM* aItem )
+{
+    auto it = m_entries.find( aItem );
+
+    if( it != m_entries.end() )
+    {
+        if( it->second.m_parent )
+            m_children[ it->second.m_parent ].erase( aItem );
+
+        m_entries.erase( it );
+    }
+
+    auto children = m_children.find( aItem );
+
+    if( children != m_children.end() )
+    {
+        for( const BOARD_ITEM* child : children->second )
+            m_entries.erase( child );
+
+        m_children.erase( children );
+    }
+}
+
+
+void ZONE_KNOCKOUT_CACHE::Clear()
+{
+    std::lock_guard<std::mutex> lock( m_lock );
+
+    m_entries.clear();
+    m_children.clear();
+}
@@ -0,0 +1,109 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ZONE_KNOCKOUT_CACHE_H
+#define __ZONE_KNOCKOUT_CACHE_H
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <geometry/shape_poly_set.h>
+#include <math/box2.h>
+#include <layers_id_colors_and_visibility.h>
+
+class BOARD_ITEM;
+
+/**
+ * ZONE_KNOCKOUT_CACHE
+ * caches the clearance polygons knocked out of zone fills by pads, vias and tracks, so that
+ * stacked zones and repeated refills don't regenerate the same geometry.  Entries are keyed
+ * on (item, layer, clearance, max error) and must be invalidated when the item changes.  They
+ * also record a signature of the item's geometry, so that an entry for an item changed without
+ * being invalidated, or for a deleted item whose address was reused, isn't returned, and
+ * whether the item was flashed on the layer, since connecting a track to a pad or via with
+ * unconnected layers removed changes its knockout without changing the item.
+ *
+ * All methods are thread-safe.
+ */
+class ZONE_KNOCKOUT_CACHE
+{
+public:
+    ZONE_KNOCKOUT_CACHE()
+    {
+    }
+
+    /**
+     * Append the cached knockout for \a aItem to \a aKnockouts.
+     * @return false if there is no matching entry in the cache.
+     */
+    bool Get( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aClearance, int aMaxError,
+              SHAPE_POLY_SET& aKnockouts ) const;
+
+    void Add( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer, int aClearance, int aMaxError,
+              const SHAPE_POLY_SET& aKnockout );
+
+    /**
+     * Remove all entries for \a aItem, and for any items it was the parent of when their
+     * entries were added (such as the pads of a footprint, including those since deleted).
+     */
+    void Invalidate( const BOARD_ITEM* aItem );
+
+    void Clear();
+
+private:
+    /**
+     * @return a hash of everything about \a aItem which shapes its knockouts.
+     */
+    static size_t geometrySignature( const BOARD_ITEM* aItem );
+
+    /**
+     * @return whether a pad or via has copper on \a aLayer, which with unconnected layers
+     *         removed depends on what is connected to it rather than on the item itself.
+     */
+    static bool isFlashed( const BOARD_ITEM* aItem, PCB_LAYER_ID aLayer );
+
+    void invalidate( const BOARD_ITEM* aItem );
+
+    struct ENTRY
+    {
+        PCB_LAYER_ID   m_layer;
+        int            m_clearance;
+        int            m_maxError;
+        BOX2I          m_itemBBox;      // Guards against items changed behind our back
+        size_t         m_signature;     //  "
+        bool           m_flashed;       // Knockouts of unflashed pads and vias are hole-only
+        SHAPE_POLY_SET m_knockout;
+    };
+
+    struct ITEM_ENTRIES
+    {
+        const BOARD_ITEM*  m_parent = nullptr;  // The footprint of a pad, if any
+        std::vector<ENTRY> m_entries;
+    };
+
+    mutable std::mutex                                     m_lock;
+    std::unordered_map<const BOARD_ITEM*, ITEM_ENTRIES>    m_entries;
+
+    /// The items with entries, by parent footprint
+    std::unordered_map<const BOARD_ITEM*, std::unordered_set<const BOARD_ITEM*>> m_children;
+};
+
+#endif
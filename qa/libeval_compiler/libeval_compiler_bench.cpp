@@ -0,0 +1,316 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file libeval_compiler_bench.cpp
+ * Times the evaluation of typical DRC rule conditions over every pair of 160 tracks and
+ * vias, and counts the heap allocations each evaluation makes:
+ *
+ *  - with a new context per evaluation, as the expression VM was first used
+ *  - with one context reset between evaluations
+ *  - with the conditions lowered to closures
+ *  - through DRC_RULE_CONDITION::EvaluateFor()
+ */
+
+#include <wx/wx.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <convert_to_biu.h>
+#include <drc/drc_rule_condition.h>
+#include <pcb_expr_evaluator.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+
+static std::atomic<size_t> s_allocCount( 0 );
+
+
+void* operator new( size_t aSize )
+{
+    s_allocCount.fetch_add( 1, std::memory_order_relaxed );
+
+    if( void* p = std::malloc( aSize ? aSize : 1 ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+
+void* operator new[]( size_t aSize )
+{
+    return operator new( aSize );
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete( void* aPtr, size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr, size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+/// Conditions in the style of the implicit netclass rules and of typical custom rules
+static const std::vector<wxString> s_conditions = {
+    "A.NetClass == 'HV'",
+    "A.NetClass == 'DDR' && A.isDiffPair()",
+    "A.NetClass == 'Power' && A.Via_Type != 'Micro'",
+    "A.Type == 'Via' && B.Type == 'Track' && A.NetClass != B.NetClass",
+    "(A.NetName == '/DDR/DQ*' || A.NetName == '/DDR/DQS*') && B.NetClass == 'DDR'",
+    "A.Width > 0.25mm && B.Width > 0.25mm && A.Layer == 'F.Cu'"
+};
+
+
+struct CONDITION
+{
+    std::unique_ptr<PCB_EXPR_UCODE>     vm;
+    std::unique_ptr<PCB_EXPR_UCODE>     lowered;
+    std::unique_ptr<DRC_RULE_CONDITION> rule;
+};
+
+
+/// Collects results so that the compiler can't drop the evaluations producing them
+static volatile double s_sink = 0;
+
+
+static void buildBoard( BOARD& aBoard, std::vector<BOARD_ITEM*>& aItems )
+{
+    const char* classNames[] = { "Default", "HV", "DDR", "Power" };
+    const char* netNames[] = { "/DDR/DQ%d", "/DDR/DQS%d_P", "/PWR/VIN%d", "/SIG%d" };
+
+    std::vector<NETCLASSPTR> netclasses;
+
+    for( const char* name : classNames )
+        netclasses.emplace_back( new NETCLASS( name ) );
+
+    for( int ii = 0; ii < 32; ++ii )
+    {
+        wxString      name = wxString::Format( netNames[ ii % 4 ], ii );
+        NETINFO_ITEM* net = new NETINFO_ITEM( &aBoard, name, ii + 1 );
+
+        net->SetClass( netclasses[ ii % netclasses.size() ] );
+        aBoard.Add( net );
+
+        for( int jj = 0; jj < 4; ++jj )
+        {
+            TRACK* track = new TRACK( &aBoard );
+
+            track->SetNet( net );
+            track->SetLayer( jj % 2 ? B_Cu : F_Cu );
+            track->SetWidth( Millimeter2iu( 0.1 + 0.1 * jj ) );
+            track->SetStart( wxPoint( ii * 1000000, jj * 1000000 ) );
+            track->SetEnd( wxPoint( ii * 1000000 + 500000, jj * 1000000 ) );
+
+            aBoard.Add( track );
+            aItems.push_back( track );
+        }
+
+        VIA* via = new VIA( &aBoard );
+
+        via->SetNet( net );
+        via->SetViaType( ii % 8 ? VIATYPE::THROUGH : VIATYPE::MICROVIA );
+        via->SetPosition( wxPoint( ii * 1000000, -1000000 ) );
+
+        aBoard.Add( via );
+        aItems.push_back( via );
+    }
+}
+
+
+static bool compileConditions( std::vector<CONDITION>& aConditions )
+{
+    for( const wxString& expression : s_conditions )
+    {
+        CONDITION         condition;
+        PCB_EXPR_COMPILER compiler;
+        PCB_EXPR_CONTEXT  preflightContext( F_Cu );
+
+        condition.vm = std::make_unique<PCB_EXPR_UCODE>();
+        condition.lowered = std::make_unique<PCB_EXPR_UCODE>();
+        condition.rule = std::make_unique<DRC_RULE_CONDITION>( expression );
+
+        if( !compiler.Compile( expression, condition.vm.get(), &preflightContext )
+                || !compiler.Compile( expression, condition.lowered.get(), &preflightContext )
+                || !condition.lowered->Lower()
+                || !condition.rule->Compile( nullptr ) )
+        {
+            fprintf( stderr, "Can't compile '%s'\n", (const char*) expression.c_str() );
+            return false;
+        }
+
+        aConditions.push_back( std::move( condition ) );
+    }
+
+    return true;
+}
+
+
+struct RESULT
+{
+    size_t evaluations = 0;
+    double ns = 0.0;
+    size_t allocs = 0;
+};
+
+
+/**
+ * Calls aEvaluate for every condition and every pair of items until at least aMinSeconds
+ * have passed, after one untimed pass.
+ */
+static RESULT runBenchmark( const std::vector<CONDITION>& aConditions,
+                            const std::vector<BOARD_ITEM*>& aItems, double aMinSeconds,
+                            const std::function<double( const CONDITION&, BOARD_ITEM*,
+                                                        BOARD_ITEM* )>& aEvaluate )
+{
+    using CLOCK = std::chrono::steady_clock;
+
+    RESULT result;
+
+    auto pass =
+            [&]()
+            {
+                for( const CONDITION& condition : aConditions )
+                {
+                    for( BOARD_ITEM* a : aItems )
+                    {
+                        for( BOARD_ITEM* b : aItems )
+                            s_sink += aEvaluate( condition, a, b );
+                    }
+                }
+
+                return aConditions.size() * aItems.size() * aItems.size();
+            };
+
+    pass();
+
+    while( result.ns < aMinSeconds * 1e9 )
+    {
+        const size_t allocs = s_allocCount.load();
+        const auto   start = CLOCK::now();
+
+        result.evaluations += pass();
+
+        const auto end = CLOCK::now();
+
+        result.allocs += s_allocCount.load() - allocs;
+        result.ns += std::chrono::duration<double, std::nano>( end - start ).count();
+    }
+
+    return result;
+}
+
+
+int main( int argc, char** argv )
+{
+    double minSeconds = argc > 1 ? atof( argv[1] ) : 0.5;
+
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+    propMgr.Rebuild();
+
+    BOARD                    board;
+    std::vector<BOARD_ITEM*> items;
+    std::vector<CONDITION>   conditions;
+
+    buildBoard( board, items );
+
+    if( !compileConditions( conditions ) )
+        return 1;
+
+    PCB_EXPR_CONTEXT reusedContext( F_Cu );
+
+    struct BENCHMARK
+    {
+        const char* name;
+        std::function<double( const CONDITION&, BOARD_ITEM*, BOARD_ITEM* )> evaluate;
+    };
+
+    std::vector<BENCHMARK> benchmarks = {
+        { "vm/new_context",
+          []( const CONDITION& aCondition, BOARD_ITEM* a, BOARD_ITEM* b )
+          {
+              PCB_EXPR_CONTEXT context( F_Cu );
+              context.SetItems( a, b );
+              return aCondition.vm->Run( &context )->AsDouble();
+          } },
+        { "vm/reused_context",
+          [&]( const CONDITION& aCondition, BOARD_ITEM* a, BOARD_ITEM* b )
+          {
+              reusedContext.Reset();
+              reusedContext.SetItems( a, b );
+              return aCondition.vm->Run( &reusedContext )->AsDouble();
+          } },
+        { "closures/reused_context",
+          [&]( const CONDITION& aCondition, BOARD_ITEM* a, BOARD_ITEM* b )
+          {
+              reusedContext.Reset();
+              reusedContext.SetItems( a, b );
+              return aCondition.lowered->Run( &reusedContext )->AsDouble();
+          } },
+        { "DRC_RULE_CONDITION::EvaluateFor",
+          []( const CONDITION& aCondition, BOARD_ITEM* a, BOARD_ITEM* b )
+          {
+              return aCondition.rule->EvaluateFor( a, b, F_Cu ) ? 1.0 : 0.0;
+          } }
+    };
+
+    printf( "%zu conditions, %zu items\n", conditions.size(), items.size() );
+    printf( "%-36s %14s %12s %12s\n", "benchmark", "evaluations", "ns/eval", "allocs/eval" );
+
+    for( const BENCHMARK& benchmark : benchmarks )
+    {
+        RESULT result = runBenchmark( conditions, items, minSeconds, benchmark.evaluate );
+
+        printf( "%-36s %14zu %12.1f %12.2f\n", benchmark.name, result.evaluations,
+                result.ns / result.evaluations,
+                (double) result.allocs / result.evaluations );
+        fflush( stdout );
+    }
+
+    return 0;
+}
@@ -0,0 +1,565 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file kimath_benchmark.cpp
+ * Times the SHAPE_POLY_SET and SHAPE_LINE_CHAIN operations the rest of KiCad leans on, over
+ * fixed inputs kept in the data directory:
+ *
+ *  - zone_fill.txt:  the filled copper zone of qa/data/complex_hierarchy.kicad_pcb
+ *  - pad_array.txt:  a BGA and a QFP footprint's worth of pads, placed over that zone
+ *  - arc_chains.txt: a tuning meander, a filleted board outline and a spiral, all arcs
+ *
+ * Each benchmark reports the time and the heap allocations per operation.  Run it before
+ * and after a change to the geometry code to see what the change costs.
+ */
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+#ifndef QA_KIMATH_BENCHMARK_DATA_LOCATION
+    #define QA_KIMATH_BENCHMARK_DATA_LOCATION "???"
+#endif
+
+
+static std::atomic<size_t> s_allocCount( 0 );
+static std::atomic<size_t> s_allocBytes( 0 );
+
+
+static void* countedAlloc( size_t aSize )
+{
+    s_allocCount.fetch_add( 1, std::memory_order_relaxed );
+    s_allocBytes.fetch_add( aSize, std::memory_order_relaxed );
+
+    return std::malloc( aSize ? aSize : 1 );
+}
+
+
+void* operator new( size_t aSize )
+{
+    if( void* p = countedAlloc( aSize ) )
+        return p;
+
+    throw std::bad_alloc();
+}
+
+
+void* operator new[]( size_t aSize )
+{
+    return operator new( aSize );
+}
+
+
+void* operator new( size_t aSize, const std::nothrow_t& ) noexcept
+{
+    return countedAlloc( aSize );
+}
+
+
+void* operator new[]( size_t aSize, const std::nothrow_t& ) noexcept
+{
+    return countedAlloc( aSize );
+}
+
+
+void operator delete( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete( void* aPtr, size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+void operator delete[]( void* aPtr, size_t ) noexcept
+{
+    std::free( aPtr );
+}
+
+
+/**
+ * The inputs, loaded once and never modified; benchmarks work on copies.
+ */
+struct INPUTS
+{
+    SHAPE_POLY_SET                zoneFill;
+    SHAPE_POLY_SET                pads;
+    std::vector<SHAPE_LINE_CHAIN> arcChains;
+
+    std::vector<VECTOR2I>         probePoints;  ///< a grid over the zone fill's bounding box
+    std::vector<SEG>              probeSegs;    ///< short tracks starting on that grid
+};
+
+
+struct BENCHMARK
+{
+    std::string name;
+
+    /// Called untimed before each run, to give the run fresh copies to work on
+    std::function<void()> prepare;
+
+    /// Performs the operation, returning how many times it was performed
+    std::function<size_t()> run;
+};
+
+
+/// Collects results so that the compiler can't drop the queries producing them
+static volatile long long s_sink = 0;
+
+
+static bool readFile( const std::string& aPath, std::stringstream& aStream )
+{
+    std::ifstream file( aPath );
+
+    if( !file )
+    {
+        fprintf( stderr, "Can't open %s\n", aPath.c_str() );
+        return false;
+    }
+
+    aStream << file.rdbuf();
+    return true;
+}
+
+
+static bool loadPolySet( const std::string& aPath, SHAPE_POLY_SET& aSet )
+{
+    std::stringstream stream;
+
+    if( !readFile( aPath, stream ) )
+        return false;
+
+    if( !aSet.Parse( stream ) || aSet.OutlineCount() == 0 )
+    {
+        fprintf( stderr, "%s is not a polygon set\n", aPath.c_str() );
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Reads "chains <count>" followed by that many chains in SHAPE_LINE_CHAIN::Parse() form.
+ */
+static bool loadChains( const std::string& aPath, std::vector<SHAPE_LINE_CHAIN>& aChains )
+{
+    std::stringstream stream;
+    std::string       tag;
+    int               count = 0;
+
+    if( !readFile( aPath, stream ) )
+        return false;
+
+    stream >> tag >> count;
+
+    if( tag != "chains" || count <= 0 )
+    {
+        fprintf( stderr, "%s is not a list of chains\n", aPath.c_str() );
+        return false;
+    }
+
+    for( int ii = 0; ii < count; ++ii )
+    {
+        SHAPE_LINE_CHAIN chain;
+
+        if( !chain.Parse( stream ) || !stream )
+        {
+            fprintf( stderr, "Bad chain %d in %s\n", ii, aPath.c_str() );
+            return false;
+        }
+
+        aChains.push_back( chain );
+    }
+
+    return true;
+}
+
+
+static std::string dataDir()
+{
+    const char* env = std::getenv( "KICAD_TEST_KIMATH_BENCHMARK_DATA_DIR" );
+
+    return std::string( env ? env : QA_KIMATH_BENCHMARK_DATA_LOCATION ) + "/";
+}
+
+
+static bool loadInputs( INPUTS& aInputs )
+{
+    const std::string dir = dataDir();
+
+    if( !loadPolySet( dir + "zone_fill.txt", aInputs.zoneFill )
+            || !loadPolySet( dir + "pad_array.txt", aInputs.pads )
+            || !loadChains( dir + "arc_chains.txt", aInputs.arcChains ) )
+    {
+        return false;
+    }
+
+    const BOX2I bbox = aInputs.zoneFill.BBox();
+    const int   steps = 32;
+
+    for( int ii = 0; ii < steps; ++ii )
+    {
+        for( int jj = 0; jj < steps; ++jj )
+        {
+            VECTOR2I pt( bbox.GetX() + (int) ( (long long) bbox.GetWidth() * ii / steps ),
+                         bbox.GetY() + (int) ( (long long) bbox.GetHeight() * jj / steps ) );
+
+            aInputs.probePoints.push_back( pt );
+            aInputs.probeSegs.emplace_back( pt, pt + VECTOR2I( 2000000, ( ii - jj ) * 50000 ) );
+        }
+    }
+
+    return true;
+}
+
+
+static std::vector<BENCHMARK> makeBenchmarks( const INPUTS& aIn )
+{
+    // Scratch sets shared by the benchmarks below, which run one at a time
+    auto work = std::make_shared<SHAPE_POLY_SET>();
+    auto fresh = std::make_shared<std::unique_ptr<SHAPE_POLY_SET>>();
+
+    const int clearance = 200000;
+
+    std::vector<BENCHMARK> benchmarks;
+
+    benchmarks.push_back( { "BooleanAdd/zone+pads", nullptr,
+            [&aIn, work]()
+            {
+                work->BooleanAdd( aIn.zoneFill, aIn.pads, SHAPE_POLY_SET::PM_FAST );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "BooleanSubtract/zone-pads", nullptr,
+            [&aIn, work]()
+            {
+                work->BooleanSubtract( aIn.zoneFill, aIn.pads, SHAPE_POLY_SET::PM_FAST );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "BooleanSubtract/zone-pads_strict", nullptr,
+            [&aIn, work]()
+            {
+                work->BooleanSubtract( aIn.zoneFill, aIn.pads,
+                                       SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "Inflate/zone",
+            [&aIn, work]()
+            {
+                *work = aIn.zoneFill;
+            },
+            [work]()
+            {
+                work->Inflate( 250000, 16 );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "Inflate/pads",
+            [&aIn, work]()
+            {
+                *work = aIn.pads;
+            },
+            [work]()
+            {
+                work->Inflate( 250000, 16, SHAPE_POLY_SET::ROUND_ALL_CORNERS );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "Deflate/zone",
+            [&aIn, work]()
+            {
+                *work = aIn.zoneFill;
+            },
+            [work]()
+            {
+                work->Deflate( 250000, 16 );
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "Fracture/zone-pads",
+            [&aIn, work]()
+            {
+                work->BooleanSubtract( aIn.zoneFill, aIn.pads, SHAPE_POLY_SET::PM_FAST );
+            },
+            [work]()
+            {
+                work->Fracture( SHAPE_POLY_SET::PM_FAST );
+                return 1;
+            } } );
+
+    // A new set each time: one assigned over an old set would reuse its triangulation
+    benchmarks.push_back( { "CacheTriangulation/zone",
+            [&aIn, fresh]()
+            {
+                fresh->reset( new SHAPE_POLY_SET( aIn.zoneFill ) );
+            },
+            [fresh]()
+            {
+                ( *fresh )->CacheTriangulation();
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "CacheTriangulation/zone-pads",
+            [&aIn, fresh]()
+            {
+                fresh->reset( new SHAPE_POLY_SET );
+                ( *fresh )->BooleanSubtract( aIn.zoneFill, aIn.pads, SHAPE_POLY_SET::PM_FAST );
+                ( *fresh )->Fracture( SHAPE_POLY_SET::PM_FAST );
+            },
+            [fresh]()
+            {
+                ( *fresh )->CacheTriangulation();
+                return 1;
+            } } );
+
+    benchmarks.push_back( { "Collide/zone_point", nullptr,
+            [&aIn, clearance]()
+            {
+                for( const VECTOR2I& pt : aIn.probePoints )
+                    s_sink += aIn.zoneFill.Collide( pt, clearance );
+
+                return aIn.probePoints.size();
+            } } );
+
+    benchmarks.push_back( { "Collide/zone_seg", nullptr,
+            [&aIn, clearance]()
+            {
+                for( const SEG& seg : aIn.probeSegs )
+                    s_sink += aIn.zoneFill.Collide( seg, clearance );
+
+                return aIn.probeSegs.size();
+            } } );
+
+    // Every eighth pad only: each of these takes milliseconds
+    benchmarks.push_back( { "Collide/zone_pad", nullptr,
+            [&aIn, clearance]()
+            {
+                size_t count = 0;
+
+                for( int ii = 0; ii < aIn.pads.OutlineCount(); ii += 8, ++count )
+                    s_sink += aIn.zoneFill.Collide( &aIn.pads.COutline( ii ), clearance );
+
+                return count;
+            } } );
+
+    benchmarks.push_back( { "Collide/chain_seg", nullptr,
+            [&aIn, clearance]()
+            {
+                for( const SHAPE_LINE_CHAIN& chain : aIn.arcChains )
+                {
+                    for( const SEG& seg : aIn.probeSegs )
+                        s_sink += chain.Collide( seg, clearance );
+                }
+
+                return aIn.arcChains.size() * aIn.probeSegs.size();
+            } } );
+
+    benchmarks.push_back( { "SquaredDistance/zone_point", nullptr,
+            [&aIn]()
+            {
+                for( const VECTOR2I& pt : aIn.probePoints )
+                    s_sink += aIn.zoneFill.SquaredDistance( pt );
+
+                return aIn.probePoints.size();
+            } } );
+
+    benchmarks.push_back( { "SquaredDistance/zone_seg", nullptr,
+            [&aIn]()
+            {
+                for( const SEG& seg : aIn.probeSegs )
+                    s_sink += aIn.zoneFill.SquaredDistance( seg );
+
+                return aIn.probeSegs.size();
+            } } );
+
+    benchmarks.push_back( { "SquaredDistance/chain_point", nullptr,
+            [&aIn]()
+            {
+                for( const SHAPE_LINE_CHAIN& chain : aIn.arcChains )
+                {
+                    for( const VECTOR2I& pt : aIn.probePoints )
+                        s_sink += chain.SquaredDistance( pt );
+                }
+
+                return aIn.arcChains.size() * aIn.probePoints.size();
+            } } );
+
+    return benchmarks;
+}
+
+
+struct RESULT
+{
+    size_t ops = 0;
+    double ns = 0.0;
+    size_t allocs = 0;
+    size_t bytes = 0;
+};
+
+
+/**
+ * Runs aBenchmark until it has taken at least aMinSeconds, after one untimed run to warm
+ * caches and let lazily built indexes get built.
+ */
+static RESULT runBenchmark( const BENCHMARK& aBenchmark, double aMinSeconds )
+{
+    using CLOCK = std::chrono::steady_clock;
+
+    RESULT result;
+
+    if( aBenchmark.prepare )
+        aBenchmark.prepare();
+
+    aBenchmark.run();
+
+    while( result.ns < aMinSeconds * 1e9 )
+    {
+        if( aBenchmark.prepare )
+            aBenchmark.prepare();
+
+        const size_t allocs = s_allocCount.load();
+        const size_t bytes = s_allocBytes.load();
+        const auto   start = CLOCK::now();
+
+        result.ops += aBenchmark.run();
+
+        const auto end = CLOCK::now();
+
+        result.allocs += s_allocCount.load() - allocs;
+        result.bytes += s_allocBytes.load() - bytes;
+        result.ns += std::chrono::duration<double, std::nano>( end - start ).count();
+    }
+
+    return result;
+}
+
+
+static void usage( const char* aName )
+{
+    printf( "Usage: %s [-t <seconds>] [<name filter>...]\n\n"
+            "Times kimath geometry operations over the inputs in\n  %s\n"
+            "(override with KICAD_TEST_KIMATH_BENCHMARK_DATA_DIR).\n\n"
+            "  -t <seconds>  minimum time to spend on each benchmark (default 0.5)\n"
+            "  -l            list the benchmarks and exit\n"
+            "  <filter>      only run benchmarks whose names contain one of these\n",
+            aName, dataDir().c_str() );
+}
+
+
+int main( int argc, char** argv )
+{
+    double                   minSeconds = 0.5;
+    bool                     listOnly = false;
+    std::vector<std::string> filters;
+
+    for( int ii = 1; ii < argc; ++ii )
+    {
+        if( !strcmp( argv[ii], "-t" ) && ii + 1 < argc )
+        {
+            minSeconds = atof( argv[++ii] );
+        }
+        else if( !strcmp( argv[ii], "-l" ) )
+        {
+            listOnly = true;
+        }
+        else if( argv[ii][0] == '-' )
+        {
+            usage( argv[0] );
+            return !strcmp( argv[ii], "-h" ) ? 0 : 1;
+        }
+        else
+        {
+            filters.push_back( argv[ii] );
+        }
+    }
+
+    INPUTS inputs;
+
+    if( !listOnly && !loadInputs( inputs ) )
+        return 1;
+
+    std::vector<BENCHMARK> benchmarks = makeBenchmarks( inputs );
+
+    if( !listOnly )
+    {
+        printf( "zone fill: %d vertices, pads: %d outlines, %d vertices\n",
+                inputs.zoneFill.TotalVertices(), inputs.pads.OutlineCount(),
+                inputs.pads.TotalVertices() );
+        printf( "%-36s %12s %14s %12s %14s\n", "benchmark", "ops", "ns/op", "allocs/op",
+                "bytes/op" );
+    }
+
+    for( const BENCHMARK& benchmark : benchmarks )
+    {
+        if( !filters.empty()
+                && std::none_of( filters.begin(), filters.end(),
+                                 [&]( const std::string& aFilter )
+                                 {
+                                     return benchmark.name.find( aFilter ) != std::string::npos;
+                                 } ) )
+        {
+            continue;
+        }
+
+        if( listOnly )
+        {
+            printf( "%s\n", benchmark.name.c_str() );
+            continue;
+        }
+
+        RESULT result = runBenchmark( benchmark, minSeconds );
+
+        printf( "%-36s %12zu %14.1f %12.1f %14.1f\n", benchmark.name.c_str(), result.ops,
+                result.ns / result.ops, (double) result.allocs / result.ops,
+                (double) result.bytes / result.ops );
+        fflush( stdout );
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/rtree.h>
+
+#include <random>
+#include <set>
+
+
+template <int DIMS>
+using TEST_RTREE = RTree<intptr_t, int, DIMS, double>;
+
+
+/**
+ * Random boxes, mostly small with a few spanning much of the area, tagged 1, 2, 3...
+ */
+template <int DIMS>
+static std::vector<typename TEST_RTREE<DIMS>::BulkEntry> randomEntries( int aCount,
+                                                                       std::mt19937& aRng )
+{
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    std::uniform_int_distribution<int> size( 0, 2000 );
+
+    std::vector<typename TEST_RTREE<DIMS>::BulkEntry> entries( aCount );
+
+    for( int ii = 0; ii < aCount; ++ii )
+    {
+        for( int axis = 0; axis < DIMS; ++axis )
+        {
+            entries[ii].first.m_min[axis] = coord( aRng );
+            entries[ii].first.m_max[axis] = entries[ii].first.m_min[axis]
+                                            + ( ii % 50 ? size( aRng ) : 400000 );
+        }
+
+        entries[ii].second = ii + 1;
+    }
+
+    return entries;
+}
+
+
+template <int DIMS>
+static std::set<intptr_t> search( const TEST_RTREE<DIMS>& aTree, const int aMin[DIMS],
+                                  const int aMax[DIMS] )
+{
+    std::set<intptr_t> found;
+
+    auto visit =
+            [&]( const intptr_t& aData ) -> bool
+            {
+                found.insert( aData );
+                return true;
+            };
+
+    aTree.Search( aMin, aMax, visit );
+
+    return found;
+}
+
+
+/**
+ * A bulk-loaded tree must find exactly what the same entries inserted one by one find.
+ */
+template <int DIMS>
+static void checkMatchesInserted( int aCount )
+{
+    std::mt19937 rng( aCount );
+    auto         entries = randomEntries<DIMS>( aCount, rng );
+
+    TEST_RTREE<DIMS> inserted;
+
+    for( const auto& entry : entries )
+        inserted.Insert( entry.first.m_min, entry.first.m_max, entry.second );
+
+    TEST_RTREE<DIMS> packed( entries );
+
+    BOOST_CHECK_EQUAL( packed.Count(), aCount );
+
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    std::uniform_int_distribution<int> size( 0, 200000 );
+
+    for( int trial = 0; trial < 200; ++trial )
+    {
+        int min[DIMS];
+        int max[DIMS];
+
+        for( int axis = 0; axis < DIMS; ++axis )
+        {
+            min[axis] = coord( rng );
+            max[axis] = min[axis] + size( rng );
+        }
+
+        std::set<intptr_t> expected = search<DIMS>( inserted, min, max );
+        std::set<intptr_t> actual = search<DIMS>( packed, min, max );
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( actual.begin(), actual.end(), expected.begin(),
+                                       expected.end() );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+
+BOOST_AUTO_TEST_CASE( MatchesInserted )
+{
+    for( int count : { 0, 1, 7, 8, 9, 63, 64, 65, 1000, 20000 } )
+    {
+        BOOST_TEST_CONTEXT( "count " << count )
+        {
+            checkMatchesInserted<2>( count );
+            checkMatchesInserted<3>( count );
+        }
+    }
+}
+
+
+/**
+ * A bulk-loaded tree must stay editable: removals and insertions work as in any other tree.
+ */
+BOOST_AUTO_TEST_CASE( EditAfterLoad )
+{
+    std::mt19937 rng( 11 );
+    auto         entries = randomEntries<2>( 5000, rng );
+    auto         original = entries;
+
+    TEST_RTREE<2> tree;
+
+    tree.BulkLoad( entries );
+
+    for( size_t ii = 0; ii < original.size(); ii += 2 )
+    {
+        BOOST_CHECK( !tree.Remove( original[ii].first.m_min, original[ii].first.m_max,
+                                   original[ii].second ) );
+    }
+
+    BOOST_CHECK_EQUAL( tree.Count(), 2500 );
+
+    const int everywhereMin[2] = { INT_MIN, INT_MIN };
+    const int everywhereMax[2] = { INT_MAX, INT_MAX };
+
+    std::set<intptr_t> found = search<2>( tree, everywhereMin, everywhereMax );
+
+    for( size_t ii = 0; ii < original.size(); ++ii )
+        BOOST_CHECK_EQUAL( found.count( original[ii].second ), ii % 2 );
+
+    tree.Insert( original[0].first.m_min, original[0].first.m_max, original[0].second );
+    BOOST_CHECK_EQUAL( search<2>( tree, original[0].first.m_min, original[0].first.m_max )
+                               .count( original[0].second ),
+                       1 );
+
+    // Loading again replaces the contents
+    std::vector<TEST_RTREE<2>::BulkEntry> none;
+    tree.BulkLoad( none );
+
+    BOOST_CHECK_EQUAL( tree.Count(), 0 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
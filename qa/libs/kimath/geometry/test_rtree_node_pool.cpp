@@ -0,0 +1,108 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/rtree.h>
+
+#include <random>
+
+
+/**
+ * Fill a tree item by item, remove every other item and refill it, as an editor does, and
+ * check what's left after each step.
+ */
+template <class TREE>
+static void checkInsertRemoveCycles()
+{
+    std::mt19937                       rng( 5 );
+    std::uniform_int_distribution<int> coord( -100000, 100000 );
+
+    TREE tree;
+
+    for( int cycle = 0; cycle < 3; ++cycle )
+    {
+        std::vector<std::array<int, 2>> corners;
+
+        for( intptr_t ii = 1; ii <= 3000; ++ii )
+        {
+            const int min[2] = { coord( rng ), coord( rng ) };
+            const int max[2] = { min[0] + 100, min[1] + 100 };
+
+            corners.push_back( { min[0], min[1] } );
+            tree.Insert( min, max, ii );
+        }
+
+        BOOST_CHECK_EQUAL( tree.Count(), 3000 );
+
+        for( intptr_t ii = 1; ii <= 3000; ii += 2 )
+        {
+            const int min[2] = { corners[ii - 1][0], corners[ii - 1][1] };
+            const int max[2] = { min[0] + 100, min[1] + 100 };
+
+            BOOST_CHECK( !tree.Remove( min, max, ii ) );
+        }
+
+        BOOST_CHECK_EQUAL( tree.Count(), 1500 );
+
+        tree.RemoveAll();
+
+        BOOST_CHECK_EQUAL( tree.Count(), 0 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( RTreeNodeAllocators )
+
+
+BOOST_AUTO_TEST_CASE( PooledNodes )
+{
+    checkInsertRemoveCycles<RTree<intptr_t, int, 2, double>>();
+}
+
+
+BOOST_AUTO_TEST_CASE( HeapNodes )
+{
+    checkInsertRemoveCycles<RTree<intptr_t, int, 2, double, 8, 4, RTreeHeapAllocator>>();
+}
+
+
+/**
+ * Freed nodes are reused before the pool grows.
+ */
+BOOST_AUTO_TEST_CASE( ReusesFreedNodes )
+{
+    RTreeNodePool<std::array<double, 8>> pool;
+
+    std::array<double, 8>* first = pool.Allocate();
+    std::array<double, 8>* second = pool.Allocate();
+
+    BOOST_CHECK( first != second );
+
+    pool.Free( first );
+    BOOST_CHECK_EQUAL( pool.Allocate(), first );
+
+    pool.FreeAll();
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/seg_distance_kernels.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <random>
+
+
+/**
+ * A closed, wobbly ring of many short segments, like a zone outline around round pads.
+ */
+static SHAPE_LINE_CHAIN wobblyRing( int aPointCount, int aRadius )
+{
+    SHAPE_LINE_CHAIN ring;
+
+    for( int ii = 0; ii < aPointCount; ++ii )
+    {
+        double angle = 2.0 * M_PI * ii / aPointCount;
+        double r = aRadius * ( 1.0 + 0.1 * std::sin( 17.0 * angle ) );
+
+        ring.Append( VECTOR2I( r * std::cos( angle ), r * std::sin( angle ) ) );
+    }
+
+    ring.SetClosed( true );
+
+    return ring;
+}
+
+
+BOOST_AUTO_TEST_SUITE( SegDistanceKernels )
+
+
+/**
+ * The kernels must stay within the slack allowed by SegKernelThreshold() of the exact
+ * distances, and must never miss an intersection.
+ */
+BOOST_AUTO_TEST_CASE( MatchSegDistances )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( -1000000, 1000000 );
+    std::uniform_int_distribution<int> small( -50, 50 );
+
+    std::vector<VECTOR2I> pts;
+
+    // A mix of long segments, short segments and degenerate (zero length) segments
+    for( int ii = 0; ii <= SEG_KERNEL_BLOCK; ++ii )
+    {
+        if( ii % 7 == 3 )
+            pts.push_back( pts.back() );
+        else if( ii % 3 == 0 && ii > 0 )
+            pts.push_back( pts.back() + VECTOR2I( small( rng ), small( rng ) ) );
+        else
+            pts.emplace_back( coord( rng ), coord( rng ) );
+    }
+
+    double distSq[SEG_KERNEL_BLOCK];
+
+    for( int trial = 0; trial < 200; ++trial )
+    {
+        VECTOR2I p( coord( rng ), coord( rng ) );
+        SEG      query( p, trial % 2 ? pts[trial % SEG_KERNEL_BLOCK] : VECTOR2I( coord( rng ),
+                                                                                coord( rng ) ) );
+
+        SegKernelSquaredDistances( p, pts.data(), SEG_KERNEL_BLOCK, distSq );
+
+        for( int ii = 0; ii < SEG_KERNEL_BLOCK; ++ii )
+        {
+            SEG::ecoord exact = SEG( pts[ii], pts[ii + 1] ).SquaredDistance( p );
+
+            BOOST_CHECK_LT( distSq[ii], SegKernelThreshold( exact ) );
+            BOOST_CHECK_LT( (double) exact, SegKernelThreshold( distSq[ii] ) );
+        }
+
+        SegKernelSquaredDistances( query, pts.data(), SEG_KERNEL_BLOCK, distSq );
+
+        for( int ii = 0; ii < SEG_KERNEL_BLOCK; ++ii )
+        {
+            SEG::ecoord exact = SEG( pts[ii], pts[ii + 1] ).SquaredDistance( query );
+
+            if( exact == 0 )
+                BOOST_CHECK_EQUAL( distSq[ii], 0.0 );
+            else
+                BOOST_CHECK_LT( distSq[ii], SegKernelThreshold( exact ) );
+        }
+    }
+}
+
+
+/**
+ * Collisions and distances measured through the kernels must be identical to those of a
+ * plain loop over the segments.
+ */
+BOOST_AUTO_TEST_CASE( ChainResultsUnchanged )
+{
+    SHAPE_LINE_CHAIN ring = wobblyRing( 1000, 100000 );
+    SHAPE_POLY_SET   poly;
+
+    poly.AddOutline( ring );
+    poly.AddHole( wobblyRing( 300, 30000 ) );
+
+    std::mt19937                       rng( 7 );
+    std::uniform_int_distribution<int> coord( -150000, 150000 );
+
+    for( int trial = 0; trial < 500; ++trial )
+    {
+        VECTOR2I p( coord( rng ), coord( rng ) );
+        SEG      seg( p, p + VECTOR2I( coord( rng ) / 10, coord( rng ) / 10 ) );
+
+        SEG::ecoord pointDist = VECTOR2I::ECOORD_MAX;
+        SEG::ecoord segDist = VECTOR2I::ECOORD_MAX;
+
+        for( int ii = 0; ii < ring.SegmentCount(); ++ii )
+        {
+            pointDist = std::min( pointDist, ring.CSegment( ii ).SquaredDistance( p ) );
+            segDist = std::min( segDist, ring.CSegment( ii ).SquaredDistance( seg ) );
+        }
+
+        BOOST_CHECK_EQUAL( ring.SquaredDistance( p, true ), pointDist );
+
+        if( !ring.PointInside( seg.A ) )
+        {
+            int actual = -1;
+
+            BOOST_CHECK( ring.Collide( seg, std::sqrt( (double) segDist ) + 1, &actual ) );
+            BOOST_CHECK_EQUAL( actual, (int) std::sqrt( (double) segDist ) );
+        }
+
+        // The polygon's distance also walks the hole
+        SEG::ecoord polyDist = pointDist;
+
+        for( int ii = 0; ii < poly.CHole( 0, 0 ).SegmentCount(); ++ii )
+            polyDist = std::min( polyDist, poly.CHole( 0, 0 ).CSegment( ii ).SquaredDistance( p ) );
+
+        if( !poly.Contains( p, -1, 1 ) )
+            BOOST_CHECK_EQUAL( poly.SquaredDistance( p ), polyDist );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
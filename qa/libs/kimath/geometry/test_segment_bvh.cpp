@@ -0,0 +1,201 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_line_chain.h>
+
+#include <cmath>
+#include <random>
+
+
+/**
+ * Presents a line chain without its segment hierarchy, so that queries on it test every
+ * segment.
+ */
+class PLAIN_CHAIN : public SHAPE_LINE_CHAIN_BASE
+{
+public:
+    PLAIN_CHAIN( const SHAPE_LINE_CHAIN& aChain ) :
+            SHAPE_LINE_CHAIN_BASE( SH_LINE_CHAIN ),
+            m_chain( aChain )
+    {
+    }
+
+    const BOX2I BBox( int aClearance = 0 ) const override { return m_chain.BBox( aClearance ); }
+    void Rotate( double aAngle, const VECTOR2I& aCenter ) override {}
+    void Move( const VECTOR2I& aVector ) override {}
+    bool IsSolid() const override { return false; }
+
+    const VECTOR2I GetPoint( int aIndex ) const override { return m_chain.GetPoint( aIndex ); }
+    const SEG GetSegment( int aIndex ) const override { return m_chain.GetSegment( aIndex ); }
+    size_t GetPointCount() const override { return m_chain.GetPointCount(); }
+    size_t GetSegmentCount() const override { return m_chain.GetSegmentCount(); }
+    bool IsClosed() const override { return m_chain.IsClosed(); }
+
+    const VECTOR2I* GetContiguousPoints() const override
+    {
+        return m_chain.GetContiguousPoints();
+    }
+
+private:
+    const SHAPE_LINE_CHAIN& m_chain;
+};
+
+
+/**
+ * A wobbly ring, as a zone fill outline might be.
+ */
+static SHAPE_LINE_CHAIN wobblyRing( int aPoints )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii < aPoints; ++ii )
+    {
+        double angle = 2.0 * M_PI * ii / aPoints;
+        double radius = 1000000.0 + 50000.0 * sin( angle * 37 );
+
+        chain.Append( VECTOR2I( KiROUND( radius * cos( angle ) ),
+                                KiROUND( radius * sin( angle ) ) ) );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+/**
+ * Checks the queries on aChain give the same results as testing every segment, once the
+ * chain has been queried often enough to build its hierarchy.
+ */
+static void checkQueries( const SHAPE_LINE_CHAIN& aChain, int aSeed )
+{
+    std::mt19937                       rng( aSeed );
+    std::uniform_int_distribution<int> coord( -1200000, 1200000 );
+    std::uniform_int_distribution<int> clearance( 0, 80000 );
+
+    PLAIN_CHAIN plain( aChain );
+
+    for( int ii = 0; ii < 400; ++ii )
+    {
+        VECTOR2I p( coord( rng ), coord( rng ) );
+
+        // Some points on or right next to the outline
+        if( ii % 4 == 0 )
+            p = aChain.CPoint( rng() % aChain.PointCount() ) + VECTOR2I( ii % 3, 0 );
+
+        SEG s( p, p + VECTOR2I( coord( rng ) / 8, coord( rng ) / 8 ) );
+        int c = clearance( rng );
+
+        BOOST_CHECK_EQUAL( aChain.SquaredDistance( p ), plain.SquaredDistance( p ) );
+        BOOST_CHECK_EQUAL( aChain.SquaredDistance( p, true ), plain.SquaredDistance( p, true ) );
+        BOOST_CHECK_EQUAL( aChain.PointInside( p ), plain.PointInside( p ) );
+        BOOST_CHECK_EQUAL( aChain.PointInside( p, 10 ), plain.PointInside( p, 10 ) );
+        BOOST_CHECK_EQUAL( aChain.EdgeContainingPoint( p, 2 ), plain.EdgeContainingPoint( p, 2 ) );
+
+        int      actual = -1, plainActual = -1;
+        VECTOR2I location, plainLocation;
+
+        BOOST_CHECK_EQUAL( aChain.Collide( p, c, &actual, &location ),
+                           plain.Collide( p, c, &plainActual, &plainLocation ) );
+        BOOST_CHECK_EQUAL( actual, plainActual );
+        BOOST_CHECK_EQUAL( location, plainLocation );
+
+        BOOST_CHECK_EQUAL( aChain.Collide( s, c, &actual, &location ),
+                           plain.Collide( s, c, &plainActual, &plainLocation ) );
+        BOOST_CHECK_EQUAL( actual, plainActual );
+        BOOST_CHECK_EQUAL( location, plainLocation );
+
+        BOOST_CHECK_EQUAL( aChain.Collide( s, c ), plain.Collide( s, c ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE( SegmentBVH )
+
+
+BOOST_AUTO_TEST_CASE( BuiltForLongChainsOnly )
+{
+    SHAPE_LINE_CHAIN shortChain = wobblyRing( SEGMENT_BVH::MIN_SEGMENTS / 2 );
+    SHAPE_LINE_CHAIN longChain = wobblyRing( 20000 );
+
+    for( int ii = 0; ii < 10; ++ii )
+    {
+        shortChain.PointInside( VECTOR2I( 0, 0 ) );
+        longChain.PointInside( VECTOR2I( 0, 0 ) );
+    }
+
+    BOOST_CHECK( shortChain.GetSegmentBVH() == nullptr );
+    BOOST_CHECK( longChain.GetSegmentBVH() != nullptr );
+
+    // Copies build their own
+    SHAPE_LINE_CHAIN copy = longChain;
+
+    BOOST_CHECK( copy.GetSegmentBVH() == nullptr );
+}
+
+
+BOOST_AUTO_TEST_CASE( ClosedChainQueries )
+{
+    checkQueries( wobblyRing( 20000 ), 1 );
+}
+
+
+BOOST_AUTO_TEST_CASE( OpenChainQueries )
+{
+    SHAPE_LINE_CHAIN chain = wobblyRing( 5000 );
+
+    chain.SetClosed( false );
+    checkQueries( chain, 2 );
+}
+
+
+/**
+ * Edits after the hierarchy is built must not leave it stale.
+ */
+BOOST_AUTO_TEST_CASE( FollowsEdits )
+{
+    SHAPE_LINE_CHAIN chain = wobblyRing( 20000 );
+
+    checkQueries( chain, 3 );
+
+    chain.Move( VECTOR2I( 123456, -65432 ) );
+    checkQueries( chain, 4 );
+
+    chain.SetPoint( 100, VECTOR2I( 0, 0 ) );
+    checkQueries( chain, 5 );
+
+    chain.Remove( 5000, 9000 );
+    checkQueries( chain, 6 );
+
+    chain.Append( VECTOR2I( -2000000, 0 ) );
+    checkQueries( chain, 7 );
+
+    chain.Rotate( 0.5 );
+    checkQueries( chain, 8 );
+
+    chain = wobblyRing( 3000 );
+    checkQueries( chain, 9 );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
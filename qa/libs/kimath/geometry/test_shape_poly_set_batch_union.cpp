@@ -0,0 +1,120 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+
+static double polySetArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        area += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            area -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+/**
+ * A grid of overlapping squares, with enough polygons to be split into batches.
+ */
+static SHAPE_POLY_SET overlappingSquares( int aColumns, int aRows )
+{
+    SHAPE_POLY_SET squares;
+
+    for( int xx = 0; xx < aColumns; ++xx )
+    {
+        for( int yy = 0; yy < aRows; ++yy )
+        {
+            // Leave a gap every fifth column so that the result has several outlines
+            int      pitch = 1000;
+            VECTOR2I origin( xx * pitch + ( xx / 5 ) * 500, yy * pitch );
+            int      size = ( xx % 5 == 4 ) ? pitch : pitch + 200;
+
+            squares.NewOutline();
+            squares.Append( origin );
+            squares.Append( origin + VECTOR2I( size, 0 ) );
+            squares.Append( origin + VECTOR2I( size, size ) );
+            squares.Append( origin + VECTOR2I( 0, size ) );
+        }
+    }
+
+    return squares;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetBatchUnion )
+
+
+BOOST_AUTO_TEST_CASE( MatchesSimplify )
+{
+    SHAPE_POLY_SET simplified = overlappingSquares( 40, 30 );
+    simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    // Any number of threads, including a thread budget of one, must give the same result
+    for( size_t maxThreads : { 0, 1, 2, 3, 8 } )
+    {
+        BOOST_TEST_CONTEXT( "max threads " << maxThreads )
+        {
+            SHAPE_POLY_SET batched = overlappingSquares( 40, 30 );
+            batched.BatchUnion( SHAPE_POLY_SET::PM_FAST, maxThreads );
+
+            BOOST_CHECK_EQUAL( batched.OutlineCount(), simplified.OutlineCount() );
+            BOOST_CHECK_CLOSE( polySetArea( batched ), polySetArea( simplified ), 1e-9 );
+
+            SHAPE_POLY_SET difference = batched;
+            difference.BooleanSubtract( simplified, SHAPE_POLY_SET::PM_FAST );
+            BOOST_CHECK_EQUAL( difference.OutlineCount(), 0 );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( SmallSet )
+{
+    SHAPE_POLY_SET squares = overlappingSquares( 2, 1 );
+
+    squares.BatchUnion( SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+    BOOST_CHECK_EQUAL( squares.OutlineCount(), 1 );
+    BOOST_CHECK_CLOSE( polySetArea( squares ), 2200.0 * 1200.0, 1e-9 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    SHAPE_POLY_SET empty;
+
+    empty.BatchUnion( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK( empty.IsEmpty() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
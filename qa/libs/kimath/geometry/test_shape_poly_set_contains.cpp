@@ -0,0 +1,145 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <random>
+
+
+/**
+ * A closed star-like outline with many vertices, so that Contains() indexes it.
+ */
+static SHAPE_LINE_CHAIN spikyRing( int aPointCount, int aRadius, VECTOR2I aCentre )
+{
+    SHAPE_LINE_CHAIN ring;
+
+    for( int ii = 0; ii < aPointCount; ++ii )
+    {
+        double angle = 2.0 * M_PI * ii / aPointCount;
+        double r = aRadius * ( ii % 2 ? 0.8 : 1.0 );
+
+        ring.Append( aCentre + VECTOR2I( r * std::cos( angle ), r * std::sin( angle ) ) );
+    }
+
+    ring.SetClosed( true );
+
+    return ring;
+}
+
+
+/**
+ * The reference answer, testing every edge of the outline and holes.
+ */
+static bool referenceContains( const SHAPE_POLY_SET& aSet, const VECTOR2I& aP, int aAccuracy )
+{
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        if( !aSet.COutline( ii ).PointInside( aP, aAccuracy ) )
+            continue;
+
+        bool inHole = false;
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            inHole |= aSet.CHole( ii, jj ).PointInside( aP, 1 );
+
+        if( !inHole )
+            return true;
+    }
+
+    return false;
+}
+
+
+struct CONTAINS_FIXTURE
+{
+    CONTAINS_FIXTURE()
+    {
+        m_poly.AddOutline( spikyRing( 400, 100000, { 0, 0 } ) );
+        m_poly.AddHole( spikyRing( 100, 30000, { 10000, 0 } ) );
+        m_poly.AddOutline( spikyRing( 8, 10000, { 200000, 0 } ) );
+    }
+
+    SHAPE_POLY_SET m_poly;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ShapePolySetContains, CONTAINS_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( MatchesReference )
+{
+    std::mt19937                       rng( 3 );
+    std::uniform_int_distribution<int> coord( -120000, 220000 );
+
+    for( int trial = 0; trial < 2000; ++trial )
+    {
+        // Include the vertices themselves, which sit exactly on band boundaries and edges
+        const SHAPE_LINE_CHAIN& outline = m_poly.COutline( 0 );
+        VECTOR2I p = trial % 5 == 0 ? outline.CPoint( trial % outline.PointCount() )
+                                    : VECTOR2I( coord( rng ), coord( rng ) / 2 );
+
+        for( int accuracy : { 0, 1, 50, 5000 } )
+        {
+            BOOST_CHECK_MESSAGE( m_poly.Contains( p, -1, accuracy )
+                                         == referenceContains( m_poly, p, accuracy ),
+                                 "point " << p << ", accuracy " << accuracy );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE( FollowsEdits )
+{
+    VECTOR2I p( 0, 95000 );
+
+    for( int ii = 0; ii < 20; ++ii )
+        BOOST_CHECK( m_poly.Contains( p ) );
+
+    m_poly.Move( VECTOR2I( 300000, 0 ) );
+    BOOST_CHECK( !m_poly.Contains( p ) );
+
+    m_poly.Move( VECTOR2I( -300000, 0 ) );
+    BOOST_CHECK( m_poly.Contains( p ) );
+
+    // Edits through references handed out by the set must be seen too
+    VECTOR2I q( 0, -60000 );
+
+    for( int ii = 0; ii < 20; ++ii )
+        BOOST_CHECK( m_poly.Contains( q ) );
+
+    SHAPE_LINE_CHAIN& outline = m_poly.Outline( 0 );
+
+    for( int ii = 0; ii < outline.PointCount(); ++ii )
+        outline.SetPoint( ii, outline.CPoint( ii ) + VECTOR2I( 0, 50000 ) );
+
+    BOOST_CHECK( !m_poly.Contains( q ) );
+
+    SHAPE_POLY_SET copy = m_poly;
+
+    for( int ii = 0; ii < 20; ++ii )
+        BOOST_CHECK_EQUAL( copy.Contains( p ), referenceContains( m_poly, p, 0 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,191 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <cmath>
+#include <random>
+
+
+static SHAPE_LINE_CHAIN rectangle( const VECTOR2I& aCorner, const VECTOR2I& aSize )
+{
+    return SHAPE_LINE_CHAIN( std::vector<VECTOR2I>{ aCorner,
+                                                    aCorner + VECTOR2I( aSize.x, 0 ),
+                                                    aSize + aCorner,
+                                                    aCorner + VECTOR2I( 0, aSize.y ) },
+                             true );
+}
+
+
+static SHAPE_LINE_CHAIN polygon( const VECTOR2I& aCentre, int aRadius, int aSides )
+{
+    SHAPE_LINE_CHAIN chain;
+
+    for( int ii = 0; ii < aSides; ++ii )
+    {
+        double angle = -2.0 * M_PI * ii / aSides;
+
+        chain.Append( aCentre + VECTOR2I( KiROUND( aRadius * cos( angle ) ),
+                                          KiROUND( aRadius * sin( angle ) ) ) );
+    }
+
+    chain.SetClosed( true );
+    return chain;
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double result = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        result += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            result -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return result;
+}
+
+
+/**
+ * Fractures aSet and checks the result covers the same area, without holes, and with the
+ * holes' centres still outside it.
+ */
+static void checkFracture( SHAPE_POLY_SET aSet, const std::vector<VECTOR2I>& aHoleCentres,
+                           const std::vector<VECTOR2I>& aCopper )
+{
+    double before = area( aSet );
+    int    outlines = aSet.OutlineCount();
+
+    aSet.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( aSet.OutlineCount(), outlines );
+    BOOST_CHECK( !aSet.HasHoles() );
+    // Bridges meet sloping edges at rounded coordinates
+    BOOST_CHECK_CLOSE( area( aSet ), before, 1e-5 );
+
+    for( const VECTOR2I& centre : aHoleCentres )
+        BOOST_CHECK_MESSAGE( !aSet.Contains( centre ), "hole at " << centre << " filled" );
+
+    for( const VECTOR2I& pt : aCopper )
+        BOOST_CHECK_MESSAGE( aSet.Contains( pt ), "copper at " << pt << " lost" );
+}
+
+
+BOOST_AUTO_TEST_SUITE( ShapePolySetFracture )
+
+
+/**
+ * Square holes in rows and columns: several holes share each left-most x, and each has two
+ * left-most vertices, in line with those of its neighbours.
+ */
+BOOST_AUTO_TEST_CASE( AlignedSquares )
+{
+    SHAPE_POLY_SET        set;
+    std::vector<VECTOR2I> centres;
+    std::vector<VECTOR2I> copper;
+
+    set.AddOutline( rectangle( { 0, 0 }, { 2100, 2100 } ) );
+
+    for( int ii = 0; ii < 20; ++ii )
+    {
+        for( int jj = 0; jj < 20; ++jj )
+        {
+            set.AddHole( rectangle( { 100 + 100 * ii, 100 + 100 * jj }, { 50, 50 } ) );
+            centres.emplace_back( 125 + 100 * ii, 125 + 100 * jj );
+            copper.emplace_back( 170 + 100 * ii, 180 + 100 * jj );
+        }
+    }
+
+    checkFracture( set, centres, copper );
+}
+
+
+/**
+ * An antipad per ball of a BGA, moved about a little so the rows aren't quite straight.
+ */
+BOOST_AUTO_TEST_CASE( JitteredAntipads )
+{
+    std::mt19937                       rng( 3 );
+    std::uniform_int_distribution<int> jitter( -20000, 20000 );
+
+    for( int sides : { 8, 13, 32 } )
+    {
+        SHAPE_POLY_SET        set;
+        std::vector<VECTOR2I> centres;
+        std::vector<VECTOR2I> copper;
+
+        set.AddOutline( rectangle( { -1000000, -1000000 }, { 31000000, 31000000 } ) );
+
+        for( int ii = 0; ii < 30; ++ii )
+        {
+            for( int jj = 0; jj < 30; ++jj )
+            {
+                VECTOR2I centre( ii * 1000000 + jitter( rng ), jj * 1000000 + jitter( rng ) );
+
+                set.AddHole( polygon( centre, 300000, sides ) );
+                centres.push_back( centre );
+                copper.push_back( centre + VECTOR2I( 500000, 500000 ) );
+            }
+        }
+
+        checkFracture( set, centres, copper );
+    }
+}
+
+
+/**
+ * Several outlines, each with holes, and an outline with none.
+ */
+BOOST_AUTO_TEST_CASE( SeveralOutlines )
+{
+    SHAPE_POLY_SET        set;
+    std::vector<VECTOR2I> centres;
+    std::vector<VECTOR2I> copper;
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        VECTOR2I origin( ii * 1000, ( ii % 2 ) * 300 );
+
+        set.AddOutline( rectangle( origin, { 800, 800 } ) );
+
+        for( int jj = 0; jj < ii; ++jj )
+        {
+            VECTOR2I centre = origin + VECTOR2I( 150 + 200 * jj, 150 + 250 * jj );
+
+            set.AddHole( polygon( centre, 60, 6 ) );
+            centres.push_back( centre );
+        }
+
+        copper.push_back( origin + VECTOR2I( 700, 100 ) );
+    }
+
+    checkFracture( set, centres, copper );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
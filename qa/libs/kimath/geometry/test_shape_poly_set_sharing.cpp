@@ -0,0 +1,194 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <future>
+
+
+struct SHARING_FIXTURE
+{
+    SHARING_FIXTURE()
+    {
+        m_original.AddOutline( square( VECTOR2I( 0, 0 ), 100000 ) );
+        m_original.AddHole( square( VECTOR2I( 25000, 25000 ), 50000 ) );
+        m_original.AddOutline( square( VECTOR2I( 200000, 0 ), 100000 ) );
+    }
+
+    static SHAPE_LINE_CHAIN square( const VECTOR2I& aCorner, int aSize )
+    {
+        return SHAPE_LINE_CHAIN( std::vector<VECTOR2I>{ aCorner,
+                                                        aCorner + VECTOR2I( aSize, 0 ),
+                                                        aCorner + VECTOR2I( aSize, aSize ),
+                                                        aCorner + VECTOR2I( 0, aSize ) },
+                                 true );
+    }
+
+    SHAPE_POLY_SET m_original;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ShapePolySetSharing, SHARING_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( CopiesShareUntilEdited )
+{
+    SHAPE_POLY_SET copy = m_original;
+    SHAPE_POLY_SET assigned;
+
+    assigned = m_original;
+
+    BOOST_CHECK_EQUAL( &copy.CPolygon( 0 ), &m_original.CPolygon( 0 ) );
+    BOOST_CHECK_EQUAL( &assigned.CPolygon( 0 ), &m_original.CPolygon( 0 ) );
+
+    const VECTOR2I corner = m_original.CVertex( 0 );
+
+    copy.Move( VECTOR2I( 10, 10 ) );
+    assigned.Append( VECTOR2I( 50000, -1000 ), 0 );
+
+    BOOST_CHECK( &copy.CPolygon( 0 ) != &m_original.CPolygon( 0 ) );
+    BOOST_CHECK( &assigned.CPolygon( 0 ) != &m_original.CPolygon( 0 ) );
+
+    BOOST_CHECK_EQUAL( m_original.CVertex( 0 ), corner );
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), corner + VECTOR2I( 10, 10 ) );
+    BOOST_CHECK_EQUAL( m_original.COutline( 0 ).PointCount(), 4 );
+    BOOST_CHECK_EQUAL( assigned.COutline( 0 ).PointCount(), 5 );
+
+    // The original isn't shared any more, so is edited in place
+    const SHAPE_POLY_SET::POLYGON* storage = &m_original.CPolygon( 0 );
+
+    m_original.Append( VECTOR2I( 50000, -1000 ), 0 );
+    BOOST_CHECK_EQUAL( &m_original.CPolygon( 0 ), storage );
+}
+
+
+BOOST_AUTO_TEST_CASE( BooleanOpsLeaveCopiesAlone )
+{
+    SHAPE_POLY_SET copy = m_original;
+    SHAPE_POLY_SET other( SHAPE_LINE_CHAIN( std::vector<VECTOR2I>{ { 50000, 50000 },
+                                                                   { 250000, 50000 },
+                                                                   { 250000, 60000 },
+                                                                   { 50000, 60000 } },
+                                            true ) );
+
+    copy.BooleanAdd( other, SHAPE_POLY_SET::PM_FAST );
+
+    BOOST_CHECK_EQUAL( copy.OutlineCount(), 1 );
+    BOOST_CHECK_EQUAL( m_original.OutlineCount(), 2 );
+    BOOST_CHECK_EQUAL( m_original.HoleCount( 0 ), 1 );
+}
+
+
+/**
+ * Writes through references handed out before a copy must not reach the copy.
+ */
+BOOST_AUTO_TEST_CASE( ExposedReferencesStayPrivate )
+{
+    SHAPE_LINE_CHAIN& outline = m_original.Outline( 0 );
+    SHAPE_POLY_SET    copy = m_original;
+
+    outline.SetPoint( 0, VECTOR2I( -5000, -5000 ) );
+
+    BOOST_CHECK_EQUAL( m_original.CVertex( 0 ), VECTOR2I( -5000, -5000 ) );
+    BOOST_CHECK_EQUAL( copy.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+
+    SHAPE_POLY_SET::POLYGON& polygon = m_original.Polygon( 1 );
+    SHAPE_POLY_SET           assigned;
+
+    assigned = m_original;
+    polygon.pop_back();
+
+    BOOST_CHECK_EQUAL( m_original.OutlineCount(), 2 );
+    BOOST_CHECK_EQUAL( assigned.CPolygon( 1 ).size(), 1 );
+
+    // Once replaced wholesale, the set can be shared again
+    m_original = copy;
+    SHAPE_POLY_SET again = m_original;
+
+    BOOST_CHECK_EQUAL( &again.CPolygon( 0 ), &copy.CPolygon( 0 ) );
+}
+
+
+BOOST_AUTO_TEST_CASE( TriangulationIsShared )
+{
+    m_original.CacheTriangulation();
+
+    SHAPE_POLY_SET copy = m_original;
+
+    BOOST_REQUIRE( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK_EQUAL( copy.TriangulatedPolygon( 0 ), m_original.TriangulatedPolygon( 0 ) );
+
+    VECTOR2I a, b, c;
+    VECTOR2I a2, b2, c2;
+
+    m_original.TriangulatedPolygon( 0 )->GetTriangle( 0, a, b, c );
+
+    copy.Move( VECTOR2I( 1000, 0 ) );
+
+    BOOST_CHECK( copy.IsTriangulationUpToDate() );
+    BOOST_CHECK( copy.TriangulatedPolygon( 0 ) != m_original.TriangulatedPolygon( 0 ) );
+
+    m_original.TriangulatedPolygon( 0 )->GetTriangle( 0, a2, b2, c2 );
+    BOOST_CHECK_EQUAL( a2, a );
+
+    copy.TriangulatedPolygon( 0 )->GetTriangle( 0, a2, b2, c2 );
+    BOOST_CHECK_EQUAL( a2, a + VECTOR2I( 1000, 0 ) );
+}
+
+
+/**
+ * Copies of one set edited on several threads at once.
+ */
+BOOST_AUTO_TEST_CASE( ConcurrentEdits )
+{
+    std::vector<std::future<VECTOR2I>> results;
+
+    for( int ii = 0; ii < 4; ++ii )
+    {
+        SHAPE_POLY_SET copy = m_original;
+
+        results.push_back( std::async( std::launch::async,
+                [ii]( SHAPE_POLY_SET aSet ) -> VECTOR2I
+                {
+                    for( int jj = 0; jj < 100; ++jj )
+                    {
+                        SHAPE_POLY_SET local = aSet;
+
+                        local.Move( VECTOR2I( ii, jj ) );
+                        aSet = local;
+                    }
+
+                    return aSet.CVertex( 0 );
+                },
+                copy ) );
+    }
+
+    for( int ii = 0; ii < 4; ++ii )
+        BOOST_CHECK_EQUAL( results[ii].get(), VECTOR2I( 100 * ii, 4950 ) );
+
+    BOOST_CHECK_EQUAL( m_original.CVertex( 0 ), VECTOR2I( 0, 0 ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
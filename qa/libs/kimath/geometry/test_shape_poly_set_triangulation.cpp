@@ -0,0 +1,239 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/shape_poly_set.h>
+
+#include <set>
+
+
+/**
+ * A square island of side aSize at aOrigin, with a square hole in the middle.
+ */
+static void addIsland( SHAPE_POLY_SET& aSet, const VECTOR2I& aOrigin, int aSize )
+{
+    SHAPE_LINE_CHAIN outline;
+    SHAPE_LINE_CHAIN hole;
+
+    outline.Append( aOrigin );
+    outline.Append( aOrigin + VECTOR2I( aSize, 0 ) );
+    outline.Append( aOrigin + VECTOR2I( aSize, aSize ) );
+    outline.Append( aOrigin + VECTOR2I( 0, aSize ) );
+    outline.SetClosed( true );
+
+    hole.Append( aOrigin + VECTOR2I( aSize / 4, aSize / 4 ) );
+    hole.Append( aOrigin + VECTOR2I( aSize / 4, 3 * aSize / 4 ) );
+    hole.Append( aOrigin + VECTOR2I( 3 * aSize / 4, 3 * aSize / 4 ) );
+    hole.Append( aOrigin + VECTOR2I( 3 * aSize / 4, aSize / 4 ) );
+    hole.SetClosed( true );
+
+    aSet.AddOutline( outline );
+    aSet.AddHole( hole );
+}
+
+
+static double polygonArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        area += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            area -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+static double triangulatedArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( unsigned ii = 0; ii < aSet.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tpoly = aSet.TriangulatedPolygon( ii );
+
+        for( size_t jj = 0; jj < tpoly->GetTriangleCount(); ++jj )
+        {
+            VECTOR2I a, b, c;
+
+            tpoly->GetTriangle( jj, a, b, c );
+            area += std::abs( (double) ( b - a ).Cross( c - a ) ) / 2.0;
+        }
+    }
+
+    return area;
+}
+
+
+static std::set<const SHAPE_POLY_SET::TRIANGULATED_POLYGON*> parts( const SHAPE_POLY_SET& aSet )
+{
+    std::set<const SHAPE_POLY_SET::TRIANGULATED_POLYGON*> result;
+
+    for( unsigned ii = 0; ii < aSet.TriangulatedPolyCount(); ++ii )
+        result.insert( aSet.TriangulatedPolygon( ii ) );
+
+    return result;
+}
+
+
+struct TRIANGULATION_FIXTURE
+{
+    TRIANGULATION_FIXTURE()
+    {
+        // Large enough to be split into several cells each, and to be worth some threads
+        for( int ii = 0; ii < 12; ++ii )
+            addIsland( m_islands, VECTOR2I( ii * 40000000, 0 ), 30000000 );
+    }
+
+    SHAPE_POLY_SET m_islands;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ShapePolySetTriangulation, TRIANGULATION_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( CoversPolygons )
+{
+    for( bool partition : { true, false } )
+    {
+        SHAPE_POLY_SET islands = m_islands;
+
+        islands.CacheTriangulation( partition );
+
+        BOOST_CHECK( islands.IsTriangulationUpToDate() );
+        BOOST_CHECK_CLOSE( triangulatedArea( islands ), polygonArea( islands ), 1e-6 );
+    }
+}
+
+
+/**
+ * Editing one island re-triangulates that island only.
+ */
+BOOST_AUTO_TEST_CASE( KeepsUnchangedIslands )
+{
+    m_islands.CacheTriangulation();
+
+    auto before = parts( m_islands );
+
+    m_islands.Outline( 3 ).SetPoint( 2, m_islands.COutline( 3 ).CPoint( 2 ) + VECTOR2I( 1000, 0 ) );
+    BOOST_CHECK( !m_islands.IsTriangulationUpToDate() );
+
+    m_islands.CacheTriangulation();
+
+    BOOST_CHECK( m_islands.IsTriangulationUpToDate() );
+    BOOST_CHECK_CLOSE( triangulatedArea( m_islands ), polygonArea( m_islands ), 1e-6 );
+
+    auto after = parts( m_islands );
+    int  kept = 0;
+
+    for( const SHAPE_POLY_SET::TRIANGULATED_POLYGON* part : after )
+        kept += before.count( part );
+
+    BOOST_CHECK_GT( kept, 0 );
+
+    // A change of partitioning can't reuse anything: unpartitioned, each island is one part
+    m_islands.Outline( 3 ).SetPoint( 2, m_islands.COutline( 3 ).CPoint( 2 ) - VECTOR2I( 1000, 0 ) );
+    m_islands.CacheTriangulation( false );
+
+    BOOST_CHECK_GT( after.size(), 12 );
+    BOOST_CHECK_EQUAL( m_islands.TriangulatedPolyCount(), 12 );
+    BOOST_CHECK_CLOSE( triangulatedArea( m_islands ), polygonArea( m_islands ), 1e-6 );
+}
+
+
+/**
+ * A refill assigns a new set over the old one: islands that are only moved keep their
+ * triangulation, moved along with them.
+ */
+BOOST_AUTO_TEST_CASE( KeepsIslandsAcrossAssignment )
+{
+    m_islands.CacheTriangulation();
+
+    auto before = parts( m_islands );
+
+    SHAPE_POLY_SET refill;
+
+    for( int ii = 0; ii < 12; ++ii )
+        addIsland( refill, VECTOR2I( ii * 40000000, 5000 ), ii == 7 ? 20000000 : 30000000 );
+
+    m_islands = refill;
+    BOOST_CHECK( !m_islands.IsTriangulationUpToDate() );
+
+    m_islands.CacheTriangulation();
+
+    BOOST_CHECK( m_islands.IsTriangulationUpToDate() );
+    BOOST_CHECK_CLOSE( triangulatedArea( m_islands ), polygonArea( m_islands ), 1e-6 );
+
+    int kept = 0;
+
+    for( const SHAPE_POLY_SET::TRIANGULATED_POLYGON* part : parts( m_islands ) )
+        kept += before.count( part );
+
+    BOOST_CHECK_GT( kept, 0 );
+
+    // The kept parts must have moved with their islands
+    int top = std::numeric_limits<int>::max();
+
+    for( unsigned ii = 0; ii < m_islands.TriangulatedPolyCount(); ++ii )
+    {
+        const SHAPE_POLY_SET::TRIANGULATED_POLYGON* tpoly = m_islands.TriangulatedPolygon( ii );
+
+        for( size_t jj = 0; jj < tpoly->GetTriangleCount(); ++jj )
+        {
+            VECTOR2I a, b, c;
+
+            tpoly->GetTriangle( jj, a, b, c );
+            top = std::min( { top, a.y, b.y, c.y } );
+        }
+    }
+
+    BOOST_CHECK_EQUAL( top, 5000 );
+
+    m_islands.Move( VECTOR2I( -5000, -5000 ) );
+    BOOST_CHECK( m_islands.IsTriangulationUpToDate() );
+}
+
+
+BOOST_AUTO_TEST_CASE( TriangulatesSeveralSets )
+{
+    SHAPE_POLY_SET first = m_islands;
+    SHAPE_POLY_SET second;
+    SHAPE_POLY_SET empty;
+
+    addIsland( second, VECTOR2I( 0, 0 ), 1000000 );
+
+    SHAPE_POLY_SET::CacheTriangulations( { &first, &second, &empty } );
+
+    for( const SHAPE_POLY_SET* set : { &first, &second, &empty } )
+    {
+        BOOST_CHECK( set->IsTriangulationUpToDate() );
+        BOOST_CHECK_CLOSE( triangulatedArea( *set ), polygonArea( *set ), 1e-6 );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <convert_basic_shapes_to_polygon.h>
+
+#include <trigo.h>
+
+
+/**
+ * @return the points of all the outlines of aSet, moved by -aOffset.
+ */
+static std::vector<VECTOR2I> pointsRelativeTo( const SHAPE_POLY_SET& aSet, const VECTOR2I& aOffset )
+{
+    std::vector<VECTOR2I> points;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        for( int jj = 0; jj < aSet.COutline( ii ).PointCount(); ++jj )
+            points.push_back( aSet.COutline( ii ).CPoint( jj ) - aOffset );
+    }
+
+    return points;
+}
+
+
+BOOST_AUTO_TEST_SUITE( ConvertBasicShapesToPolygon )
+
+
+/**
+ * The precomputed sines and cosines must put corners where RotatePoint() does.
+ */
+BOOST_AUTO_TEST_CASE( CircleMatchesRotatePoint )
+{
+    for( int radius : { 1, 10, 999, 125000, 400000, 2000000 } )
+    {
+        for( int error : { 5, 100, 1000, 5000 } )
+        {
+            SHAPE_POLY_SET circle;
+            wxPoint        centre( 12345, -6789 );
+
+            TransformCircleToPolygon( circle, centre, radius, error, ERROR_INSIDE );
+
+            int delta = 3600 / GetArcToSegmentCount( radius, error, 360.0 );
+            std::vector<VECTOR2I> expected;
+
+            for( int angle = 0; angle < 3600; angle += delta )
+            {
+                wxPoint corner( radius, 0 );
+                RotatePoint( &corner, angle );
+                expected.push_back( corner );
+            }
+
+            expected.push_back( VECTOR2I( radius, 0 ) );
+
+            std::vector<VECTOR2I> actual = pointsRelativeTo( circle, centre );
+
+            BOOST_CHECK_EQUAL_COLLECTIONS( actual.begin(), actual.end(), expected.begin(),
+                                           expected.end() );
+        }
+    }
+}
+
+
+/**
+ * Shapes served from the cache must be the ones that would have been built in place.
+ */
+BOOST_AUTO_TEST_CASE( CachedShapesFollowPosition )
+{
+    const wxPoint offsets[] = { { 0, 0 }, { 1000000, -250000 }, { -33, 77 } };
+
+    std::vector<VECTOR2I> firstOval;
+    std::vector<VECTOR2I> firstRect;
+
+    for( const wxPoint& offset : offsets )
+    {
+        SHAPE_POLY_SET oval;
+        SHAPE_POLY_SET rect;
+
+        TransformOvalToPolygon( oval, offset, offset + wxPoint( 300000, 120000 ), 150000, 5000,
+                                ERROR_OUTSIDE );
+        TransformRoundChamferedRectToPolygon( rect, offset, wxSize( 600000, 400000 ), 450.0,
+                                              50000, 0.25, RECT_CHAMFER_TOP_LEFT, 5000,
+                                              ERROR_INSIDE );
+
+        std::vector<VECTOR2I> ovalPoints = pointsRelativeTo( oval, offset );
+        std::vector<VECTOR2I> rectPoints = pointsRelativeTo( rect, offset );
+
+        BOOST_REQUIRE( !ovalPoints.empty() );
+        BOOST_REQUIRE( !rectPoints.empty() );
+
+        if( firstOval.empty() )
+        {
+            firstOval = ovalPoints;
+            firstRect = rectPoints;
+            continue;
+        }
+
+        BOOST_CHECK_EQUAL_COLLECTIONS( ovalPoints.begin(), ovalPoints.end(), firstOval.begin(),
+                                       firstOval.end() );
+        BOOST_CHECK_EQUAL_COLLECTIONS( rectPoints.begin(), rectPoints.end(), firstRect.begin(),
+                                       firstRect.end() );
+    }
+
+    // A different size must not be served the cached shape
+    SHAPE_POLY_SET other;
+
+    TransformRoundChamferedRectToPolygon( other, wxPoint( 0, 0 ), wxSize( 600000, 400002 ), 450.0,
+                                          50000, 0.25, RECT_CHAMFER_TOP_LEFT, 5000,
+                                          ERROR_INSIDE );
+
+    BOOST_CHECK( pointsRelativeTo( other, VECTOR2I( 0, 0 ) ) != firstRect );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
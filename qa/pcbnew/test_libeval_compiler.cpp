@@ -30,6 +30,7 @@
 
 #include <pcbnew/class_board.h>
 #include <pcbnew/class_track.h>
+#include <drc/drc_rule_condition.h>
 
 BOOST_AUTO_TEST_SUITE( Libeval_Compiler )
 
@@ -131,6 +132,23 @@ static bool testEvalExpr( const wxString& expr, LIBEVAL::VALUE expectedResult,
         BOOST_CHECK_EQUAL( result.AsString(), expectedResult.AsString() );
     }
 
+    // The closures must give the same result as the stack machine
+    BOOST_CHECK( ucode.Lower() );
+
+    if( ucode.IsLowered() )
+    {
+        PCB_EXPR_CONTEXT loweredContext;
+        loweredContext.SetItems( itemA, itemB );
+
+        LIBEVAL::VALUE loweredResult = *ucode.Run( &loweredContext );
+
+        BOOST_CHECK_EQUAL( loweredResult.GetType(), result.GetType() );
+
+        if( result.GetType() == LIBEVAL::VT_NUMERIC )
+            BOOST_CHECK_EQUAL( loweredResult.AsDouble(), result.AsDouble() );
+        else
+            BOOST_CHECK_EQUAL( loweredResult.AsString(), result.AsString() );
+    }
 
     return ok;
 }
@@ -178,4 +196,32 @@ BOOST_AUTO_TEST_CASE( IntrospectedProperties )
     }
 }
 
+BOOST_AUTO_TEST_CASE( CacheableConditions )
+{
+    PROPERTY_MANAGER& propMgr = PROPERTY_MANAGER::Instance();
+    propMgr.Rebuild();
+
+    const std::vector<std::pair<wxString, bool>> conditions = {
+        { "", true },
+        { "A.NetClass == 'HV' && A.isDiffPair()", true },
+        { "A.netclass == 'HV' && B.Via_Type == 'Micro'", true },
+        { "A.Type == 'Pad' && A.isPlated()", true },
+        { "A.insideArea('keepout')", false },
+        { "A.Width > 1mm", false },
+        { "A.existsOnLayer('F.Cu')", false }
+    };
+
+    for( const std::pair<wxString, bool>& entry : conditions )
+    {
+        DRC_RULE_CONDITION condition( entry.first );
+
+        BOOST_TEST_MESSAGE( "Condition: '" << entry.first.c_str() << "'" );
+
+        if( !entry.first.IsEmpty() )
+            BOOST_CHECK( condition.Compile( nullptr ) );
+
+        BOOST_CHECK_EQUAL( condition.IsCacheable(), entry.second );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
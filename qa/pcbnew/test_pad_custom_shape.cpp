@@ -0,0 +1,101 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+
+
+static double polygonArea( const SHAPE_POLY_SET& aSet )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        area += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            area -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+struct CUSTOM_PAD_FIXTURE
+{
+    CUSTOM_PAD_FIXTURE() : m_board(), m_module( &m_board ), m_pad( &m_module )
+    {
+        m_pad.SetShape( PAD_SHAPE_CUSTOM );
+        m_pad.SetAnchorPadShape( PAD_SHAPE_CIRCLE );
+        m_pad.SetSize( wxSize( 500000, 500000 ) );
+
+        // A track stub ending in an arc, and a filled circle and rectangle
+        m_pad.AddPrimitiveSegment( wxPoint( 0, 0 ), wxPoint( 2000000, 0 ), 300000 );
+        m_pad.AddPrimitiveArc( wxPoint( 2000000, 1000000 ), wxPoint( 2000000, 0 ), 900, 300000 );
+        m_pad.AddPrimitiveCircle( wxPoint( -1500000, 0 ), 600000, 0 );
+        m_pad.AddPrimitiveRect( wxPoint( -400000, 500000 ), wxPoint( 400000, 1800000 ), 0 );
+    }
+
+    BOARD  m_board;
+    MODULE m_module;
+    D_PAD  m_pad;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PadCustomShape, CUSTOM_PAD_FIXTURE )
+
+
+/**
+ * Growing each primitive must give the shape that inflating the merged primitives gives.
+ */
+BOOST_AUTO_TEST_CASE( InflatedPrimitivesMatchInflatedMerge )
+{
+    for( int inflate : { 10000, 200000, 1000000 } )
+    {
+        SHAPE_POLY_SET expected;
+        SHAPE_POLY_SET actual;
+
+        m_pad.MergePrimitivesAsPolygon( &expected, UNDEFINED_LAYER );
+        expected.Inflate( inflate, 64 );
+
+        m_pad.MergeInflatedPrimitivesAsPolygon( &actual, UNDEFINED_LAYER, inflate, 1000,
+                                                ERROR_INSIDE );
+
+        BOOST_CHECK_EQUAL( actual.OutlineCount(), expected.OutlineCount() );
+        BOOST_CHECK_CLOSE( polygonArea( actual ), polygonArea( expected ), 0.5 );
+
+        // Filled primitives stay filled
+        BOOST_CHECK( actual.Contains( VECTOR2I( -1500000, 0 ) ) );
+        BOOST_CHECK( actual.Contains( VECTOR2I( 0, 1200000 ) ) );
+
+        // and the anchor and track stub grow by the full amount
+        BOOST_CHECK( actual.Contains( VECTOR2I( 0, -250000 - inflate + 2000 ) ) );
+        BOOST_CHECK( actual.Contains( VECTOR2I( 1000000, -150000 - inflate + 2000 ) ) );
+        BOOST_CHECK( !actual.Contains( VECTOR2I( 1000000, -150000 - inflate - 2000 ) ) );
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+#include <plugins/kicad/zone_fill_cache_file.h>
+
+
+struct ZONE_FILL_CACHE_FIXTURE
+{
+    ZONE_FILL_CACHE_FIXTURE()
+    {
+        m_fileName = wxFileName::CreateTempFileName( "qa_fills" );
+
+        std::vector<VECTOR2I> outline = { { 0, 0 }, { 1000, 0 }, { 1000, 1000 }, { 0, 1000 } };
+        std::vector<VECTOR2I> hole = { { 100, 100 }, { 200, 100 }, { 200, 200 } };
+        std::vector<VECTOR2I> island = { { 2000, 0 }, { 2500, 0 }, { 2500, -500 } };
+
+        m_fill.AddOutline( SHAPE_LINE_CHAIN( outline, true ) );
+        m_fill.AddHole( SHAPE_LINE_CHAIN( hole, true ) );
+        m_fill.AddOutline( SHAPE_LINE_CHAIN( island, true ) );
+    }
+
+    ~ZONE_FILL_CACHE_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    wxString       m_fileName;
+    SHAPE_POLY_SET m_fill;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFillCacheFile, ZONE_FILL_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    ZONE_FILL_CACHE_FILE cache;
+    std::string          key = cache.Add( m_fill, { 1 } );
+
+    BOOST_CHECK_EQUAL( key, ZONE_FILL_CACHE_FILE::HashKey( m_fill, { 1 } ) );
+
+    cache.Save( m_fileName );
+
+    ZONE_FILL_CACHE_FILE loaded;
+    BOOST_REQUIRE( loaded.Load( m_fileName ) );
+
+    const ZONE_FILL_CACHE_FILE::FILL* fill = loaded.Get( key );
+    BOOST_REQUIRE( fill );
+
+    BOOST_CHECK_EQUAL( fill->m_polys.OutlineCount(), 2 );
+    BOOST_CHECK_EQUAL( fill->m_polys.HoleCount( 0 ), 1 );
+    BOOST_CHECK( fill->m_islands == std::set<int>( { 1 } ) );
+    BOOST_CHECK_EQUAL( ZONE_FILL_CACHE_FILE::HashKey( fill->m_polys, fill->m_islands ), key );
+
+    BOOST_CHECK( loaded.Get( "not a key" ) == nullptr );
+}
+
+
+BOOST_AUTO_TEST_CASE( IslandsAreKeyed )
+{
+    ZONE_FILL_CACHE_FILE cache;
+    std::string          withIsland = cache.Add( m_fill, { 1 } );
+    std::string          withoutIsland = cache.Add( m_fill, {} );
+
+    BOOST_CHECK( withIsland != withoutIsland );
+
+    BOOST_REQUIRE( cache.Get( withIsland ) );
+    BOOST_REQUIRE( cache.Get( withoutIsland ) );
+    BOOST_CHECK( cache.Get( withIsland )->m_islands == std::set<int>( { 1 } ) );
+    BOOST_CHECK( cache.Get( withoutIsland )->m_islands.empty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( StaleTriangulation )
+{
+    // A fill mirrored after it was triangulated keeps the hash of its triangulation
+    m_fill.CacheTriangulation();
+    m_fill.Mirror( true, false );
+
+    ZONE_FILL_CACHE_FILE cache;
+    std::string          key = cache.Add( m_fill, { 1 } );
+
+    cache.Save( m_fileName );
+
+    ZONE_FILL_CACHE_FILE loaded;
+    BOOST_REQUIRE( loaded.Load( m_fileName ) );
+    BOOST_CHECK( loaded.Get( key ) != nullptr );
+}
+
+
+BOOST_AUTO_TEST_CASE( Truncated )
+{
+    ZONE_FILL_CACHE_FILE cache;
+    cache.Add( m_fill, {} );
+    cache.Save( m_fileName );
+
+    std::vector<char> buf;
+
+    {
+        wxFFile file( m_fileName, "rb" );
+        BOOST_REQUIRE( file.IsOpened() );
+        buf.resize( file.Length() );
+        BOOST_REQUIRE_EQUAL( file.Read( buf.data(), buf.size() ), buf.size() );
+    }
+
+    {
+        wxFFile file( m_fileName, "wb" );
+        BOOST_REQUIRE( file.IsOpened() );
+        file.Write( buf.data(), buf.size() - 3 );
+    }
+
+    ZONE_FILL_CACHE_FILE loaded;
+    BOOST_CHECK( !loaded.Load( m_fileName ) );
+    BOOST_CHECK( loaded.IsEmpty() );
+}
+
+
+BOOST_AUTO_TEST_CASE( Missing )
+{
+    wxRemoveFile( m_fileName );
+
+    ZONE_FILL_CACHE_FILE loaded;
+    BOOST_CHECK( !loaded.Load( m_fileName ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
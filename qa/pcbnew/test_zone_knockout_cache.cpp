@@ -0,0 +1,156 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <netinfo.h>
+#include <zone_knockout_cache.h>
+
+
+struct KNOCKOUT_CACHE_FIXTURE
+{
+    KNOCKOUT_CACHE_FIXTURE() : m_board(), m_module( &m_board ), m_pad( &m_module )
+    {
+        m_pad.SetShape( PAD_SHAPE_RECT );
+        m_pad.SetAttribute( PAD_ATTRIB_PTH );
+        m_pad.SetLayerSet( D_PAD::PTHMask() );
+        m_pad.SetSize( wxSize( 1000000, 1000000 ) );
+        m_pad.SetDrillSize( wxSize( 400000, 400000 ) );
+
+        m_knockout.AddOutline( SHAPE_LINE_CHAIN( { { 0, 0 }, { 10, 0 }, { 10, 10 } }, true ) );
+    }
+
+    bool isCached()
+    {
+        SHAPE_POLY_SET knockouts;
+        return m_cache.Get( &m_pad, F_Cu, 200000, 5000, knockouts );
+    }
+
+    BOARD               m_board;
+    MODULE              m_module;
+    D_PAD               m_pad;
+    SHAPE_POLY_SET      m_knockout;
+    ZONE_KNOCKOUT_CACHE m_cache;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneKnockoutCache, KNOCKOUT_CACHE_FIXTURE )
+
+
+BOOST_AUTO_TEST_CASE( Lookup )
+{
+    BOOST_CHECK( !isCached() );
+
+    m_cache.Add( &m_pad, F_Cu, 200000, 5000, m_knockout );
+    BOOST_CHECK( isCached() );
+
+    SHAPE_POLY_SET knockouts;
+    BOOST_CHECK( !m_cache.Get( &m_pad, B_Cu, 200000, 5000, knockouts ) );
+    BOOST_CHECK( !m_cache.Get( &m_pad, F_Cu, 100000, 5000, knockouts ) );
+}
+
+
+/**
+ * Changes which leave the pad's bounding box alone must still miss the cache.
+ */
+BOOST_AUTO_TEST_CASE( SameBoundingBoxChanges )
+{
+    m_cache.Add( &m_pad, F_Cu, 200000, 5000, m_knockout );
+
+    m_pad.SetDrillSize( wxSize( 600000, 600000 ) );
+    BOOST_CHECK( !isCached() );
+
+    m_cache.Add( &m_pad, F_Cu, 200000, 5000, m_knockout );
+    BOOST_CHECK( isCached() );
+
+    m_pad.SetShape( PAD_SHAPE_ROUNDRECT );
+    BOOST_CHECK( !isCached() );
+
+    m_cache.Add( &m_pad, F_Cu, 200000, 5000, m_knockout );
+    m_pad.SetRoundRectRadiusRatio( 0.1 );
+    BOOST_CHECK( !isCached() );
+}
+
+
+/**
+ * Invalidating a footprint drops the entries of pads it had, even once they are gone.
+ */
+BOOST_AUTO_TEST_CASE( InvalidateFootprint )
+{
+    m_cache.Add( &m_pad, F_Cu, 200000, 5000, m_knockout );
+
+    // m_pad isn't in the footprint's pad list, as if it had been deleted from it
+    BOOST_REQUIRE( m_module.Pads().empty() );
+    m_cache.Invalidate( &m_module );
+
+    BOOST_CHECK( !isCached() );
+}
+
+
+/**
+ * Connecting a track to a via with unconnected layers removed flashes it on the track's
+ * layer, which changes its knockout there although the via itself is untouched.
+ */
+BOOST_AUTO_TEST_CASE( ConnectionFlashesVia )
+{
+    m_board.SetCopperLayerCount( 4 );
+
+    NETINFO_ITEM* net = new NETINFO_ITEM( &m_board, "net1", 1 );
+    m_board.Add( net );
+
+    VIA* via = new VIA( &m_board );
+    via->SetViaType( VIATYPE::THROUGH );
+    via->SetLayerPair( F_Cu, B_Cu );
+    via->SetPosition( wxPoint( 0, 0 ) );
+    via->SetWidth( 800000 );
+    via->SetDrill( 400000 );
+    via->SetRemoveUnconnected( true );
+    via->SetKeepTopBottom( true );
+    via->SetNetCode( net->GetNet() );
+    m_board.Add( via );
+    m_board.BuildConnectivity();
+
+    BOOST_REQUIRE( !via->FlashLayer( In1_Cu ) );
+
+    SHAPE_POLY_SET knockouts;
+    m_cache.Add( via, In1_Cu, 200000, 5000, m_knockout );
+    BOOST_CHECK( m_cache.Get( via, In1_Cu, 200000, 5000, knockouts ) );
+
+    TRACK* track = new TRACK( &m_board );
+    track->SetLayer( In1_Cu );
+    track->SetStart( wxPoint( 0, 0 ) );
+    track->SetEnd( wxPoint( 2000000, 0 ) );
+    track->SetWidth( 250000 );
+    track->SetNetCode( net->GetNet() );
+    m_board.Add( track );
+    m_board.BuildConnectivity();
+
+    BOOST_REQUIRE( via->FlashLayer( In1_Cu ) );
+    BOOST_CHECK( !m_cache.Get( via, In1_Cu, 200000, 5000, knockouts ) );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
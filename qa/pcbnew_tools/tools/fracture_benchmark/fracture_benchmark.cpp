@@ -0,0 +1,151 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <convert_basic_shapes_to_polygon.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <profile.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+
+/**
+ * Times SHAPE_POLY_SET::Fracture() on the plane under a BGA fanout: a copper pour with a
+ * grid of antipads, one per ball.
+ */
+
+enum FRACTURE_BENCH_RET_CODES
+{
+    BAD_RESULT = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+/// 1mm ball pitch, with 0.7mm antipads
+static const int PITCH = 1000000;
+static const int ANTIPAD_RADIUS = 350000;
+static const int MAX_ERROR = 5000;
+
+
+static SHAPE_POLY_SET bgaPlane( int aBalls )
+{
+    SHAPE_POLY_SET   plane;
+    SHAPE_LINE_CHAIN outline;
+
+    outline.Append( -PITCH, -PITCH );
+    outline.Append( aBalls * PITCH, -PITCH );
+    outline.Append( aBalls * PITCH, aBalls * PITCH );
+    outline.Append( -PITCH, aBalls * PITCH );
+    outline.SetClosed( true );
+
+    plane.AddOutline( outline );
+
+    for( int ii = 0; ii < aBalls; ++ii )
+    {
+        for( int jj = 0; jj < aBalls; ++jj )
+        {
+            SHAPE_POLY_SET antipad;
+
+            TransformCircleToPolygon( antipad, wxPoint( ii * PITCH, jj * PITCH ), ANTIPAD_RADIUS,
+                                      MAX_ERROR, ERROR_OUTSIDE );
+
+            // Wound the other way to the outline, as holes are
+            plane.AddHole( antipad.COutline( 0 ).Reverse() );
+        }
+    }
+
+    return plane;
+}
+
+
+static double area( const SHAPE_POLY_SET& aSet )
+{
+    double result = 0.0;
+
+    for( int ii = 0; ii < aSet.OutlineCount(); ++ii )
+    {
+        result += std::abs( aSet.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aSet.HoleCount( ii ); ++jj )
+            result -= std::abs( aSet.CHole( ii, jj ).Area() );
+    }
+
+    return result;
+}
+
+
+int fracture_benchmark_main( int argc, char* argv[] )
+{
+    int balls = 100;
+
+    if( argc > 1 )
+        balls = std::max( 1, atoi( argv[1] ) );
+
+    SHAPE_POLY_SET plane = bgaPlane( balls );
+    double         before = area( plane );
+
+    std::cout << plane.HoleCount( 0 ) << " antipads, " << plane.TotalVertices() << " vertices"
+              << std::endl;
+
+    SHAPE_POLY_SET simplified = plane;
+
+    PROF_COUNTER simplifyTimer( "simplify" );
+    simplified.Simplify( SHAPE_POLY_SET::PM_FAST );
+    simplifyTimer.Stop();
+    simplifyTimer.Show( std::cout );
+
+    PROF_COUNTER fractureTimer( "simplify + fracture" );
+    plane.Fracture( SHAPE_POLY_SET::PM_FAST );
+    fractureTimer.Stop();
+    fractureTimer.Show( std::cout );
+
+    std::cout << "fracture alone: " << fractureTimer.msecs() - simplifyTimer.msecs() << " ms"
+              << std::endl;
+
+    if( plane.OutlineCount() != 1 || plane.HoleCount( 0 ) != 0 )
+    {
+        std::cerr << "Fracturing left " << plane.OutlineCount() << " outlines" << std::endl;
+        return FRACTURE_BENCH_RET_CODES::BAD_RESULT;
+    }
+
+    if( std::abs( area( plane ) - before ) > 1e-6 * before )
+    {
+        std::cerr << "Fracturing changed the area from " << before << " to " << area( plane )
+                  << std::endl;
+        return FRACTURE_BENCH_RET_CODES::BAD_RESULT;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "fracture_benchmark",
+        "Benchmark fracturing a copper plane with a grid of antipads, as under a BGA",
+        fracture_benchmark_main,
+} );
@@ -35,8 +35,6 @@
 #include <class_zone.h>
 #include <profile.h>
 
-#include <atomic>
-#include <thread>
 #include <unordered_set>
 #include <utility>
 
@@ -220,53 +218,23 @@ int polygon_triangulation_main( int argc, char *argv[] )
     PROF_COUNTER cnt( "allBoard" );
 
 
-    std::atomic<size_t> zonesToTriangulate( 0 );
-    std::atomic<size_t> threadsFinished( 0 );
+    std::vector<SHAPE_POLY_SET> polys;
 
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
+    for( int areaId = 0; areaId < brd->GetAreaCount(); areaId++ )
     {
-        std::thread t = std::thread( [&brd, &zonesToTriangulate, &threadsFinished]() {
-            for( size_t areaId = zonesToTriangulate.fetch_add( 1 );
-                        areaId < static_cast<size_t>( brd->GetAreaCount() );
-                        areaId = zonesToTriangulate.fetch_add( 1 ) )
-            {
-                auto zone = brd->GetArea( areaId );
-
-                // NOTE: this could be refactored to do multiple layers from the same zone in
-                // parallel, but since the test case doesn't have any of these, I'm not bothering
-                // to do that right now.
-                for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
-                {
-                    SHAPE_POLY_SET poly = zone->GetFilledPolysList( layer );
-
-                    poly.CacheTriangulation();
-
-                    (void) poly;
-#if 0
-                PROF_COUNTER unfrac("unfrac");
-                poly.Unfracture( SHAPE_POLY_SET::PM_FAST );
-                unfrac.Show();
-
-                PROF_COUNTER triangulate("triangulate");
-
-                for(int i =0; i< poly.OutlineCount(); i++)
-                {
-                    poly.triangulatePoly( &poly.Polygon(i) );
-                }
-                triangulate.Show();
-#endif
-                }
-            }
-
-            threadsFinished++;
-        } );
+        auto zone = brd->GetArea( areaId );
 
-        t.detach();
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+            polys.push_back( zone->GetFilledPolysList( layer ) );
     }
 
-    while( threadsFinished < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    std::vector<SHAPE_POLY_SET*> toTriangulate;
+
+    for( SHAPE_POLY_SET& poly : polys )
+        toTriangulate.push_back( &poly );
+
+    // Triangulates in parallel across all the islands of all the zones
+    SHAPE_POLY_SET::CacheTriangulations( toTriangulate );
 
     cnt.Show();
 
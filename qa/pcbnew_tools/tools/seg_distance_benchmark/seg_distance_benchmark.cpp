@@ -0,0 +1,179 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2020 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <geometry/seg_distance_kernels.h>
+#include <geometry/shape_line_chain.h>
+#include <geometry/shape_poly_set.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+
+#include <qa_utils/utility_registry.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <profile.h>
+
+#include <iostream>
+
+
+/**
+ * Compares the batch segment distance kernels with a plain loop over SEG::SquaredDistance(),
+ * using the filled areas of the zones of a board as the line chains to measure against.
+ */
+
+enum SEG_DIST_BENCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    RESULTS_DIFFER,
+};
+
+
+/// Number of query points and segments per side of the grid laid over each chain
+static const int QUERY_GRID = 16;
+
+
+template <typename QUERY>
+static SEG::ecoord scalarDistance( const SHAPE_LINE_CHAIN& aChain, const QUERY& aQuery )
+{
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+
+    for( int ii = 0; ii < aChain.SegmentCount(); ++ii )
+        best = std::min( best, aChain.CSegment( ii ).SquaredDistance( aQuery ) );
+
+    return best;
+}
+
+
+template <typename QUERY>
+static SEG::ecoord kernelDistance( const SHAPE_LINE_CHAIN& aChain, const QUERY& aQuery )
+{
+    SEG::ecoord best = VECTOR2I::ECOORD_MAX;
+
+    SegKernelForEachCandidate( aQuery, aChain, best,
+            [&]( int aIndex ) -> bool
+            {
+                best = std::min( best, aChain.CSegment( aIndex ).SquaredDistance( aQuery ) );
+                return true;
+            } );
+
+    return best;
+}
+
+
+int seg_distance_benchmark_main( int argc, char* argv[] )
+{
+    std::string filename;
+
+    if( argc > 1 )
+        filename = argv[1];
+
+    auto brd = KI_TEST::ReadBoardFromFileOrStream( filename );
+
+    if( !brd )
+        return SEG_DIST_BENCH_RET_CODES::LOAD_FAILED;
+
+    std::vector<const SHAPE_LINE_CHAIN*> chains;
+
+    for( ZONE_CONTAINER* zone : brd->Zones() )
+    {
+        for( PCB_LAYER_ID layer : zone->GetLayerSet().Seq() )
+        {
+            const SHAPE_POLY_SET& fill = zone->GetFilledPolysList( layer );
+
+            for( int ii = 0; ii < fill.OutlineCount(); ++ii )
+                chains.push_back( &fill.COutline( ii ) );
+        }
+    }
+
+    std::vector<VECTOR2I> points;
+    std::vector<SEG>      segs;
+    std::vector<int>      owners;
+    size_t                segmentCount = 0;
+
+    for( size_t ii = 0; ii < chains.size(); ++ii )
+    {
+        BOX2I bbox = chains[ii]->BBox();
+        int   stepX = std::max( 1, bbox.GetWidth() / QUERY_GRID );
+        int   stepY = std::max( 1, bbox.GetHeight() / QUERY_GRID );
+
+        for( int xx = 0; xx < QUERY_GRID; ++xx )
+        {
+            for( int yy = 0; yy < QUERY_GRID; ++yy )
+            {
+                VECTOR2I p( bbox.GetX() + xx * stepX, bbox.GetY() + yy * stepY );
+
+                points.push_back( p );
+                segs.emplace_back( p, p + VECTOR2I( stepX / 2, stepY / 3 ) );
+                owners.push_back( ii );
+            }
+        }
+
+        segmentCount += chains[ii]->SegmentCount();
+    }
+
+    std::cout << chains.size() << " zone outlines, " << segmentCount << " segments, "
+              << points.size() << " queries" << std::endl;
+
+    std::vector<SEG::ecoord> scalarResults( points.size() * 2 );
+    std::vector<SEG::ecoord> kernelResults( points.size() * 2 );
+
+    PROF_COUNTER scalarTimer( "scalar" );
+
+    for( size_t ii = 0; ii < points.size(); ++ii )
+    {
+        scalarResults[2 * ii] = scalarDistance( *chains[owners[ii]], points[ii] );
+        scalarResults[2 * ii + 1] = scalarDistance( *chains[owners[ii]], segs[ii] );
+    }
+
+    scalarTimer.Stop();
+    scalarTimer.Show( std::cout );
+
+    PROF_COUNTER kernelTimer( "kernels" );
+
+    for( size_t ii = 0; ii < points.size(); ++ii )
+    {
+        kernelResults[2 * ii] = kernelDistance( *chains[owners[ii]], points[ii] );
+        kernelResults[2 * ii + 1] = kernelDistance( *chains[owners[ii]], segs[ii] );
+    }
+
+    kernelTimer.Stop();
+    kernelTimer.Show( std::cout );
+
+    if( kernelTimer.msecs() > 0.0 )
+        std::cout << "speedup: " << scalarTimer.msecs() / kernelTimer.msecs() << "x" << std::endl;
+
+    if( scalarResults != kernelResults )
+    {
+        std::cerr << "Kernel results differ from the scalar loop" << std::endl;
+        return SEG_DIST_BENCH_RET_CODES::RESULTS_DIFFER;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+static bool registered = UTILITY_REGISTRY::Register( {
+        "seg_distance_benchmark",
+        "Benchmark the batch segment distance kernels on the zone fills of a PCB",
+        seg_distance_benchmark_main,
+} );
@@ -57,7 +57,10 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
 #ifdef DEBUG
@@ -71,21 +74,125 @@
 //
 
 #define RTREE_TEMPLATE          template <class DATATYPE, class ELEMTYPE, int NUMDIMS, \
-    class ELEMTYPEREAL, int TMAXNODES, int TMINNODES>
+    class ELEMTYPEREAL, int TMAXNODES, int TMINNODES, template <class> class ALLOCATOR>
 #define RTREE_SEARCH_TEMPLATE   template <class DATATYPE, class ELEMTYPE, int NUMDIMS, \
-    class ELEMTYPEREAL, int TMAXNODES, int TMINNODES, class VISITOR>
+    class ELEMTYPEREAL, int TMAXNODES, int TMINNODES, template <class> class ALLOCATOR, \
+    class VISITOR>
 #define RTREE_QUAL              RTree<DATATYPE, ELEMTYPE, NUMDIMS, ELEMTYPEREAL, TMAXNODES, \
-    TMINNODES>
+    TMINNODES, ALLOCATOR>
 #define RTREE_SEARCH_QUAL       RTree<DATATYPE, ELEMTYPE, NUMDIMS, ELEMTYPEREAL, TMAXNODES, \
-    TMINNODES, VISITOR>
+    TMINNODES, ALLOCATOR, VISITOR>
 
-#define RTREE_DONT_USE_MEMPOOLS     // This version does not contain a fixed memory allocator, fill in lines with EXAMPLE to implement one.
 #define RTREE_USE_SPHERICAL_VOLUME  // Better split classification, may be slower on some systems
 
 // Fwd decl
 class RTFileStream;    // File I/O helper class, look below for implementation and notes.
 
 
+/// \class RTreeNodePool
+/// Default node allocator of RTree.  Nodes are carved out of slabs of growing size, so the
+/// nodes of a tree sit close together in memory, and freed nodes are kept for reuse.
+/// FreeAll() releases every node at once, which is how a tree is cleared.
+///
+/// An allocator provides Allocate(), Free() and FreeAll() for one node type, and sets
+/// FREES_ALL when FreeAll() releases the nodes still allocated.
+///
+template <class T>
+class RTreeNodePool
+{
+public:
+    static const bool FREES_ALL = true;
+
+    RTreeNodePool() :
+            m_freeList( nullptr ),
+            m_slabSize( 0 ),
+            m_nextInSlab( 0 )
+    {
+    }
+
+    RTreeNodePool( const RTreeNodePool& ) = delete;
+    RTreeNodePool& operator=( const RTreeNodePool& ) = delete;
+
+    T* Allocate()
+    {
+        Slot* slot = m_freeList;
+
+        if( slot )
+        {
+            m_freeList = slot->m_next;
+        }
+        else
+        {
+            if( m_nextInSlab == m_slabSize )
+            {
+                // Trees are often tiny (eg. one per layer), so start small and grow
+                m_slabSize = m_slabSize ? std::min<int>( 2 * m_slabSize, MAX_SLAB ) : MIN_SLAB;
+                m_slabs.emplace_back( new Slot[m_slabSize] );
+                m_nextInSlab = 0;
+            }
+
+            slot = &m_slabs.back()[m_nextInSlab++];
+        }
+
+        return new( &slot->m_storage ) T;
+    }
+
+    void Free( T* a_node )
+    {
+        a_node->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>( a_node );
+        slot->m_next = m_freeList;
+        m_freeList = slot;
+    }
+
+    void FreeAll()
+    {
+        m_slabs.clear();
+        m_freeList = nullptr;
+        m_slabSize = 0;
+        m_nextInSlab = 0;
+    }
+
+private:
+    // FreeAll() drops nodes without destroying them
+    static_assert( std::is_trivially_destructible<T>::value, "RTree nodes must be trivial" );
+
+    enum
+    {
+        MIN_SLAB = 4,
+        MAX_SLAB = 256
+    };
+
+    union Slot
+    {
+        Slot*                                                     m_next;
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type m_storage;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> m_slabs;
+    Slot*                                m_freeList;
+    int                                  m_slabSize;
+    int                                  m_nextInSlab;
+};
+
+
+/// \class RTreeHeapAllocator
+/// Node allocator of RTree using plain new and delete, for checking memory use with
+/// tools that track individual allocations.
+///
+template <class T>
+class RTreeHeapAllocator
+{
+public:
+    static const bool FREES_ALL = false;
+
+    T* Allocate() { return new T; }
+    void Free( T* a_node ) { delete a_node; }
+    void FreeAll() {}
+};
+
+
 /// \class RTree
 /// Implementation of RTree, a multidimensional bounding rectangle tree.
 /// Example usage: For a 3-dimensional tree use RTree<Object*, float, 3> myTree;
@@ -96,14 +203,15 @@ class RTFileStream;    // File I/O helper class, look below for implementation a
 /// ELEMTYPE Type of element such as int or float
 /// NUMDIMS Number of dimensions such as 2 or 3
 /// ELEMTYPEREAL Type of element that allows fractional and large values such as float or double, for use in volume calcs
+/// ALLOCATOR Allocator of the nodes, see RTreeNodePool
 ///
 /// NOTES: Inserting and removing data requires the knowledge of its constant Minimal Bounding Rectangle.
-///        This version uses new/delete for nodes, I recommend using a fixed size allocator for efficiency.
 ///        Instead of using a callback function for returned results, I recommend and efficient pre-sized, grow-only memory
 ///        array similar to MFC CArray or STL Vector for returning search query result.
 ///
 template <class DATATYPE, class ELEMTYPE, int NUMDIMS,
-          class ELEMTYPEREAL = ELEMTYPE, int TMAXNODES = 8, int TMINNODES = TMAXNODES / 2>
+          class ELEMTYPEREAL = ELEMTYPE, int TMAXNODES = 8, int TMINNODES = TMAXNODES / 2,
+          template <class> class ALLOCATOR = RTreeNodePool>
 class RTree
 {
 protected:
@@ -134,9 +242,16 @@ public:
         int totalItems;
     };
 
+    /// A data entry and its bounding rect, as handed to BulkLoad()
+    typedef std::pair<Rect, DATATYPE> BulkEntry;
+
 public:
 
     RTree();
+
+    /// Construct a tree holding the given entries, packed as by BulkLoad()
+    explicit RTree( std::vector<BulkEntry>& a_entries );
+
     virtual ~RTree();
 
     /// Insert entry
@@ -147,6 +262,12 @@ public:
                  const ELEMTYPE     a_max[NUMDIMS],
                  const DATATYPE&    a_dataId );
 
+    /// Replace the contents of the tree with the given entries, packed bottom-up with the
+    /// Sort-Tile-Recursive algorithm.  This is much faster than inserting the entries one at a
+    /// time, and the packed nodes overlap less so later searches are faster too.
+    /// \param a_entries Bounding rects and data of the entries.  They are reordered by the call.
+    void BulkLoad( std::vector<BulkEntry>& a_entries );
+
     /// Remove entry
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
@@ -548,6 +669,8 @@ protected:
     void            InitParVars( PartitionVars* a_parVars, int a_maxRects, int a_minFill ) const;
     void            PickSeeds( PartitionVars* a_parVars ) const;
     void            Classify( int a_index, int a_group, PartitionVars* a_parVars ) const;
+    void            TileRec( Branch* a_begin, Branch* a_end, int a_axis, int a_level,
+                             std::vector<Branch>& a_parents ) const;
     bool            RemoveRect( const Rect* a_rect, const DATATYPE& a_id, Node** a_root ) const;
     bool            RemoveRectRec( const Rect*      a_rect,
                                    const DATATYPE&  a_id,
@@ -610,6 +733,9 @@ protected:
 
     Node*           m_root;                         ///< Root of tree
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
+
+    mutable ALLOCATOR<Node>     m_nodeAllocator;
+    mutable ALLOCATOR<ListNode> m_listNodeAllocator;
 };
 
 
@@ -722,12 +848,104 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
 }
 
 
+RTREE_TEMPLATE
+RTREE_QUAL::RTree( std::vector<BulkEntry>& a_entries ) : RTree()
+{
+    BulkLoad( a_entries );
+}
+
+
 RTREE_TEMPLATE
 RTREE_QUAL::~RTree() {
     Reset(); // Free, or reset node memory
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( std::vector<BulkEntry>& a_entries )
+{
+    Reset();
+
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( size_t index = 0; index < a_entries.size(); ++index )
+    {
+        branches[index].m_rect = a_entries[index].first;
+        branches[index].m_data = a_entries[index].second;
+    }
+
+    // Pack each level into nodes, and the covers of those nodes into the next level up,
+    // until everything fits in the root
+    int level = 0;
+
+    while( (int) branches.size() > MAXNODES )
+    {
+        std::vector<Branch> parents;
+
+        parents.reserve( branches.size() / MAXNODES + NUMDIMS );
+        TileRec( branches.data(), branches.data() + branches.size(), 0, level, parents );
+        branches.swap( parents );
+        ++level;
+    }
+
+    m_root = AllocNode();
+    m_root->m_level = level;
+    m_root->m_count = (int) branches.size();
+    std::copy( branches.begin(), branches.end(), m_root->m_branch );
+}
+
+
+// Sort the branches by their centres along a_axis and split them into slabs, each of which
+// is tiled along the remaining axes.  Along the last axis the slabs are cut into nodes of
+// nearly equal size, whose covers are appended to a_parents.
+RTREE_TEMPLATE
+void RTREE_QUAL::TileRec( Branch* a_begin, Branch* a_end, int a_axis, int a_level,
+                          std::vector<Branch>& a_parents ) const
+{
+    const size_t count = a_end - a_begin;
+
+    std::sort( a_begin, a_end,
+               [a_axis]( const Branch& a, const Branch& b )
+               {
+                   // Sum in the real type: ELEMTYPE can overflow for trees spanning INT_MIN/MAX
+                   return (ELEMTYPEREAL) a.m_rect.m_min[a_axis] + a.m_rect.m_max[a_axis]
+                          < (ELEMTYPEREAL) b.m_rect.m_min[a_axis] + b.m_rect.m_max[a_axis];
+               } );
+
+    const size_t nodeCount = ( count + MAXNODES - 1 ) / MAXNODES;
+
+    if( a_axis == NUMDIMS - 1 )
+    {
+        for( size_t index = 0; index < nodeCount; ++index )
+        {
+            Branch* first = a_begin + count * index / nodeCount;
+            Branch* last = a_begin + count * ( index + 1 ) / nodeCount;
+            Node*   node = AllocNode();
+
+            node->m_level = a_level;
+            node->m_count = (int) ( last - first );
+            std::copy( first, last, node->m_branch );
+
+            Branch branch;
+            branch.m_rect  = NodeCover( node );
+            branch.m_child = node;
+            a_parents.push_back( branch );
+        }
+
+        return;
+    }
+
+    const size_t slabCount = std::min( nodeCount, (size_t) std::ceil(
+            std::pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_axis ) ) ) );
+
+    for( size_t index = 0; index < slabCount; ++index )
+    {
+        TileRec( a_begin + count * index / slabCount, a_begin + count * ( index + 1 ) / slabCount,
+                 a_axis + 1, a_level, a_parents );
+    }
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Insert( const ELEMTYPE     a_min[NUMDIMS],
                          const ELEMTYPE     a_max[NUMDIMS],
@@ -1127,13 +1345,17 @@ void RTREE_QUAL::RemoveAll()
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset() const
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    // Delete all existing nodes
-    RemoveAllRec( m_root );
-#else    // RTREE_DONT_USE_MEMPOOLS
-    // Just reset memory pools.  We are not using complex types
-    // EXAMPLE
-#endif    // RTREE_DONT_USE_MEMPOOLS
+    if( ALLOCATOR<Node>::FREES_ALL )
+    {
+        // Just reset memory pools.  We are not using complex types
+        m_nodeAllocator.FreeAll();
+        m_listNodeAllocator.FreeAll();
+    }
+    else
+    {
+        // Delete all existing nodes
+        RemoveAllRec( m_root );
+    }
 }
 
 
@@ -1158,13 +1380,8 @@ void RTREE_QUAL::RemoveAllRec( Node* a_node ) const
 RTREE_TEMPLATE
 typename RTREE_QUAL::Node* RTREE_QUAL::AllocNode() const
 {
-    Node* newNode;
+    Node* newNode = m_nodeAllocator.Allocate();
 
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    newNode = new Node;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
     InitNode( newNode );
     return newNode;
 }
@@ -1175,11 +1392,7 @@ void RTREE_QUAL::FreeNode( Node* a_node ) const
 {
     ASSERT( a_node );
 
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    delete a_node;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
+    m_nodeAllocator.Free( a_node );
 }
 
 
@@ -1188,22 +1401,14 @@ void RTREE_QUAL::FreeNode( Node* a_node ) const
 RTREE_TEMPLATE
 typename RTREE_QUAL::ListNode* RTREE_QUAL::AllocListNode() const
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    return new ListNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
+    return m_listNodeAllocator.Allocate();
 }
 
 
 RTREE_TEMPLATE
 void RTREE_QUAL::FreeListNode( ListNode* a_listNode ) const
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
-    delete a_listNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
+    m_listNodeAllocator.Free( a_listNode );
 }
 
 